@@ -0,0 +1,139 @@
+#include "list_arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// every allocation is rounded up to this alignment (enough for pointers,
+// sizes and doubles on the 32- and 64-bit targets)
+#define LIST_ARENA_ALIGN 16
+
+// the usable size of a regular block; larger requests get a block of their own
+#define LIST_ARENA_BLOCK_SIZE (64 * 1024)
+
+struct ListArenaBlock
+{
+    // the next (older) block in the chain
+    struct ListArenaBlock *next;
+    // bytes of data in use
+    size_t used;
+    // bytes of data available
+    size_t capacity;
+    // the block's storage, aligned by the union below
+    union
+    {
+        long double align_float;
+        long long align_int;
+        void *align_pointer;
+        unsigned char bytes[1];
+    } data;
+};
+
+void ListArena_Init(struct ListArena *arena)
+{
+    arena->head = NULL;
+    arena->used = 0;
+    arena->reserved = 0;
+}
+
+// block_new allocates a block with room for capacity bytes.
+static struct ListArenaBlock *block_new(size_t capacity)
+{
+    struct ListArenaBlock *block = malloc(offsetof(struct ListArenaBlock, data) + capacity);
+    if (block == NULL)
+        return NULL;
+    block->next = NULL;
+    block->used = 0;
+    block->capacity = capacity;
+    return block;
+}
+
+void *ListArena_Alloc(struct ListArena *arena, size_t size)
+{
+    size_t rounded = (size + LIST_ARENA_ALIGN - 1) & ~(size_t)(LIST_ARENA_ALIGN - 1);
+    if (rounded == 0)
+        rounded = LIST_ARENA_ALIGN;
+
+    struct ListArenaBlock *block = arena->head;
+    if (block == NULL || block->capacity - block->used < rounded)
+    {
+        if (rounded > LIST_ARENA_BLOCK_SIZE / 4)
+        {
+            // an oversized request gets a dedicated block behind the head, so
+            // the head keeps serving small allocations from its free space
+            struct ListArenaBlock *large = block_new(rounded);
+            if (large == NULL)
+                return NULL;
+            if (block != NULL)
+            {
+                large->next = block->next;
+                block->next = large;
+            }
+            else
+            {
+                arena->head = large;
+            }
+            large->used = rounded;
+            arena->used += rounded;
+            arena->reserved += rounded;
+            return large->data.bytes;
+        }
+
+        block = block_new(LIST_ARENA_BLOCK_SIZE);
+        if (block == NULL)
+            return NULL;
+        block->next = arena->head;
+        arena->head = block;
+        arena->reserved += LIST_ARENA_BLOCK_SIZE;
+    }
+
+    void *p = block->data.bytes + block->used;
+    block->used += rounded;
+    arena->used += rounded;
+    return p;
+}
+
+char *ListArena_Strdup(struct ListArena *arena, const char *s)
+{
+    size_t len = strlen(s);
+    char *copy = ListArena_Alloc(arena, len + 1);
+    if (copy == NULL)
+        return NULL;
+    memcpy(copy, s, len + 1);
+    return copy;
+}
+
+void ListArena_Adopt(struct ListArena *arena, struct ListArena *src)
+{
+    if (src->head == NULL)
+        return;
+
+    // src's blocks go behind arena's head, so the head keeps serving small
+    // allocations from its free space
+    if (arena->head == NULL)
+    {
+        arena->head = src->head;
+    }
+    else
+    {
+        struct ListArenaBlock *tail = src->head;
+        while (tail->next != NULL)
+            tail = tail->next;
+        tail->next = arena->head->next;
+        arena->head->next = src->head;
+    }
+    arena->used += src->used;
+    arena->reserved += src->reserved;
+    ListArena_Init(src);
+}
+
+void ListArena_Free(struct ListArena *arena)
+{
+    struct ListArenaBlock *block = arena->head;
+    while (block != NULL)
+    {
+        struct ListArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    ListArena_Init(arena);
+}
@@ -0,0 +1,49 @@
+#ifndef LIST_ARENA_H
+#define LIST_ARENA_H
+
+#include <stddef.h>
+
+// list_arena provides the bump allocator that owns a list's per-item data:
+// item names, option arrays and strings, and image variants. Allocations are
+// carved sequentially out of large blocks, so building a list costs a handful
+// of mallocs instead of several per item, related data stays contiguous, and
+// the whole list is released at once by freeing the blocks. Individual
+// allocations are never freed. Keeping it display-free means it can be unit
+// tested with the host compiler (see tests/list_arena_test.c).
+
+struct ListArenaBlock;
+
+// ListArena owns a chain of blocks. Zero-initialize it or call ListArena_Init
+// before first use.
+struct ListArena
+{
+    // the block currently being carved; older blocks hang off its next pointer
+    struct ListArenaBlock *head;
+    // total bytes handed out, for memory reporting
+    size_t used;
+    // total bytes reserved in blocks, for memory reporting
+    size_t reserved;
+};
+
+// ListArena_Init prepares an empty arena. No memory is reserved until the
+// first allocation.
+void ListArena_Init(struct ListArena *arena);
+
+// ListArena_Alloc returns size bytes aligned for any of the list's data types,
+// or NULL when memory is exhausted. A zero size returns a valid, unique pointer.
+void *ListArena_Alloc(struct ListArena *arena, size_t size);
+
+// ListArena_Strdup copies a NUL-terminated string into the arena. Returns NULL
+// when memory is exhausted.
+char *ListArena_Strdup(struct ListArena *arena, const char *s);
+
+// ListArena_Adopt moves every block of src into arena, leaving src empty.
+// Pointers carved from src stay valid and are now released with arena. Used to
+// fold arenas filled on worker threads back into the list's arena.
+void ListArena_Adopt(struct ListArena *arena, struct ListArena *src);
+
+// ListArena_Free releases every block at once and leaves the arena empty and
+// reusable. Pointers previously returned by the arena become invalid.
+void ListArena_Free(struct ListArena *arena);
+
+#endif // LIST_ARENA_H
@@ -0,0 +1,256 @@
+#include "list_cache.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// identifies a minui-list cache file
+static const char list_cache_magic[8] = {'M', 'L', 'I', 'S', 'T', 'C', 'A', 'C'};
+
+// the length written for an absent (NULL) string
+#define LIST_CACHE_ABSENT UINT32_MAX
+
+// ListCacheHeader starts every cache file. All fields are naturally aligned,
+// so the struct has no padding and is written and read as a whole.
+struct ListCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    struct ListCacheKey key;
+    uint64_t payload_size;
+};
+
+uint64_t ListCache_Hash(const void *data, size_t size, uint64_t hash)
+{
+    const unsigned char *p = data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t ListCache_HashString(const char *s, uint64_t hash)
+{
+    if (s == NULL)
+        s = "";
+    return ListCache_Hash(s, strlen(s) + 1, hash);
+}
+
+bool ListCache_Path(char *out, size_t out_size, const char *cache_dir, const char *source_path)
+{
+    char resolved[PATH_MAX];
+    if (realpath(source_path, resolved) == NULL)
+        return false;
+
+    uint64_t hash = ListCache_HashString(resolved, LIST_CACHE_HASH_SEED);
+    int written = snprintf(out, out_size, "%s/%016llx.cache", cache_dir, (unsigned long long)hash);
+    return written > 0 && (size_t)written < out_size;
+}
+
+void ListCache_KeyFromSource(struct ListCacheKey *key, const struct stat *st, const char *data, size_t size)
+{
+    key->source_size = (uint64_t)st->st_size;
+#ifdef __APPLE__
+    key->source_mtime_sec = (int64_t)st->st_mtimespec.tv_sec;
+    key->source_mtime_nsec = (int64_t)st->st_mtimespec.tv_nsec;
+#else
+    key->source_mtime_sec = (int64_t)st->st_mtim.tv_sec;
+    key->source_mtime_nsec = (int64_t)st->st_mtim.tv_nsec;
+#endif
+    key->content_hash = ListCache_Hash(data, size, LIST_CACHE_HASH_SEED);
+}
+
+static bool key_equal(const struct ListCacheKey *a, const struct ListCacheKey *b)
+{
+    return a->source_size == b->source_size &&
+           a->source_mtime_sec == b->source_mtime_sec &&
+           a->source_mtime_nsec == b->source_mtime_nsec &&
+           a->content_hash == b->content_hash &&
+           a->settings_hash == b->settings_hash;
+}
+
+bool ListCache_Open(struct ListInput *input, const char *path, const struct ListCacheKey *key, struct ListCacheReader *reader)
+{
+    if (!ListInput_OpenFile(input, path))
+        return false;
+
+    struct ListCacheHeader header;
+    bool valid = input->size >= sizeof(header);
+    if (valid)
+    {
+        memcpy(&header, input->data, sizeof(header));
+        valid = memcmp(header.magic, list_cache_magic, sizeof(header.magic)) == 0 &&
+                header.version == LIST_CACHE_VERSION &&
+                header.payload_size == input->size - sizeof(header) &&
+                key_equal(&header.key, key);
+    }
+    if (!valid)
+    {
+        ListInput_Close(input);
+        return false;
+    }
+
+    reader->p = input->data + sizeof(header);
+    reader->end = input->data + input->size;
+    reader->failed = false;
+    return true;
+}
+
+void ListCacheWriter_Init(struct ListCacheWriter *writer)
+{
+    writer->data = NULL;
+    writer->size = 0;
+    writer->capacity = 0;
+    writer->failed = false;
+}
+
+// put appends size bytes, growing the buffer geometrically.
+static void put(struct ListCacheWriter *writer, const void *data, size_t size)
+{
+    if (writer->failed)
+        return;
+
+    if (writer->capacity - writer->size < size)
+    {
+        size_t capacity = writer->capacity > 0 ? writer->capacity : 4096;
+        while (capacity - writer->size < size)
+            capacity *= 2;
+        char *grown = realloc(writer->data, capacity);
+        if (grown == NULL)
+        {
+            writer->failed = true;
+            return;
+        }
+        writer->data = grown;
+        writer->capacity = capacity;
+    }
+
+    memcpy(writer->data + writer->size, data, size);
+    writer->size += size;
+}
+
+void ListCacheWriter_PutU8(struct ListCacheWriter *writer, uint8_t value)
+{
+    put(writer, &value, sizeof(value));
+}
+
+void ListCacheWriter_PutU32(struct ListCacheWriter *writer, uint32_t value)
+{
+    put(writer, &value, sizeof(value));
+}
+
+void ListCacheWriter_PutString(struct ListCacheWriter *writer, const char *s)
+{
+    if (s == NULL)
+    {
+        ListCacheWriter_PutU32(writer, LIST_CACHE_ABSENT);
+        return;
+    }
+
+    size_t length = strlen(s);
+    if (length >= LIST_CACHE_ABSENT)
+    {
+        writer->failed = true;
+        return;
+    }
+    ListCacheWriter_PutU32(writer, (uint32_t)length);
+    put(writer, s, length + 1);
+}
+
+bool ListCacheWriter_Commit(struct ListCacheWriter *writer, const char *path, const struct ListCacheKey *key)
+{
+    if (writer->failed)
+        return false;
+
+    char temp_path[PATH_MAX];
+    int written = snprintf(temp_path, sizeof(temp_path), "%s.%ld.tmp", path, (long)getpid());
+    if (written <= 0 || (size_t)written >= sizeof(temp_path))
+        return false;
+
+    struct ListCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, list_cache_magic, sizeof(header.magic));
+    header.version = LIST_CACHE_VERSION;
+    header.key = *key;
+    header.payload_size = writer->size;
+
+    FILE *file = fopen(temp_path, "wb");
+    if (file == NULL)
+        return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (writer->size == 0 || fwrite(writer->data, writer->size, 1, file) == 1);
+    ok = fclose(file) == 0 && ok;
+    if (ok)
+        ok = rename(temp_path, path) == 0;
+    if (!ok)
+        unlink(temp_path);
+    return ok;
+}
+
+void ListCacheWriter_Free(struct ListCacheWriter *writer)
+{
+    free(writer->data);
+    ListCacheWriter_Init(writer);
+}
+
+// get copies size bytes out of the payload, or fails the reader.
+static bool get(struct ListCacheReader *reader, void *out, size_t size)
+{
+    if (reader->failed || (size_t)(reader->end - reader->p) < size)
+    {
+        reader->failed = true;
+        memset(out, 0, size);
+        return false;
+    }
+    memcpy(out, reader->p, size);
+    reader->p += size;
+    return true;
+}
+
+uint8_t ListCacheReader_GetU8(struct ListCacheReader *reader)
+{
+    uint8_t value;
+    get(reader, &value, sizeof(value));
+    return value;
+}
+
+uint32_t ListCacheReader_GetU32(struct ListCacheReader *reader)
+{
+    uint32_t value;
+    get(reader, &value, sizeof(value));
+    return value;
+}
+
+uint32_t ListCacheReader_GetCount(struct ListCacheReader *reader)
+{
+    uint32_t count = ListCacheReader_GetU32(reader);
+    if (count > (size_t)(reader->end - reader->p))
+    {
+        reader->failed = true;
+        return 0;
+    }
+    return count;
+}
+
+const char *ListCacheReader_GetString(struct ListCacheReader *reader)
+{
+    uint32_t length = ListCacheReader_GetU32(reader);
+    if (reader->failed || length == LIST_CACHE_ABSENT)
+        return NULL;
+
+    if ((size_t)(reader->end - reader->p) <= length || reader->p[length] != '\0')
+    {
+        reader->failed = true;
+        return NULL;
+    }
+
+    const char *s = reader->p;
+    reader->p += (size_t)length + 1;
+    return s;
+}
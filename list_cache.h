@@ -0,0 +1,114 @@
+#ifndef LIST_CACHE_H
+#define LIST_CACHE_H
+
+#include "list_input.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+// list_cache provides the on-disk container behind --cache-dir: a small header
+// that identifies the source list, followed by a payload of fixed-width
+// integers and NUL-terminated strings. A cache file is read back by mapping it
+// (see list_input), so strings are used in place rather than copied. The
+// payload layout itself belongs to the caller; this module only frames,
+// validates, writes and bounds-checks it. Keeping it display-free means it can
+// be unit tested with the host compiler (see tests/list_cache_test.c).
+
+// LIST_CACHE_VERSION is stored in every cache file. Bump it whenever the header
+// or the payload layout written by minui-list.c changes, so stale caches are
+// rebuilt instead of misread.
+#define LIST_CACHE_VERSION 3
+
+// LIST_CACHE_HASH_SEED starts a ListCache_Hash chain.
+#define LIST_CACHE_HASH_SEED 14695981039346656037ULL
+
+// ListCacheKey identifies the list a cache was built from. A cache is only used
+// when every field matches the current source.
+struct ListCacheKey
+{
+    // the size of the source file in bytes
+    uint64_t source_size;
+    // the source file's modification time
+    int64_t source_mtime_sec;
+    int64_t source_mtime_nsec;
+    // ListCache_Hash of the source file's contents
+    uint64_t content_hash;
+    // ListCache_Hash of the options that shape the built list (item key,
+    // defaults), so changing a flag rebuilds the cache
+    uint64_t settings_hash;
+};
+
+// ListCacheWriter accumulates a payload in memory.
+struct ListCacheWriter
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+    // set when an allocation failed; the payload is then incomplete
+    bool failed;
+};
+
+// ListCacheReader walks a payload. Every getter bounds-checks; once a read runs
+// past the end or finds a malformed string, failed is set and every later read
+// returns zero or NULL.
+struct ListCacheReader
+{
+    const char *p;
+    const char *end;
+    bool failed;
+};
+
+// ListCache_Hash extends hash (LIST_CACHE_HASH_SEED to start) with size bytes
+// of data (64-bit FNV-1a).
+uint64_t ListCache_Hash(const void *data, size_t size, uint64_t hash);
+
+// ListCache_HashString extends hash with s including its terminator, so
+// chained strings hash differently from their concatenation. NULL hashes as
+// the empty string.
+uint64_t ListCache_HashString(const char *s, uint64_t hash);
+
+// ListCache_Path writes the cache file path for source_path into out:
+// <cache_dir>/<hash of the canonical source path>.cache. Returns false when the
+// source cannot be resolved or the path does not fit.
+bool ListCache_Path(char *out, size_t out_size, const char *cache_dir, const char *source_path);
+
+// ListCache_KeyFromSource fills the size, mtime and content hash fields of key
+// from a source file's stat data and loaded contents. settings_hash is left for
+// the caller.
+void ListCache_KeyFromSource(struct ListCacheKey *key, const struct stat *st, const char *data, size_t size);
+
+// ListCache_Open maps the cache file at path into input and, when its version
+// and key match, positions reader at the start of its payload and returns
+// true. On a missing, stale or malformed cache it returns false with input
+// closed.
+bool ListCache_Open(struct ListInput *input, const char *path, const struct ListCacheKey *key, struct ListCacheReader *reader);
+
+void ListCacheWriter_Init(struct ListCacheWriter *writer);
+void ListCacheWriter_PutU8(struct ListCacheWriter *writer, uint8_t value);
+void ListCacheWriter_PutU32(struct ListCacheWriter *writer, uint32_t value);
+// ListCacheWriter_PutString appends s with its terminator; NULL is recorded as
+// absent and read back as NULL.
+void ListCacheWriter_PutString(struct ListCacheWriter *writer, const char *s);
+
+// ListCacheWriter_Commit writes the header for key and the payload to path.
+// The file is written under a temporary name and renamed into place, so a
+// reader never maps a partial cache. Returns false if the payload is
+// incomplete or the file cannot be written.
+bool ListCacheWriter_Commit(struct ListCacheWriter *writer, const char *path, const struct ListCacheKey *key);
+
+// ListCacheWriter_Free releases the payload buffer.
+void ListCacheWriter_Free(struct ListCacheWriter *writer);
+
+uint8_t ListCacheReader_GetU8(struct ListCacheReader *reader);
+uint32_t ListCacheReader_GetU32(struct ListCacheReader *reader);
+// ListCacheReader_GetCount reads an element count and fails it when the rest
+// of the payload could not possibly hold that many elements, so a corrupt
+// count never drives a huge allocation.
+uint32_t ListCacheReader_GetCount(struct ListCacheReader *reader);
+// ListCacheReader_GetString returns a pointer to a string inside the payload,
+// or NULL for an absent string (or on failure; check reader->failed).
+const char *ListCacheReader_GetString(struct ListCacheReader *reader);
+
+#endif // LIST_CACHE_H
@@ -0,0 +1,122 @@
+#include "list_columns.h"
+
+#include <string.h>
+
+// the spelling of each key, in enum ListColumnKey order
+static const char *const key_names[] = {
+    [LIST_COLUMN_ALIGNMENT] = "alignment",
+    [LIST_COLUMN_BACKGROUND_COLOR] = "background_color",
+    [LIST_COLUMN_BACKGROUND_IMAGE] = "background_image",
+    [LIST_COLUMN_CAN_DISABLE] = "can_disable",
+    [LIST_COLUMN_CONFIRM_TEXT] = "confirm_text",
+    [LIST_COLUMN_DISABLED] = "disabled",
+    [LIST_COLUMN_DISPLAY_ON_FILTER] = "display_on_filter",
+    [LIST_COLUMN_DRAW_ARROWS] = "draw_arrows",
+    [LIST_COLUMN_HIDE_ACTION] = "hide_action",
+    [LIST_COLUMN_HIDE_CANCEL] = "hide_cancel",
+    [LIST_COLUMN_HIDE_CONFIRM] = "hide_confirm",
+    [LIST_COLUMN_IMAGE] = "image",
+    [LIST_COLUMN_IS_HEADER] = "is_header",
+    [LIST_COLUMN_SHOW_CONFIRM] = "show_confirm",
+    [LIST_COLUMN_UNSELECTABLE] = "unselectable",
+};
+
+bool ListColumns_KeyIsBoolean(enum ListColumnKey key)
+{
+    switch (key)
+    {
+    case LIST_COLUMN_ALIGNMENT:
+    case LIST_COLUMN_BACKGROUND_COLOR:
+    case LIST_COLUMN_BACKGROUND_IMAGE:
+    case LIST_COLUMN_CONFIRM_TEXT:
+    case LIST_COLUMN_IMAGE:
+        return false;
+    default:
+        return true;
+    }
+}
+
+// span_equals reports whether the length bytes at p spell text exactly.
+static bool span_equals(const char *p, size_t length, const char *text)
+{
+    return strlen(text) == length && memcmp(p, text, length) == 0;
+}
+
+// lookup_key finds the key spelled by the length bytes at p.
+static bool lookup_key(const char *p, size_t length, enum ListColumnKey *key)
+{
+    for (size_t i = 0; i < sizeof(key_names) / sizeof(key_names[0]); i++)
+    {
+        if (span_equals(p, length, key_names[i]))
+        {
+            *key = (enum ListColumnKey)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// value_valid reports whether the length bytes at p are an acceptable value
+// for key.
+static bool value_valid(enum ListColumnKey key, const char *p, size_t length)
+{
+    if (ListColumns_KeyIsBoolean(key))
+        return span_equals(p, length, "true") || span_equals(p, length, "false");
+    if (key == LIST_COLUMN_ALIGNMENT)
+        return span_equals(p, length, "left") || span_equals(p, length, "center") || span_equals(p, length, "right");
+    return length > 0;
+}
+
+void ListColumns_Parse(char *line, struct ListColumnsLine *parsed)
+{
+    parsed->name = line;
+    parsed->count = 0;
+
+    char *tab = strchr(line, '\t');
+    if (tab == NULL)
+        return;
+
+    // check every column before touching the line, so a line that is not a
+    // feature line stays exactly as it was read
+    char *tabs[LIST_COLUMNS_MAX];
+    char *carriage_return = NULL;
+    size_t count = 0;
+    for (char *column = tab + 1;; column++)
+    {
+        char *next = strchr(column, '\t');
+        size_t length = next != NULL ? (size_t)(next - column) : strlen(column);
+        // a CRLF line ending is not part of the last value
+        if (next == NULL && length > 0 && column[length - 1] == '\r')
+        {
+            carriage_return = column + length - 1;
+            length--;
+        }
+        char *equals = memchr(column, '=', length);
+        if (equals == NULL || count == LIST_COLUMNS_MAX)
+            return;
+        tabs[count] = column - 1;
+
+        enum ListColumnKey key;
+        char *value = equals + 1;
+        if (!lookup_key(column, equals - column, &key) || !value_valid(key, value, column + length - value))
+            return;
+
+        parsed->columns[count].key = key;
+        parsed->columns[count].value = value;
+        count++;
+
+        if (next == NULL)
+            break;
+        column = next;
+    }
+
+    // every column is valid: terminate the name, keys and values in place
+    for (size_t i = 0; i < count; i++)
+    {
+        *tabs[i] = '\0';
+        parsed->columns[i].value[-1] = '\0';
+    }
+    if (carriage_return != NULL)
+        *carriage_return = '\0';
+    parsed->count = count;
+}
@@ -0,0 +1,69 @@
+#ifndef LIST_COLUMNS_H
+#define LIST_COLUMNS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_columns parses the optional feature columns of text-format lines. A line
+// is the item name, optionally followed by tab-separated key=value columns:
+//
+//     Settings<TAB>is_header=true
+//     Wi-Fi<TAB>disabled=true<TAB>image=/mnt/SDCARD/Icons/wifi.png
+//
+// The columns are split in place in the same pass that finds the line, so the
+// name and values point straight into the input buffer. A line only counts as
+// having columns when every column after the name is a known key with a valid
+// value; anything else is left untouched and the whole line stays the name, so
+// existing lists that happen to contain tabs read as before. Keeping it
+// display-free means it can be unit tested with the host compiler (see
+// tests/list_columns_test.c).
+
+// the most feature columns one line can carry
+#define LIST_COLUMNS_MAX 16
+
+// ListColumnKey names a feature a column can set. Boolean keys take true|false.
+enum ListColumnKey
+{
+    LIST_COLUMN_ALIGNMENT,
+    LIST_COLUMN_BACKGROUND_COLOR,
+    LIST_COLUMN_BACKGROUND_IMAGE,
+    LIST_COLUMN_CAN_DISABLE,
+    LIST_COLUMN_CONFIRM_TEXT,
+    LIST_COLUMN_DISABLED,
+    LIST_COLUMN_DISPLAY_ON_FILTER,
+    LIST_COLUMN_DRAW_ARROWS,
+    LIST_COLUMN_HIDE_ACTION,
+    LIST_COLUMN_HIDE_CANCEL,
+    LIST_COLUMN_HIDE_CONFIRM,
+    LIST_COLUMN_IMAGE,
+    LIST_COLUMN_IS_HEADER,
+    LIST_COLUMN_SHOW_CONFIRM,
+    LIST_COLUMN_UNSELECTABLE,
+};
+
+struct ListColumn
+{
+    enum ListColumnKey key;
+    // the column's value, NUL-terminated in place
+    char *value;
+};
+
+// ListColumnsLine is one parsed line.
+struct ListColumnsLine
+{
+    // the item name: the line itself, or its first column
+    char *name;
+    struct ListColumn columns[LIST_COLUMNS_MAX];
+    size_t count;
+};
+
+// ListColumns_KeyIsBoolean reports whether key takes true|false.
+bool ListColumns_KeyIsBoolean(enum ListColumnKey key);
+
+// ListColumns_Parse parses the NUL-terminated line into parsed. When the line
+// carries valid feature columns, the tabs and each column's '=' are replaced
+// with NULs so the name and values can be used in place; otherwise the line
+// is not modified and parsed->count is 0.
+void ListColumns_Parse(char *line, struct ListColumnsLine *parsed);
+
+#endif // LIST_COLUMNS_H
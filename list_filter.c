@@ -1,12 +1,258 @@
 #include "list_filter.h"
 
-#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
-// ci_char returns the lowercased form of a byte for case-insensitive matching.
-static int ci_char(char c)
+// The key scan below looks at 16 candidate offsets at a time with NEON on the
+// device and SSE2 on x86 hosts. Building with -DLIST_FILTER_NO_SIMD (or for
+// any other target) falls back to a memchr loop, which `make test` also
+// covers.
+#if !defined(LIST_FILTER_NO_SIMD) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LIST_FILTER_NEON 1
+#elif !defined(LIST_FILTER_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define LIST_FILTER_SSE2 1
+#endif
+
+// fold_codepoint returns the lowercase form of c when it encodes to as many
+// UTF-8 bytes as c itself, and c otherwise.
+static uint32_t fold_codepoint(uint32_t c)
+{
+    // Latin-1 Supplement, and the micro sign, which folds to Greek mu
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7)
+        return c + 0x20;
+    if (c == 0xB5)
+        return 0x3BC;
+
+    // Latin Extended-A pairs each capital with the small letter after it.
+    // Dotted I, dotless i, kra, n preceded by apostrophe and long s have no
+    // two-byte counterpart.
+    if (c >= 0x100 && c <= 0x17F)
+    {
+        if (c == 0x130 || c == 0x131 || c == 0x138 || c == 0x149 || c == 0x17F)
+            return c;
+        if (c == 0x178)
+            return 0xFF;
+        if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E))
+            return (c & 1) ? c + 1 : c;
+        return (c & 1) ? c : c + 1;
+    }
+
+    // Greek
+    if (c == 0x386)
+        return 0x3AC;
+    if (c >= 0x388 && c <= 0x38A)
+        return c + 0x25;
+    if (c == 0x38C)
+        return 0x3CC;
+    if (c == 0x38E || c == 0x38F)
+        return c + 0x3F;
+    if (c >= 0x391 && c <= 0x3AB && c != 0x3A2)
+        return c + 0x20;
+    if (c == 0x3C2)
+        return 0x3C3;
+
+    // Cyrillic
+    if (c >= 0x400 && c <= 0x40F)
+        return c + 0x50;
+    if (c >= 0x410 && c <= 0x42F)
+        return c + 0x20;
+    if ((c >= 0x460 && c <= 0x481) || (c >= 0x48A && c <= 0x4BF) || (c >= 0x4D0 && c <= 0x52F))
+        return (c & 1) ? c : c + 1;
+    if (c == 0x4C0)
+        return 0x4CF;
+    if (c >= 0x4C1 && c <= 0x4CE)
+        return (c & 1) ? c + 1 : c;
+
+    // Armenian
+    if (c >= 0x531 && c <= 0x556)
+        return c + 0x30;
+
+    // Latin Extended Additional (Vietnamese and others); capital sharp s
+    // folds to the two-byte small sharp s, so it is left alone
+    if ((c >= 0x1E00 && c <= 0x1E95) || (c >= 0x1EA0 && c <= 0x1EFF))
+        return (c & 1) ? c : c + 1;
+
+    // fullwidth Latin capitals
+    if (c >= 0xFF21 && c <= 0xFF3A)
+        return c + 0x20;
+
+    return c;
+}
+
+// fold_text folds the length bytes at src into dst as ListFilter_Fold does
+// and reports whether any byte changed. With a NULL dst nothing is written
+// and it stops at the first change.
+static bool fold_text(char *dst, const char *src, size_t length)
+{
+    const unsigned char *s = (const unsigned char *)src;
+    unsigned char *d = (unsigned char *)dst;
+    bool changed = false;
+    size_t i = 0;
+    while (i < length)
+    {
+        unsigned char b = s[i];
+        if (b < 0x80)
+        {
+            unsigned char folded = (b >= 'A' && b <= 'Z') ? b + 0x20 : b;
+            if (folded != b)
+            {
+                if (d == NULL)
+                    return true;
+                changed = true;
+            }
+            if (d != NULL)
+                d[i] = folded;
+            i++;
+            continue;
+        }
+
+        // decode a well-formed two- or three-byte sequence; anything else is
+        // copied a byte at a time
+        uint32_t c = 0;
+        size_t n = 0;
+        if (b >= 0xC2 && b <= 0xDF && i + 1 < length && (s[i + 1] & 0xC0) == 0x80)
+        {
+            c = ((uint32_t)(b & 0x1F) << 6) | (s[i + 1] & 0x3F);
+            n = 2;
+        }
+        else if (b >= 0xE0 && b <= 0xEF && i + 2 < length && (s[i + 1] & 0xC0) == 0x80 && (s[i + 2] & 0xC0) == 0x80)
+        {
+            c = ((uint32_t)(b & 0x0F) << 12) | ((uint32_t)(s[i + 1] & 0x3F) << 6) | (s[i + 2] & 0x3F);
+            if (c >= 0x800 && (c < 0xD800 || c > 0xDFFF))
+                n = 3;
+        }
+
+        uint32_t folded = n > 0 ? fold_codepoint(c) : c;
+        if (n == 0 || folded == c)
+        {
+            size_t run = n > 0 ? n : 1;
+            if (d != NULL)
+                memcpy(d + i, s + i, run);
+            i += run;
+            continue;
+        }
+
+        if (d == NULL)
+            return true;
+        changed = true;
+        if (n == 2)
+        {
+            d[i] = 0xC0 | (folded >> 6);
+            d[i + 1] = 0x80 | (folded & 0x3F);
+        }
+        else
+        {
+            d[i] = 0xE0 | (folded >> 12);
+            d[i + 1] = 0x80 | ((folded >> 6) & 0x3F);
+            d[i + 2] = 0x80 | (folded & 0x3F);
+        }
+        i += n;
+    }
+    return changed;
+}
+
+void ListFilter_Fold(char *dst, const char *src, size_t length)
+{
+    fold_text(dst, src, length);
+}
+
+bool ListFilter_IsFolded(const char *text, size_t length)
+{
+    return !fold_text(NULL, text, length);
+}
+
+void ListFilter_Prepare(struct ListFilterQuery *query, const char *filter)
 {
-    return tolower((unsigned char)c);
+    size_t length = filter != NULL ? strlen(filter) : 0;
+    if (length > sizeof(query->text) - 1)
+    {
+        // cut at a character boundary
+        length = sizeof(query->text) - 1;
+        while (length > 0 && ((unsigned char)filter[length] & 0xC0) == 0x80)
+            length--;
+    }
+    ListFilter_Fold(query->text, filter, length);
+    query->text[length] = '\0';
+    query->length = length;
+}
+
+bool ListFilter_MatchKey(const char *key, size_t key_length, const struct ListFilterQuery *query, size_t *match_start)
+{
+    if (match_start != NULL)
+        *match_start = 0;
+
+    size_t n = query->length;
+    if (n == 0)
+        return true;
+    if (n > key_length)
+        return false;
+
+    const char *needle = query->text;
+    // the last offset the filter fits at
+    size_t last = key_length - n;
+    size_t i = 0;
+
+    // compare 16 offsets at once against the filter's first and last bytes,
+    // verifying only the offsets where both line up. A block is only loaded
+    // while its offsets all fit, so the loads stay inside the key.
+#if defined(LIST_FILTER_NEON)
+    const uint8x16_t first = vdupq_n_u8((uint8_t)needle[0]);
+    const uint8x16_t final = vdupq_n_u8((uint8_t)needle[n - 1]);
+    for (; i + 16 <= last + 1; i += 16)
+    {
+        uint8x16_t at_first = vceqq_u8(vld1q_u8((const uint8_t *)key + i), first);
+        uint8x16_t at_final = vceqq_u8(vld1q_u8((const uint8_t *)key + i + n - 1), final);
+        // narrow each byte to a nibble, keeping one bit per offset
+        uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vandq_u8(at_first, at_final)), 4)), 0);
+        for (bits &= 0x1111111111111111ULL; bits != 0; bits &= bits - 1)
+        {
+            size_t candidate = i + (__builtin_ctzll(bits) >> 2);
+            if (memcmp(key + candidate, needle, n) == 0)
+            {
+                if (match_start != NULL)
+                    *match_start = candidate;
+                return true;
+            }
+        }
+    }
+#elif defined(LIST_FILTER_SSE2)
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i final = _mm_set1_epi8(needle[n - 1]);
+    for (; i + 16 <= last + 1; i += 16)
+    {
+        __m128i at_first = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(key + i)), first);
+        __m128i at_final = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(key + i + n - 1)), final);
+        for (unsigned bits = _mm_movemask_epi8(_mm_and_si128(at_first, at_final)); bits != 0; bits &= bits - 1)
+        {
+            size_t candidate = i + __builtin_ctz(bits);
+            if (memcmp(key + candidate, needle, n) == 0)
+            {
+                if (match_start != NULL)
+                    *match_start = candidate;
+                return true;
+            }
+        }
+    }
+#endif
+
+    while (i <= last)
+    {
+        const char *p = memchr(key + i, needle[0], last - i + 1);
+        if (p == NULL)
+            return false;
+        i = p - key;
+        if (key[i + n - 1] == needle[n - 1] && memcmp(key + i, needle, n) == 0)
+        {
+            if (match_start != NULL)
+                *match_start = i;
+            return true;
+        }
+        i++;
+    }
+    return false;
 }
 
 bool ListFilter_Match(const char *name, const char *filter,
@@ -24,29 +270,33 @@ bool ListFilter_Match(const char *name, const char *filter,
     if (name == NULL || name[0] == '\0')
         return false;
 
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, filter);
     size_t name_len = strlen(name);
-    size_t filter_len = strlen(filter);
-    if (filter_len > name_len)
+    if (query.length > name_len)
         return false;
 
-    // case-insensitive substring search over every candidate offset
-    for (size_t i = 0; i + filter_len <= name_len; i++)
-    {
-        size_t j = 0;
-        while (j < filter_len && ci_char(name[i + j]) == ci_char(filter[j]))
-            j++;
+    // fold the name into a key of its own; folding keeps byte offsets, so a
+    // match in the key is the same region of the name
+    char stack_key[256];
+    char *key = name_len <= sizeof(stack_key) ? stack_key : malloc(name_len);
+    if (key == NULL)
+        return false;
+    ListFilter_Fold(key, name, name_len);
 
-        if (j == filter_len)
-        {
-            if (match_start != NULL)
-                *match_start = i;
-            if (match_len != NULL)
-                *match_len = filter_len;
-            return true;
-        }
-    }
+    size_t start;
+    bool matched = ListFilter_MatchKey(key, name_len, &query, &start);
+    if (key != stack_key)
+        free(key);
 
-    return false;
+    if (matched)
+    {
+        if (match_start != NULL)
+            *match_start = start;
+        if (match_len != NULL)
+            *match_len = query.length;
+    }
+    return matched;
 }
 
 bool ListFilter_ItemVisible(bool is_header, bool display_on_filter,
@@ -66,3 +316,248 @@ bool ListFilter_ItemVisible(bool is_header, bool display_on_filter,
 
     return ListFilter_Match(name, filter, NULL, NULL);
 }
+
+bool ListFilter_KeyVisible(bool is_header, bool display_on_filter,
+                           const char *key, size_t key_length,
+                           const struct ListFilterQuery *query)
+{
+    // the same rules as ListFilter_ItemVisible
+    if (query->length == 0)
+        return true;
+    if (display_on_filter)
+        return true;
+    if (is_header)
+        return false;
+
+    return ListFilter_MatchKey(key, key_length, query, NULL);
+}
+
+enum ListFilterMode ListFilter_ParseMode(const char *s)
+{
+    if (s != NULL && strcmp(s, "fuzzy") == 0)
+        return LIST_FILTER_FUZZY;
+    return LIST_FILTER_SUBSTRING;
+}
+
+// fuzzy match scoring: every matched character scores FUZZY_MATCH plus a
+// bonus for where it lands, and each gap between two matched characters
+// costs FUZZY_GAP_START plus FUZZY_GAP_EXTENSION per further byte, up to
+// FUZZY_GAP_MAX
+#define FUZZY_MATCH 16
+#define FUZZY_BOUNDARY 8
+#define FUZZY_CAMEL 7
+#define FUZZY_CONSECUTIVE 5
+#define FUZZY_GAP_START 3
+#define FUZZY_GAP_EXTENSION 1
+#define FUZZY_GAP_MAX 12
+
+// is_word_byte reports whether c is part of a word: an ASCII letter or digit,
+// or any byte of a multibyte UTF-8 character.
+static bool is_word_byte(unsigned char c)
+{
+    return c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool is_digit(unsigned char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// fuzzy_bonus scores a match at byte p: the start of a word, or a camelCase
+// hump or the first digit of a number within one.
+static int fuzzy_bonus(const char *name, const char *key, size_t p)
+{
+    if (p == 0 || !is_word_byte(key[p - 1]))
+        return FUZZY_BOUNDARY;
+    if (name != NULL && name[p] >= 'A' && name[p] <= 'Z' && name[p - 1] >= 'a' && name[p - 1] <= 'z')
+        return FUZZY_CAMEL;
+    if (is_digit(key[p]) && !is_digit(key[p - 1]))
+        return FUZZY_CAMEL;
+    return 0;
+}
+
+// query_char_length returns the byte length of the UTF-8 character at the
+// start of the remaining bytes of a query; a malformed byte is a character
+// of its own.
+static size_t query_char_length(const char *text, size_t remaining)
+{
+    unsigned char lead = (unsigned char)text[0];
+    size_t length = 1;
+    if (lead >= 0xF0 && lead < 0xF8)
+        length = 4;
+    else if (lead >= 0xE0)
+        length = 3;
+    else if (lead >= 0xC0)
+        length = 2;
+    if (length > remaining)
+        return 1;
+    for (size_t i = 1; i < length; i++)
+    {
+        if (((unsigned char)text[i] & 0xC0) != 0x80)
+            return 1;
+    }
+    return length;
+}
+
+bool ListFilter_FuzzyMatch(const char *name, const char *key, size_t key_length,
+                           const struct ListFilterQuery *query, int *score, size_t *positions)
+{
+    if (score != NULL)
+        *score = 0;
+    if (query->length == 0)
+        return true;
+
+    // match each character of the query as early as possible, which finds
+    // the end of the earliest match, and record where each one starts
+    uint16_t char_starts[LIST_FILTER_QUERY_MAX];
+    size_t chars = 0;
+    size_t at = 0;
+    for (size_t j = 0; j < query->length;)
+    {
+        size_t length = query_char_length(query->text + j, query->length - j);
+        const char *found = NULL;
+        while (at + length <= key_length)
+        {
+            found = memchr(key + at, query->text[j], key_length - length + 1 - at);
+            if (found == NULL || memcmp(found, query->text + j, length) == 0)
+                break;
+            at = found - key + 1;
+            found = NULL;
+        }
+        if (found == NULL)
+            return false;
+        at = found - key + length;
+        char_starts[chars++] = j;
+        j += length;
+    }
+
+    // then match them again from that end backwards, as late as possible,
+    // which tightens the match to the shortest one ending there, and score it
+    int total = 0;
+    size_t limit = at;
+    size_t next = SIZE_MAX;
+    for (size_t k = chars; k-- > 0;)
+    {
+        const char *c = query->text + char_starts[k];
+        size_t length = (k + 1 < chars ? char_starts[k + 1] : query->length) - char_starts[k];
+        size_t p = limit - length;
+        while (key[p] != c[0] || memcmp(key + p, c, length) != 0)
+            p--;
+
+        int bonus = fuzzy_bonus(name, key, p);
+        total += FUZZY_MATCH + (k == 0 ? bonus * 2 : bonus);
+        if (next != SIZE_MAX)
+        {
+            size_t gap = next - (p + length);
+            if (gap == 0)
+                total += FUZZY_CONSECUTIVE;
+            else
+                total -= FUZZY_GAP_START + FUZZY_GAP_EXTENSION * (gap - 1 < FUZZY_GAP_MAX ? gap - 1 : FUZZY_GAP_MAX);
+        }
+        if (positions != NULL)
+            positions[k] = p;
+        next = p;
+        limit = p;
+    }
+
+    if (score != NULL)
+        *score = total;
+    return true;
+}
+
+size_t ListFilter_FuzzyHighlight(const char *name, const char *filter, size_t *positions)
+{
+    if (name == NULL || filter == NULL || filter[0] == '\0')
+        return 0;
+
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, filter);
+    size_t name_len = strlen(name);
+    char stack_key[256];
+    char *key = name_len <= sizeof(stack_key) ? stack_key : malloc(name_len);
+    if (key == NULL)
+        return 0;
+    ListFilter_Fold(key, name, name_len);
+
+    bool matched = ListFilter_FuzzyMatch(name, key, name_len, &query, NULL, positions);
+    if (key != stack_key)
+        free(key);
+    if (!matched)
+        return 0;
+
+    // one position per character of the query
+    size_t count = 0;
+    for (size_t j = 0; j < query.length; count++)
+        j += query_char_length(query.text + j, query.length - j);
+    return count;
+}
+
+bool ListFilter_Narrows(const struct ListFilterQuery *from, const struct ListFilterQuery *to)
+{
+    return from->length < to->length && strstr(to->text, from->text) != NULL;
+}
+
+void ListFilterHistory_Init(struct ListFilterHistory *history)
+{
+    history->count = 0;
+}
+
+// free_level releases what a level owns.
+static void free_level(struct ListFilterLevel *level)
+{
+    free(level->query);
+    free(level->visible);
+}
+
+bool ListFilterHistory_Push(struct ListFilterHistory *history, const struct ListFilterQuery *query,
+                            int *visible, int visible_count, size_t item_count)
+{
+    char *copy = malloc(query->length + 1);
+    if (copy == NULL)
+        return false;
+    memcpy(copy, query->text, query->length + 1);
+
+    if (history->count == LIST_FILTER_HISTORY_MAX)
+    {
+        free_level(&history->levels[0]);
+        memmove(&history->levels[0], &history->levels[1], sizeof(struct ListFilterLevel) * (LIST_FILTER_HISTORY_MAX - 1));
+        history->count--;
+    }
+
+    history->levels[history->count++] = (struct ListFilterLevel){
+        .query = copy,
+        .visible = visible,
+        .visible_count = visible_count,
+        .item_count = item_count,
+    };
+    return true;
+}
+
+bool ListFilterHistory_Take(struct ListFilterHistory *history, const struct ListFilterQuery *query,
+                            struct ListFilterLevel *level)
+{
+    size_t found = history->count;
+    while (found > 0)
+    {
+        found--;
+        if (strcmp(history->levels[found].query, query->text) == 0)
+        {
+            for (size_t i = found + 1; i < history->count; i++)
+                free_level(&history->levels[i]);
+
+            *level = history->levels[found];
+            free(level->query);
+            level->query = NULL;
+            history->count = found;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ListFilterHistory_Clear(struct ListFilterHistory *history)
+{
+    for (size_t i = 0; i < history->count; i++)
+        free_level(&history->levels[i]);
+    history->count = 0;
+}
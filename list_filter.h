@@ -8,6 +8,44 @@
 // inline keyboard filter. Keeping it display-free means it can be unit tested
 // with the host compiler (see tests/list_filter_test.c); the caller applies the
 // results to the item list and highlights the matched region.
+//
+// Matching ignores case. Names and filters are compared by their case-folded
+// search keys (see ListFilter_Fold), which the caller builds once per item
+// when the list is loaded, so the per-keystroke scan only compares bytes.
+
+// the size of ListFilterQuery's buffer; longer filters are cut short
+#define LIST_FILTER_QUERY_MAX 1024
+
+// ListFilterQuery is a filter folded once by ListFilter_Prepare, ready to be
+// matched against every item's search key.
+struct ListFilterQuery
+{
+    // the case-folded filter, NUL-terminated
+    char text[LIST_FILTER_QUERY_MAX];
+    // its length in bytes (0 for an empty or NULL filter)
+    size_t length;
+};
+
+// ListFilter_Fold writes the case-folded form of the length bytes at src to
+// dst (which may be src): ASCII letters, and the Latin, Greek, Cyrillic,
+// Armenian and fullwidth letters whose folded form takes as many UTF-8 bytes,
+// are lowercased. Everything else, including malformed UTF-8, is copied as
+// is, so the result is always length bytes long and an offset into it is
+// the same offset into src. dst is not NUL-terminated.
+void ListFilter_Fold(char *dst, const char *src, size_t length);
+
+// ListFilter_IsFolded reports whether ListFilter_Fold would leave the length
+// bytes at text unchanged, in which case text is its own search key.
+bool ListFilter_IsFolded(const char *text, size_t length);
+
+// ListFilter_Prepare folds filter into query. A NULL filter is empty.
+void ListFilter_Prepare(struct ListFilterQuery *query, const char *filter);
+
+// ListFilter_MatchKey reports whether query appears in the search key of
+// key_length bytes at key, and stores the byte offset of the first
+// occurrence in match_start (when non-NULL). An empty query matches at
+// offset 0; on a non-match match_start is set to 0.
+bool ListFilter_MatchKey(const char *key, size_t key_length, const struct ListFilterQuery *query, size_t *match_start);
 
 // ListFilter_Match reports whether `filter` appears in `name` as a
 // case-insensitive substring. An empty or NULL filter matches everything.
@@ -28,4 +66,93 @@ bool ListFilter_Match(const char *name, const char *filter,
 bool ListFilter_ItemVisible(bool is_header, bool display_on_filter,
                             const char *name, const char *filter);
 
+// ListFilter_KeyVisible applies the ListFilter_ItemVisible rules to an item
+// given by its search key, against a prepared query.
+bool ListFilter_KeyVisible(bool is_header, bool display_on_filter,
+                           const char *key, size_t key_length,
+                           const struct ListFilterQuery *query);
+
+// ListFilterMode selects how a filter matches item names (--filter-mode).
+// LIST_FILTER_SUBSTRING shows the items whose names contain the filter, in
+// list order. LIST_FILTER_FUZZY shows the items whose names contain the
+// filter's characters in order but not necessarily together, best match
+// first (see ListFilter_FuzzyMatch).
+enum ListFilterMode
+{
+    LIST_FILTER_SUBSTRING = 0,
+    LIST_FILTER_FUZZY,
+};
+
+// ListFilter_ParseMode maps "fuzzy" to LIST_FILTER_FUZZY, and anything else
+// (including "substring" and NULL) to LIST_FILTER_SUBSTRING.
+enum ListFilterMode ListFilter_ParseMode(const char *s);
+
+// ListFilter_FuzzyMatch reports whether every character of query appears in
+// the search key of key_length bytes at key, in order, and scores the
+// tightest such match in score (when non-NULL): higher for characters that
+// start a word or a camelCase hump of name (the original text of the key,
+// which may be NULL) and for characters that follow each other, lower for
+// the gaps between them. When positions is non-NULL it receives the byte
+// offset of each matched character, one per UTF-8 character of the query.
+// It allocates nothing and looks at each byte of the key at most twice. An
+// empty query matches with a score of 0.
+bool ListFilter_FuzzyMatch(const char *name, const char *key, size_t key_length,
+                           const struct ListFilterQuery *query, int *score, size_t *positions);
+
+// ListFilter_FuzzyHighlight matches filter against name as ListFilter_FuzzyMatch
+// does, for drawing: it writes the byte offset of each matched character to
+// positions, which needs room for strlen(filter) entries, and returns how
+// many it wrote (0 when name does not match or filter is empty).
+size_t ListFilter_FuzzyHighlight(const char *name, const char *filter, size_t *positions);
+
+// ListFilter_Narrows reports whether every item matching to also matches
+// from, because to is a longer query containing from (as typing another
+// character makes it), so the items for to can be found among the items for
+// from instead of the whole list.
+bool ListFilter_Narrows(const struct ListFilterQuery *from, const struct ListFilterQuery *to);
+
+// the most result sets a ListFilterHistory keeps; older ones are dropped
+#define LIST_FILTER_HISTORY_MAX 8
+
+// ListFilterLevel is the result of an earlier query: the display list of
+// source indices it left visible, and how many items the list had then.
+struct ListFilterLevel
+{
+    // the folded query (owned by the history)
+    char *query;
+    int *visible;
+    int visible_count;
+    size_t item_count;
+};
+
+// ListFilterHistory is a stack of the result sets a filter narrowed from, so
+// deleting the character that narrowed one brings it back without matching
+// the list again.
+struct ListFilterHistory
+{
+    struct ListFilterLevel levels[LIST_FILTER_HISTORY_MAX];
+    size_t count;
+};
+
+// ListFilterHistory_Init empties history.
+void ListFilterHistory_Init(struct ListFilterHistory *history);
+
+// ListFilterHistory_Push records the result of query, taking ownership of the
+// visible array (freed with free()). When the history is full its oldest
+// level is dropped. Returns false without taking visible when query cannot
+// be copied.
+bool ListFilterHistory_Push(struct ListFilterHistory *history, const struct ListFilterQuery *query,
+                            int *visible, int visible_count, size_t item_count);
+
+// ListFilterHistory_Take looks for the most recent level recorded for query.
+// When there is one, it and every level pushed after it leave the history,
+// level receives it (its query set to NULL) and the caller owns
+// level->visible. Returns false, leaving the history as it was, when query
+// has no level.
+bool ListFilterHistory_Take(struct ListFilterHistory *history, const struct ListFilterQuery *query,
+                            struct ListFilterLevel *level);
+
+// ListFilterHistory_Clear frees every level.
+void ListFilterHistory_Clear(struct ListFilterHistory *history);
+
 #endif // LIST_FILTER_H
@@ -0,0 +1,111 @@
+#include "list_gzip.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the size of each block of inflated bytes handed to the sink
+#define LIST_GZIP_BLOCK_SIZE (64 * 1024)
+
+bool ListGzip_Detect(const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    return size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b;
+}
+
+size_t ListGzip_SizeHint(const void *data, size_t size)
+{
+    // a gzip member is at least a 10 byte header and an 8 byte trailer, the
+    // last four bytes of which are the inflated size, little-endian
+    if (size < 18)
+        return 0;
+    const unsigned char *trailer = (const unsigned char *)data + size - 4;
+    size_t hint = (size_t)trailer[0] | (size_t)trailer[1] << 8 | (size_t)trailer[2] << 16 | (size_t)trailer[3] << 24;
+    // deflate cannot do better than about 1032:1, so anything more is not a
+    // real trailer
+    return hint / 1032 <= size ? hint : 0;
+}
+
+bool ListGzip_Init(struct ListGzip *gzip)
+{
+    memset(gzip, 0, sizeof(*gzip));
+    gzip->out = malloc(LIST_GZIP_BLOCK_SIZE);
+    if (gzip->out == NULL)
+        return false;
+
+    // 16 + MAX_WBITS accepts a gzip header and trailer only
+    if (inflateInit2(&gzip->stream, 16 + MAX_WBITS) != Z_OK)
+    {
+        free(gzip->out);
+        gzip->out = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool ListGzip_Write(struct ListGzip *gzip, const void *data, size_t size, ListGzipSink sink, void *ctx)
+{
+    z_stream *stream = &gzip->stream;
+    const unsigned char *next = data;
+    while (size > 0)
+    {
+        // avail_in is a uInt, so a large mapped file is fed in pieces
+        uInt piece = size > UINT_MAX / 2 ? UINT_MAX / 2 : (uInt)size;
+        stream->next_in = (Bytef *)next;
+        stream->avail_in = piece;
+        next += piece;
+        size -= piece;
+
+        // keep going while there is input, or while the last block filled up
+        // and zlib may be holding back more output
+        bool full = false;
+        while (stream->avail_in > 0 || full)
+        {
+            if (gzip->ended)
+            {
+                // another member follows the one that ended
+                if (stream->avail_in == 0)
+                    break;
+                if (inflateReset(stream) != Z_OK)
+                    return false;
+                gzip->ended = false;
+            }
+
+            uInt avail_in = stream->avail_in;
+            stream->next_out = gzip->out;
+            stream->avail_out = LIST_GZIP_BLOCK_SIZE;
+            int status = inflate(stream, Z_NO_FLUSH);
+            if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+                return false;
+
+            size_t produced = LIST_GZIP_BLOCK_SIZE - stream->avail_out;
+            if (produced > 0 && !sink(ctx, (const char *)gzip->out, produced))
+                return false;
+            if (status == Z_STREAM_END)
+                gzip->ended = true;
+            full = stream->avail_out == 0;
+            if (produced == 0 && stream->avail_in == avail_in && !gzip->ended)
+            {
+                // no progress: fine once the input is used up, an error if not
+                if (stream->avail_in > 0)
+                    return false;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool ListGzip_Complete(const struct ListGzip *gzip)
+{
+    return gzip->ended;
+}
+
+void ListGzip_Free(struct ListGzip *gzip)
+{
+    if (gzip->out == NULL)
+        return;
+    inflateEnd(&gzip->stream);
+    free(gzip->out);
+    gzip->out = NULL;
+}
@@ -0,0 +1,56 @@
+#ifndef LIST_GZIP_H
+#define LIST_GZIP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zlib.h>
+
+// list_gzip inflates gzip-compressed lists as they are read, so a list can be
+// stored compressed on a slow SD card and still be loaded without inflating it
+// to a temporary file first. Compressed bytes are fed in whatever chunks the
+// caller reads them in and the inflated bytes are handed to a sink one
+// fixed-size block at a time, so only the caller decides what is kept.
+// Concatenated gzip members are inflated one after another, as gzip -d does.
+// Keeping it display-free means it can be unit tested with the host compiler
+// (see tests/list_gzip_test.c).
+
+// ListGzipSink receives the next block of inflated bytes. Returning false
+// stops inflating.
+typedef bool (*ListGzipSink)(void *ctx, const char *data, size_t size);
+
+struct ListGzip
+{
+    z_stream stream;
+    // the block inflated bytes are written into before they reach the sink
+    unsigned char *out;
+    // whether the last member read so far ended cleanly
+    bool ended;
+};
+
+// ListGzip_Detect reports whether data starts with the gzip magic bytes.
+bool ListGzip_Detect(const void *data, size_t size);
+
+// ListGzip_SizeHint returns the inflated size recorded in the trailer of a
+// complete gzip file held in data (modulo 4 GiB, and only of the last member),
+// or 0 when data is too short to have one or the size is implausible. It is
+// only good as a first guess.
+size_t ListGzip_SizeHint(const void *data, size_t size);
+
+// ListGzip_Init prepares gzip to inflate a new stream. Returns false when
+// memory is exhausted.
+bool ListGzip_Init(struct ListGzip *gzip);
+
+// ListGzip_Write inflates the next size compressed bytes, passing everything
+// they inflate to sink. Returns false when the data is not valid gzip or the
+// sink stops it.
+bool ListGzip_Write(struct ListGzip *gzip, const void *data, size_t size, ListGzipSink sink, void *ctx);
+
+// ListGzip_Complete reports whether the data written so far ended at the end
+// of a gzip member, rather than being cut short.
+bool ListGzip_Complete(const struct ListGzip *gzip);
+
+// ListGzip_Free releases gzip. It is safe to call on a zeroed ListGzip and
+// more than once.
+void ListGzip_Free(struct ListGzip *gzip);
+
+#endif // LIST_GZIP_H
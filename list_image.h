@@ -11,13 +11,14 @@
 
 // ImageVariant maps a resolution key to an image path. The key is either
 // "default" or a "WIDTHxHEIGHT" string (e.g. "1280x720"). The path is a full
-// filesystem path to the image.
+// filesystem path to the image. Both strings are owned by the caller (the list
+// keeps them in its arena).
 struct ImageVariant
 {
     // the resolution key ("default" or "WIDTHxHEIGHT")
-    char resolution[32];
+    const char *resolution;
     // the full path to the image for this resolution
-    char path[1024];
+    const char *path;
 };
 
 // ImageFit_Scale computes aspect-fit ("contain") dimensions for an image of
@@ -0,0 +1,251 @@
+#include "list_input.h"
+#include "list_gzip.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// map_file maps size bytes of fd, followed by at least one zero byte. The file
+// is mapped over an anonymous reservation one byte longer than the file, so the
+// terminator exists even when the file ends exactly on a page boundary (where
+// touching the byte past EOF of a file mapping would raise SIGBUS).
+static bool map_file(struct ListInput *input, int fd, size_t size)
+{
+    size_t length = size + 1;
+    char *reservation = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED)
+        return false;
+
+    char *data = mmap(reservation, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        munmap(reservation, length);
+        return false;
+    }
+
+    // the loader walks the input front to back exactly once
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    input->data = data;
+    input->size = size;
+    input->mapped = length;
+    return true;
+}
+
+// InflatedBuffer collects the inflated contents of a gzip input.
+struct InflatedBuffer
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+};
+
+// append_inflated is the ListGzipSink that grows an InflatedBuffer, always
+// leaving room for the trailing NUL.
+static bool append_inflated(void *ctx, const char *data, size_t size)
+{
+    struct InflatedBuffer *buffer = ctx;
+    if (buffer->capacity - buffer->size < size + 1)
+    {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : 8192;
+        while (capacity - buffer->size < size + 1)
+            capacity *= 2;
+        char *grown = realloc(buffer->data, capacity);
+        if (grown == NULL)
+            return false;
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+    return true;
+}
+
+// read_gzip inflates a gzip input into a heap buffer with a trailing NUL. The
+// first size compressed bytes are in data; when fd is not negative the rest is
+// read from it one chunk at a time, reusing data (which has room for
+// data_capacity bytes) as the chunk buffer, so the compressed input is never
+// held in full next to the inflated contents. size_hint is the expected
+// inflated size, or 0 when unknown.
+static bool read_gzip(struct ListInput *input, int fd, char *data, size_t size, size_t data_capacity, size_t size_hint)
+{
+    struct InflatedBuffer buffer = {0};
+    struct ListGzip gzip;
+    bool ok = ListGzip_Init(&gzip);
+    if (ok && size_hint > 0)
+    {
+        buffer.data = malloc(size_hint + 1);
+        buffer.capacity = buffer.data != NULL ? size_hint + 1 : 0;
+    }
+
+    ok = ok && ListGzip_Write(&gzip, data, size, append_inflated, &buffer);
+    while (ok && fd >= 0)
+    {
+        ssize_t bytes_read = read(fd, data, data_capacity);
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
+        if (bytes_read <= 0)
+        {
+            ok = bytes_read == 0;
+            break;
+        }
+        ok = ListGzip_Write(&gzip, data, (size_t)bytes_read, append_inflated, &buffer);
+    }
+    ok = ok && ListGzip_Complete(&gzip) && append_inflated(&buffer, "", 0);
+    ListGzip_Free(&gzip);
+
+    if (!ok)
+    {
+        free(buffer.data);
+        return false;
+    }
+    buffer.data[buffer.size] = '\0';
+    input->data = buffer.data;
+    input->size = buffer.size;
+    input->mapped = 0;
+    return true;
+}
+
+// read_fd reads fd until EOF into a heap buffer with a trailing NUL. Input
+// that turns out to be gzip-compressed is inflated as it is read.
+static bool read_fd(struct ListInput *input, int fd)
+{
+    size_t capacity = 8192;
+    size_t used = 0;
+    char *buffer = malloc(capacity);
+    if (buffer == NULL)
+        return false;
+
+    for (;;)
+    {
+        if (capacity - used < 4096 + 1)
+        {
+            char *grown = realloc(buffer, capacity * 2);
+            if (grown == NULL)
+            {
+                free(buffer);
+                return false;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+
+        ssize_t bytes_read = read(fd, buffer + used, capacity - used - 1);
+        if (bytes_read < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            free(buffer);
+            return false;
+        }
+        if (bytes_read == 0)
+            break;
+
+        bool magic_unread = used < 2;
+        used += (size_t)bytes_read;
+        if (magic_unread && used >= 2 && ListGzip_Detect(buffer, used))
+        {
+            bool inflated = read_gzip(input, fd, buffer, used, capacity, 0);
+            free(buffer);
+            return inflated;
+        }
+    }
+
+    buffer[used] = '\0';
+    input->data = buffer;
+    input->size = used;
+    input->mapped = 0;
+    return true;
+}
+
+bool ListInput_OpenFd(struct ListInput *input, int fd, bool allow_empty)
+{
+    input->data = NULL;
+    input->size = 0;
+    input->mapped = 0;
+
+    struct stat st;
+    bool loaded = false;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && lseek(fd, 0, SEEK_CUR) == 0)
+    {
+        loaded = map_file(input, fd, (size_t)st.st_size);
+        if (loaded && ListGzip_Detect(input->data, input->size))
+        {
+            // inflate straight out of the mapping; only the inflated copy is
+            // kept, sized up front from the size the gzip trailer records
+            struct ListInput compressed = *input;
+            loaded = read_gzip(input, -1, compressed.data, compressed.size, 0, ListGzip_SizeHint(compressed.data, compressed.size));
+            ListInput_Close(&compressed);
+            if (!loaded)
+            {
+                input->data = NULL;
+                input->size = 0;
+                input->mapped = 0;
+                return false;
+            }
+        }
+    }
+    if (!loaded)
+    {
+        loaded = read_fd(input, fd);
+    }
+
+    if (loaded && input->size == 0 && !allow_empty)
+    {
+        ListInput_Close(input);
+        return false;
+    }
+    return loaded;
+}
+
+bool ListInput_OpenFile(struct ListInput *input, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        input->data = NULL;
+        input->size = 0;
+        input->mapped = 0;
+        return false;
+    }
+
+    bool loaded = ListInput_OpenFd(input, fd, true);
+    close(fd);
+    return loaded;
+}
+
+char *ListInput_NextLine(char **cursor, char *end)
+{
+    char *line = *cursor;
+    if (line >= end)
+        return NULL;
+
+    char *newline = memchr(line, '\n', end - line);
+    if (newline == NULL)
+    {
+        *cursor = end;
+        return line;
+    }
+
+    *newline = '\0';
+    *cursor = newline + 1;
+    return line;
+}
+
+void ListInput_Close(struct ListInput *input)
+{
+    if (input->data != NULL)
+    {
+        if (input->mapped > 0)
+            munmap(input->data, input->mapped);
+        else
+            free(input->data);
+    }
+    input->data = NULL;
+    input->size = 0;
+    input->mapped = 0;
+}
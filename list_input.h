@@ -0,0 +1,48 @@
+#ifndef LIST_INPUT_H
+#define LIST_INPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_input provides the SDL-free input layer behind ListState_New. A regular
+// file is memory-mapped (with sequential readahead advice) instead of being
+// copied into a heap buffer, so large lists on slow SD cards are paged in as the
+// loader walks them; pipes and terminals fall back to a read loop. Either way
+// the caller gets one writable, NUL-terminated buffer. Keeping it display-free
+// means it can be unit tested with the host compiler (see
+// tests/list_input_test.c).
+
+// ListInput is a loaded input buffer.
+struct ListInput
+{
+    // the contents, followed by a NUL terminator. The buffer is writable; for a
+    // mapped file, writes are private to this process and never reach the file.
+    char *data;
+    // the number of bytes of contents, excluding the terminator
+    size_t size;
+    // the length of the mapping when data is memory-mapped, 0 when it is heap
+    size_t mapped;
+};
+
+// ListInput_OpenFile loads the file at path. Returns false when the file cannot
+// be opened or read.
+bool ListInput_OpenFile(struct ListInput *input, const char *path);
+
+// ListInput_OpenFd loads everything remaining on fd, which is left open. A
+// regular file positioned at its start is mapped; anything else is read until
+// EOF. Returns false on a read error, or when allow_empty is false and no bytes
+// were available.
+bool ListInput_OpenFd(struct ListInput *input, int fd, bool allow_empty);
+
+// ListInput_NextLine returns the line starting at *cursor and advances *cursor
+// past it, or returns NULL once *cursor reaches end. The line's newline is
+// overwritten with a NUL terminator, so the returned pointer can be used in
+// place as a C string for as long as the buffer lives. The final line needs no
+// trailing newline: it is terminated by the buffer's own terminator at end.
+char *ListInput_NextLine(char **cursor, char *end);
+
+// ListInput_Close releases the buffer. It is safe to call on a zeroed input and
+// more than once.
+void ListInput_Close(struct ListInput *input);
+
+#endif // LIST_INPUT_H
@@ -0,0 +1,364 @@
+#include "list_json.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+
+// The string and container scans below look at 16 bytes at a time with NEON on
+// the device and SSE2 on x86 hosts, visiting only the bytes that can change the
+// scanner's state. Building with -DLIST_JSON_NO_SIMD (or for any other target)
+// falls back to a byte-at-a-time loop, which `make test` also covers.
+#if !defined(LIST_JSON_NO_SIMD) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LIST_JSON_NEON 1
+#elif !defined(LIST_JSON_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define LIST_JSON_SSE2 1
+#endif
+
+#if defined(LIST_JSON_NEON)
+// neon_first returns the index of the first set byte of mask, or 16 when no
+// byte is set. Narrowing each byte to a nibble packs the mask into 64 bits.
+static inline int neon_first(uint8x16_t mask)
+{
+    uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+    return bits == 0 ? 16 : __builtin_ctzll(bits) >> 2;
+}
+#endif
+
+// find_string_special returns the first quote or backslash at or after p, or
+// end when there is none.
+static char *find_string_special(char *p, char *end)
+{
+#if defined(LIST_JSON_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    for (; end - p >= 16; p += 16)
+    {
+        uint8x16_t chunk = vld1q_u8((const uint8_t *)p);
+        int i = neon_first(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)));
+        if (i < 16)
+            return p + i;
+    }
+#elif defined(LIST_JSON_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+    for (; p < end; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            return p;
+    }
+    return end;
+}
+
+// structural_bits returns a mask of the bytes among the first width bytes at p
+// that the container scan acts on: quotes, backslashes, slashes and brackets.
+// Byte i of the block is bit i << LIST_JSON_MASK_SHIFT, so callers clear bits
+// with bits &= bits - 1 and recover the byte index from the trailing zeros.
+// Setting bit 0x20 folds '[' and ']' onto '{' and '}', so five compares cover
+// all seven bytes.
+#if defined(LIST_JSON_NEON)
+#define LIST_JSON_MASK_SHIFT 2
+#else
+#define LIST_JSON_MASK_SHIFT 0
+#endif
+
+static uint64_t structural_bits(const char *p, size_t width)
+{
+#if defined(LIST_JSON_NEON)
+    if (width == 16)
+    {
+        uint8x16_t chunk = vld1q_u8((const uint8_t *)p);
+        uint8x16_t folded = vorrq_u8(chunk, vdupq_n_u8(0x20));
+        uint8x16_t strings = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('"')), vceqq_u8(chunk, vdupq_n_u8('\\')));
+        uint8x16_t brackets = vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}')));
+        uint8x16_t mask = vorrq_u8(vorrq_u8(strings, brackets), vceqq_u8(chunk, vdupq_n_u8('/')));
+        uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+        // keep one bit per byte
+        return bits & 0x1111111111111111ULL;
+    }
+#elif defined(LIST_JSON_SSE2)
+    if (width == 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        __m128i strings = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+        __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+        __m128i mask = _mm_or_si128(_mm_or_si128(strings, brackets), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('/')));
+        return (uint64_t)_mm_movemask_epi8(mask);
+    }
+#endif
+    static const unsigned char structural[256] = {
+        ['"'] = 1, ['\\'] = 1, ['/'] = 1, ['['] = 1, [']'] = 1, ['{'] = 1, ['}'] = 1,
+    };
+    uint64_t bits = 0;
+    for (size_t i = 0; i < width; i++)
+        bits |= (uint64_t)structural[(unsigned char)p[i]] << (i << LIST_JSON_MASK_SHIFT);
+    return bits;
+}
+
+// skip_comment returns one past the comment starting at p, or p itself when p
+// does not start a comment. An unterminated block comment runs to the end.
+static char *skip_comment(char *p, char *end)
+{
+    if (p + 1 >= end || p[0] != '/')
+        return p;
+
+    if (p[1] == '*')
+    {
+        for (char *q = p + 2; q + 1 < end; q++)
+        {
+            if (q[0] == '*' && q[1] == '/')
+                return q + 2;
+        }
+        return end;
+    }
+
+    if (p[1] == '/')
+    {
+        char *newline = memchr(p + 2, '\n', end - (p + 2));
+        return newline != NULL ? newline + 1 : end;
+    }
+
+    return p;
+}
+
+// skip_string returns one past the closing quote of the string starting at p,
+// or NULL when the string is not terminated.
+static char *skip_string(char *p, char *end)
+{
+    for (char *q = p + 1; q < end; q += 2)
+    {
+        q = find_string_special(q, end);
+        if (q >= end)
+            break;
+        if (*q == '"')
+            return q + 1;
+        // a backslash: step over it and the character it escapes
+    }
+    return NULL;
+}
+
+// is_delimiter reports whether c ends a bare token (number or literal).
+static bool is_delimiter(char c)
+{
+    return isspace((unsigned char)c) || c == ',' || c == ':' || c == ']' || c == '}' || c == '/' || c == '\0';
+}
+
+char *ListJSON_SkipSpace(char *p, char *end)
+{
+    while (p < end)
+    {
+        if (isspace((unsigned char)*p))
+        {
+            p++;
+            continue;
+        }
+
+        char *after = skip_comment(p, end);
+        if (after == p)
+            break;
+        p = after;
+    }
+    return p;
+}
+
+char *ListJSON_SkipValue(char *p, char *end)
+{
+    if (p >= end)
+        return NULL;
+
+    if (*p == '"')
+        return skip_string(p, end);
+
+    if (*p == '[' || *p == '{')
+    {
+        // walk the container a block at a time, visiting only the bytes
+        // structural_bits flags. An escape or a comment moves the scan to
+        // just past it and the next block starts there.
+        int depth = 0;
+        bool in_string = false;
+        char *q = p;
+        while (q < end)
+        {
+            char *block = q;
+            size_t width = end - block < 16 ? (size_t)(end - block) : 16;
+            q = block + width;
+
+            uint64_t bits = structural_bits(block, width);
+            while (bits != 0)
+            {
+                char *at = block + (__builtin_ctzll(bits) >> LIST_JSON_MASK_SHIFT);
+                bits &= bits - 1;
+
+                char c = *at;
+                if (in_string)
+                {
+                    if (c == '"')
+                    {
+                        in_string = false;
+                    }
+                    else if (c == '\\')
+                    {
+                        // step over the escaped character
+                        q = at + 2;
+                        break;
+                    }
+                    continue;
+                }
+
+                if (c == '"')
+                {
+                    in_string = true;
+                }
+                else if (c == '/')
+                {
+                    char *after = skip_comment(at, end);
+                    if (after != at)
+                    {
+                        q = after;
+                        break;
+                    }
+                }
+                else if (c == '[' || c == '{')
+                {
+                    depth++;
+                }
+                else if (c == ']' || c == '}')
+                {
+                    depth--;
+                    if (depth == 0)
+                        return at + 1;
+                }
+            }
+        }
+        return NULL;
+    }
+
+    // bare tokens: a literal must be spelled out exactly and a number may only
+    // use number characters, so trailing junk is caught here rather than being
+    // silently dropped when the span is parsed on its own
+    char *q = p;
+    const char *literals[] = {"true", "false", "null"};
+    for (size_t i = 0; i < sizeof(literals) / sizeof(literals[0]); i++)
+    {
+        size_t len = strlen(literals[i]);
+        if ((size_t)(end - p) >= len && memcmp(p, literals[i], len) == 0)
+        {
+            q = p + len;
+            break;
+        }
+    }
+    if (q == p && (*p == '-' || isdigit((unsigned char)*p)))
+    {
+        while (q < end && (isdigit((unsigned char)*q) || *q == '-' || *q == '+' || *q == '.' || *q == 'e' || *q == 'E'))
+            q++;
+    }
+    if (q == p || (q < end && !is_delimiter(*q)))
+        return NULL;
+    return q;
+}
+
+bool ListJSON_Enter(struct ListJSONCursor *cursor, char *p, char *end)
+{
+    if (p >= end || (*p != '[' && *p != '{'))
+        return false;
+
+    cursor->p = p + 1;
+    cursor->end = end;
+    cursor->close = *p == '[' ? ']' : '}';
+    cursor->first = true;
+    return true;
+}
+
+// cursor_advance moves past the separator before the next entry. It returns
+// LIST_JSON_END at the closing bracket, LIST_JSON_VALUE when an entry follows,
+// and LIST_JSON_ERROR for a missing comma, trailing comma or truncated input.
+static enum ListJSONStatus cursor_advance(struct ListJSONCursor *cursor)
+{
+    char *p = ListJSON_SkipSpace(cursor->p, cursor->end);
+    if (p >= cursor->end)
+        return LIST_JSON_ERROR;
+
+    if (*p == cursor->close)
+    {
+        cursor->p = p + 1;
+        return LIST_JSON_END;
+    }
+
+    if (!cursor->first)
+    {
+        if (*p != ',')
+            return LIST_JSON_ERROR;
+
+        // a comma must be followed by another entry, not the closing bracket
+        p = ListJSON_SkipSpace(p + 1, cursor->end);
+        if (p >= cursor->end || *p == cursor->close)
+            return LIST_JSON_ERROR;
+    }
+
+    cursor->first = false;
+    cursor->p = p;
+    return LIST_JSON_VALUE;
+}
+
+enum ListJSONStatus ListJSON_NextElement(struct ListJSONCursor *cursor, struct ListJSONSpan *value)
+{
+    enum ListJSONStatus status = cursor_advance(cursor);
+    if (status != LIST_JSON_VALUE)
+        return status;
+
+    char *value_end = ListJSON_SkipValue(cursor->p, cursor->end);
+    if (value_end == NULL)
+        return LIST_JSON_ERROR;
+
+    value->start = cursor->p;
+    value->length = value_end - cursor->p;
+    cursor->p = value_end;
+    return LIST_JSON_VALUE;
+}
+
+enum ListJSONStatus ListJSON_NextMember(struct ListJSONCursor *cursor, struct ListJSONSpan *key, struct ListJSONSpan *value)
+{
+    enum ListJSONStatus status = cursor_advance(cursor);
+    if (status != LIST_JSON_VALUE)
+        return status;
+
+    if (*cursor->p != '"')
+        return LIST_JSON_ERROR;
+
+    char *key_end = skip_string(cursor->p, cursor->end);
+    if (key_end == NULL)
+        return LIST_JSON_ERROR;
+
+    char *p = ListJSON_SkipSpace(key_end, cursor->end);
+    if (p >= cursor->end || *p != ':')
+        return LIST_JSON_ERROR;
+
+    p = ListJSON_SkipSpace(p + 1, cursor->end);
+    char *value_end = ListJSON_SkipValue(p, cursor->end);
+    if (value_end == NULL)
+        return LIST_JSON_ERROR;
+
+    key->start = cursor->p;
+    key->length = key_end - cursor->p;
+    value->start = p;
+    value->length = value_end - p;
+    cursor->p = value_end;
+    return LIST_JSON_VALUE;
+}
+
+char *ListJSON_SkipBOM(char *p, char *end)
+{
+    if (end - p >= 3 && (unsigned char)p[0] == 0xEF && (unsigned char)p[1] == 0xBB && (unsigned char)p[2] == 0xBF)
+        return p + 3;
+    return p;
+}
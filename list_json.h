@@ -0,0 +1,80 @@
+#ifndef LIST_JSON_H
+#define LIST_JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_json provides the parson-free structural scanner behind the streaming
+// item loader. It walks the outer skeleton of a JSON document (the root object
+// or array and the items array inside it) and hands back the byte span of each
+// member or element, so the caller can parse and build one item at a time
+// instead of materializing the whole document tree. The scanner only checks the
+// skeleton it walks (brackets, commas, colons, string boundaries); the contents
+// of each span are left for the caller's parser to validate. Keeping it
+// display-free means it can be unit tested with the host compiler (see
+// tests/list_json_test.c).
+//
+// Comments are treated as whitespace, matching parson's *_with_comments
+// parsers: "/* ... */" blocks and "// ..." lines outside of strings.
+
+// ListJSONSpan is a byte range within the scanned buffer. The span is not
+// NUL-terminated.
+struct ListJSONSpan
+{
+    char *start;
+    size_t length;
+};
+
+// ListJSONCursor iterates the members of an object or the elements of an array.
+// Initialize it with ListJSON_Enter and advance it with ListJSON_NextElement or
+// ListJSON_NextMember.
+struct ListJSONCursor
+{
+    // the next unread byte
+    char *p;
+    // one past the last byte of the buffer
+    char *end;
+    // the closing bracket for this container (']' or '}')
+    char close;
+    // true until the first element or member has been read
+    bool first;
+};
+
+// ListJSONStatus is returned by the cursor iteration functions.
+enum ListJSONStatus
+{
+    // the input is not a well-formed container at this point
+    LIST_JSON_ERROR = -1,
+    // the container's closing bracket was reached
+    LIST_JSON_END = 0,
+    // a value (and, for objects, its key) was read
+    LIST_JSON_VALUE = 1,
+};
+
+// ListJSON_SkipSpace returns the first byte at or after p that is neither JSON
+// whitespace nor part of a comment, or end when nothing else remains.
+char *ListJSON_SkipSpace(char *p, char *end);
+
+// ListJSON_SkipValue returns one past the last byte of the value starting at p.
+// Strings end at their closing quote, objects and arrays at their matching
+// bracket, and bare tokens (numbers, true, false, null) at the next delimiter.
+// Returns NULL when the value is empty or runs off the end of the buffer.
+char *ListJSON_SkipValue(char *p, char *end);
+
+// ListJSON_Enter prepares a cursor over the container starting at p, which must
+// point at '[' or '{'. Returns false when it points at anything else.
+bool ListJSON_Enter(struct ListJSONCursor *cursor, char *p, char *end);
+
+// ListJSON_NextElement reads the next array element into value. Trailing or
+// doubled commas and a missing closing bracket are reported as errors.
+enum ListJSONStatus ListJSON_NextElement(struct ListJSONCursor *cursor, struct ListJSONSpan *value);
+
+// ListJSON_NextMember reads the next object member. key receives the quoted key
+// (including its quotes, escapes left as-is) and value the member's value.
+enum ListJSONStatus ListJSON_NextMember(struct ListJSONCursor *cursor, struct ListJSONSpan *key, struct ListJSONSpan *value);
+
+// ListJSON_SkipBOM returns p advanced past a leading UTF-8 byte order mark, if
+// one is present.
+char *ListJSON_SkipBOM(char *p, char *end);
+
+#endif // LIST_JSON_H
@@ -0,0 +1,67 @@
+#include "list_keypath.h"
+
+#include <ctype.h>
+#include <string.h>
+
+// add_segment appends a segment, failing when the path is already full.
+static bool add_segment(struct ListKeyPath *path, const char *key, int index)
+{
+    if (path->count == LIST_KEYPATH_MAX_SEGMENTS)
+        return false;
+    path->segments[path->count].key = key;
+    path->segments[path->count].index = index;
+    path->count++;
+    return true;
+}
+
+bool ListKeyPath_Parse(struct ListKeyPath *path, const char *text)
+{
+    path->count = 0;
+    size_t length = strlen(text);
+    if (length == 0 || length >= sizeof(path->text))
+        return false;
+    memcpy(path->text, text, length + 1);
+
+    char *p = path->text;
+    // a key is expected at the start and after every dot
+    bool want_key = true;
+    while (*p != '\0')
+    {
+        if (want_key)
+        {
+            char *key = p;
+            while (*p != '\0' && *p != '.' && *p != '[' && *p != ']')
+                p++;
+            if (p == key || *p == ']' || !add_segment(path, key, 0))
+                return false;
+            want_key = false;
+            continue;
+        }
+
+        if (*p == '.')
+        {
+            // the dot ends the key before it (or follows an index)
+            *p++ = '\0';
+            want_key = true;
+            continue;
+        }
+
+        if (*p != '[')
+            return false;
+        *p++ = '\0';
+        if (!isdigit((unsigned char)*p))
+            return false;
+        long index = 0;
+        while (isdigit((unsigned char)*p))
+        {
+            index = index * 10 + (*p++ - '0');
+            if (index > LIST_KEYPATH_MAX_INDEX)
+                return false;
+        }
+        if (*p++ != ']' || !add_segment(path, NULL, (int)index))
+            return false;
+    }
+
+    // a trailing dot leaves a key missing
+    return !want_key;
+}
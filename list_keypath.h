@@ -0,0 +1,46 @@
+#ifndef LIST_KEYPATH_H
+#define LIST_KEYPATH_H
+
+#include <stdbool.h>
+
+// list_keypath parses the --item-key path that locates the items array in a
+// JSON document, such as "items", "data.menus[2].items" or "pages[0][1]".
+// Keys are separated by dots and array indexes follow in brackets, so arrays
+// nested deep inside a document can be loaded (and written back to the same
+// place) without running the document through jq first. Keeping it
+// display-free means it can be unit tested with the host compiler (see
+// tests/list_keypath_test.c).
+
+// the most segments a path may have
+#define LIST_KEYPATH_MAX_SEGMENTS 16
+// the largest array index a path may use. write_output pads arrays with nulls
+// up to an index, so this bounds what a path can make it allocate.
+#define LIST_KEYPATH_MAX_INDEX 65535
+// the longest path, including its NUL terminator
+#define LIST_KEYPATH_MAX_LENGTH 1024
+
+// ListKeyPathSegment is one step of a path: an object key or an array index.
+struct ListKeyPathSegment
+{
+    // the key to look up, or NULL when this segment is an array index. Points
+    // into the path's own copy of the text.
+    const char *key;
+    // the array index when key is NULL
+    int index;
+};
+
+struct ListKeyPath
+{
+    // the path text with each key NUL-terminated in place
+    char text[LIST_KEYPATH_MAX_LENGTH];
+    struct ListKeyPathSegment segments[LIST_KEYPATH_MAX_SEGMENTS];
+    int count;
+};
+
+// ListKeyPath_Parse parses text into path. The path must start with a key;
+// keys are one or more characters other than '.', '[' and ']', and indexes
+// are decimal numbers no larger than LIST_KEYPATH_MAX_INDEX. Returns false
+// when text is empty, malformed, too long or has too many segments.
+bool ListKeyPath_Parse(struct ListKeyPath *path, const char *text);
+
+#endif // LIST_KEYPATH_H
@@ -0,0 +1,336 @@
+#include "list_loader.h"
+#include "list_gzip.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// the size of each read from the input
+#define LIST_LOADER_CHUNK_SIZE (64 * 1024)
+
+// grow makes room for one more entry in a pointer array, doubling its
+// capacity. Returns false when memory is exhausted.
+static bool grow(const char ***array, size_t count, size_t *capacity)
+{
+    if (count < *capacity)
+        return true;
+
+    size_t grown_capacity = *capacity > 0 ? *capacity * 2 : 256;
+    const char **grown = realloc(*array, sizeof(const char *) * grown_capacity);
+    if (grown == NULL)
+        return false;
+    *array = grown;
+    *capacity = grown_capacity;
+    return true;
+}
+
+// emit_line copies a complete line into the arena and queues it for the next
+// publish, unless it is blank. Like the text format, the name ends at the
+// first NUL byte, and a line with nothing but whitespace before it is skipped
+// (or queued as "" with keep_blank_lines).
+static bool emit_line(struct ListLoader *loader, const char *start, size_t length)
+{
+    size_t name_length = strnlen(start, length);
+    size_t k = 0;
+    while (k < name_length && isspace((unsigned char)start[k]))
+        k++;
+    if (k == name_length)
+    {
+        if (!loader->keep_blank_lines)
+            return true;
+        if (!grow(&loader->batch, loader->batch_count, &loader->batch_capacity))
+            return false;
+        loader->batch[loader->batch_count++] = "";
+        return true;
+    }
+
+    char *name = ListArena_Alloc(&loader->arena, name_length + 1);
+    if (name == NULL || !grow(&loader->batch, loader->batch_count, &loader->batch_capacity))
+        return false;
+    memcpy(name, start, name_length);
+    name[name_length] = '\0';
+    loader->batch[loader->batch_count++] = name;
+    return true;
+}
+
+// stage_line appends part of a line that continues into the next read.
+static bool stage_line(struct ListLoader *loader, const char *start, size_t length)
+{
+    if (loader->line_capacity - loader->line_length < length)
+    {
+        size_t capacity = loader->line_capacity > 0 ? loader->line_capacity : 256;
+        while (capacity - loader->line_length < length)
+            capacity *= 2;
+        char *grown = realloc(loader->line, capacity);
+        if (grown == NULL)
+            return false;
+        loader->line = grown;
+        loader->line_capacity = capacity;
+    }
+    memcpy(loader->line + loader->line_length, start, length);
+    loader->line_length += length;
+    return true;
+}
+
+// split_chunk splits a chunk of input into lines, joining the first one with
+// any line staged from earlier reads and staging an unterminated last one.
+static bool split_chunk(struct ListLoader *loader, const char *chunk, size_t size)
+{
+    const char *p = chunk;
+    const char *end = chunk + size;
+    while (p < end)
+    {
+        const char *newline = memchr(p, '\n', end - p);
+        if (newline == NULL)
+            return stage_line(loader, p, end - p);
+
+        bool ok;
+        if (loader->line_length > 0)
+        {
+            ok = stage_line(loader, p, newline - p) && emit_line(loader, loader->line, loader->line_length);
+            loader->line_length = 0;
+        }
+        else
+        {
+            ok = emit_line(loader, p, newline - p);
+        }
+        if (!ok)
+            return false;
+        p = newline + 1;
+    }
+    return true;
+}
+
+// publish moves the batched lines to the UI thread and, when finished is set,
+// marks the input as done.
+static bool publish(struct ListLoader *loader, bool finished, bool failed)
+{
+    bool ok = true;
+    pthread_mutex_lock(&loader->lock);
+    for (size_t k = 0; k < loader->batch_count && ok; k++)
+    {
+        ok = grow(&loader->pending, loader->pending_count, &loader->pending_capacity);
+        if (ok)
+        {
+            loader->pending[loader->pending_count++] = loader->batch[k];
+            loader->published++;
+        }
+    }
+    if (finished || !ok)
+    {
+        loader->done = true;
+        loader->failed = failed || !ok;
+    }
+    pthread_cond_broadcast(&loader->changed);
+    pthread_mutex_unlock(&loader->lock);
+
+    loader->batch_count = 0;
+    return ok;
+}
+
+// split_inflated is the ListGzipSink that splits inflated input into lines.
+static bool split_inflated(void *ctx, const char *data, size_t size)
+{
+    return split_chunk(ctx, data, size);
+}
+
+// free_gzip releases the inflater when the loader thread exits or is
+// cancelled.
+static void free_gzip(void *gzip)
+{
+    ListGzip_Free(gzip);
+}
+
+static void *loader_main(void *arg)
+{
+    struct ListLoader *loader = arg;
+
+    // the thread may only be cancelled while it is blocked reading, so it
+    // never stops halfway through updating the shared state
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+    // gzip-compressed input is recognized by its first two bytes and
+    // inflated chunk by chunk as it is read
+    struct ListGzip gzip = {0};
+    bool detected = false;
+    bool compressed = false;
+    size_t filled = 0;
+
+    char *chunk = malloc(LIST_LOADER_CHUNK_SIZE);
+    bool failed = chunk == NULL;
+    pthread_cleanup_push(free, chunk);
+    pthread_cleanup_push(free_gzip, &gzip);
+    while (!failed)
+    {
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        ssize_t bytes_read = read(loader->fd, chunk + filled, LIST_LOADER_CHUNK_SIZE - filled);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+        if (bytes_read < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            failed = true;
+            break;
+        }
+        if (bytes_read == 0)
+            break;
+
+        filled += (size_t)bytes_read;
+        if (!detected)
+        {
+            // the magic bytes may arrive in separate reads
+            if (filled < 2)
+                continue;
+            detected = true;
+            if (ListGzip_Detect(chunk, filled))
+            {
+                compressed = ListGzip_Init(&gzip);
+                failed = !compressed;
+                if (failed)
+                    break;
+            }
+        }
+
+        bool split = compressed ? ListGzip_Write(&gzip, chunk, filled, split_inflated, loader) : split_chunk(loader, chunk, filled);
+        filled = 0;
+        if (!split || !publish(loader, false, false))
+        {
+            failed = true;
+        }
+    }
+    // input of a single byte never got as far as being split
+    if (!failed && filled > 0)
+    {
+        failed = !split_chunk(loader, chunk, filled);
+    }
+    if (!failed && compressed && !ListGzip_Complete(&gzip))
+    {
+        failed = true;
+    }
+    pthread_cleanup_pop(1);
+    pthread_cleanup_pop(1);
+
+    // an unterminated final line still counts
+    if (!failed && loader->line_length > 0)
+    {
+        failed = !emit_line(loader, loader->line, loader->line_length);
+        loader->line_length = 0;
+    }
+
+    if (loader->close_fd)
+    {
+        close(loader->fd);
+        loader->fd = -1;
+    }
+    publish(loader, true, failed);
+    return NULL;
+}
+
+bool ListLoader_Start(struct ListLoader *loader, int fd, bool close_fd, bool keep_blank_lines)
+{
+    memset(loader, 0, sizeof(*loader));
+    loader->fd = fd;
+    loader->close_fd = close_fd;
+    loader->keep_blank_lines = keep_blank_lines;
+    ListArena_Init(&loader->arena);
+    pthread_mutex_init(&loader->lock, NULL);
+    pthread_cond_init(&loader->changed, NULL);
+
+    if (pthread_create(&loader->thread, NULL, loader_main, loader) != 0)
+    {
+        pthread_cond_destroy(&loader->changed);
+        pthread_mutex_destroy(&loader->lock);
+        return false;
+    }
+    loader->running = true;
+    return true;
+}
+
+size_t ListLoader_Poll(struct ListLoader *loader, const char ***names, bool *done)
+{
+    pthread_mutex_lock(&loader->lock);
+    // swap the arrays: the loader fills the one handed out last time, which
+    // the caller has finished with by now
+    const char **batch = loader->pending;
+    size_t capacity = loader->pending_capacity;
+    size_t count = loader->pending_count;
+    loader->pending = loader->taken;
+    loader->pending_capacity = loader->taken_capacity;
+    loader->pending_count = 0;
+    *done = loader->done;
+    pthread_mutex_unlock(&loader->lock);
+
+    loader->taken = batch;
+    loader->taken_capacity = capacity;
+    *names = batch;
+    return count;
+}
+
+bool ListLoader_Wait(struct ListLoader *loader, size_t count, int timeout_ms)
+{
+    struct timespec deadline;
+    if (timeout_ms >= 0)
+    {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    bool ready = true;
+    pthread_mutex_lock(&loader->lock);
+    while (loader->published < count && !loader->done)
+    {
+        if (timeout_ms < 0)
+        {
+            pthread_cond_wait(&loader->changed, &loader->lock);
+        }
+        else if (pthread_cond_timedwait(&loader->changed, &loader->lock, &deadline) != 0)
+        {
+            ready = loader->published >= count || loader->done;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&loader->lock);
+    return ready;
+}
+
+void ListLoader_Free(struct ListLoader *loader)
+{
+    if (loader->running)
+    {
+        pthread_mutex_lock(&loader->lock);
+        bool done = loader->done;
+        pthread_mutex_unlock(&loader->lock);
+        if (!done)
+            pthread_cancel(loader->thread);
+        pthread_join(loader->thread, NULL);
+        loader->running = false;
+
+        if (loader->close_fd && loader->fd >= 0)
+        {
+            close(loader->fd);
+            loader->fd = -1;
+        }
+        pthread_cond_destroy(&loader->changed);
+        pthread_mutex_destroy(&loader->lock);
+    }
+
+    free(loader->line);
+    free(loader->batch);
+    free(loader->pending);
+    free(loader->taken);
+    ListArena_Free(&loader->arena);
+    loader->line = NULL;
+    loader->batch = NULL;
+    loader->pending = NULL;
+    loader->taken = NULL;
+}
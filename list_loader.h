@@ -0,0 +1,86 @@
+#ifndef LIST_LOADER_H
+#define LIST_LOADER_H
+
+#include "list_arena.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_loader reads a newline-delimited list on a background thread, so the
+// list can be drawn while a slow producer (e.g. a script scanning a ROM
+// directory) is still writing it. The loader thread splits the input into
+// lines, copies each non-blank line into its own arena and publishes them in
+// batches; the UI thread picks up new lines once per frame with
+// ListLoader_Poll. Line handling matches the text format: blank and
+// whitespace-only lines are skipped, and a final line without a newline still
+// counts. The jsonl format keeps blank lines instead, so every line published
+// can be reported by its line number. Keeping it display-free means it can be
+// unit tested with the host compiler (see tests/list_loader_test.c).
+
+struct ListLoader
+{
+    pthread_t thread;
+    // guards the published fields below
+    pthread_mutex_t lock;
+    // signalled whenever lines are published or loading finishes
+    pthread_cond_t changed;
+    // the descriptor being read, and whether the loader closes it
+    int fd;
+    bool close_fd;
+    // whether blank lines are published (as "") rather than skipped
+    bool keep_blank_lines;
+    // whether the thread was started and has not been joined yet
+    bool running;
+
+    // owned by the loader thread while it runs. line holds a line that spans
+    // reads. Line copies live in the arena, so published names stay valid
+    // until ListLoader_Free.
+    struct ListArena arena;
+    char *line;
+    size_t line_length;
+    size_t line_capacity;
+    // lines split from the current chunk, not yet published
+    const char **batch;
+    size_t batch_count;
+    size_t batch_capacity;
+
+    // published to the UI thread (guarded by lock)
+    const char **pending;
+    size_t pending_count;
+    size_t pending_capacity;
+    // the number of lines published so far
+    size_t published;
+    // whether the input has been read to the end (or failed)
+    bool done;
+    // whether reading stopped on an error rather than end of input
+    bool failed;
+
+    // owned by the UI thread: the batch returned by the last ListLoader_Poll
+    const char **taken;
+    size_t taken_capacity;
+};
+
+// ListLoader_Start starts reading fd on a new thread. When close_fd is set the
+// loader closes fd once it is done with it. When keep_blank_lines is set blank
+// lines are published as empty names, so the Nth name published is line N.
+// Returns false if the thread could not be started, in which case fd is left
+// open.
+bool ListLoader_Start(struct ListLoader *loader, int fd, bool close_fd, bool keep_blank_lines);
+
+// ListLoader_Poll hands over the lines published since the previous call.
+// *names is set to an array of them, valid until the next call; the names
+// themselves stay valid until ListLoader_Free. *done is set once every line
+// has been handed over and the input is finished. Returns the number of names.
+size_t ListLoader_Poll(struct ListLoader *loader, const char ***names, bool *done);
+
+// ListLoader_Wait blocks until at least count lines have been published in
+// total, the input is finished, or timeout_ms elapses (a negative timeout
+// waits indefinitely). Returns true unless it timed out.
+bool ListLoader_Wait(struct ListLoader *loader, size_t count, int timeout_ms);
+
+// ListLoader_Free stops the loader thread if it is still reading, and releases
+// everything it owns, including every line it published.
+void ListLoader_Free(struct ListLoader *loader);
+
+#endif // LIST_LOADER_H
@@ -0,0 +1,135 @@
+#include "list_options.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ListOptionTable is one interned array, chained into its hash bucket.
+struct ListOptionTable
+{
+    struct ListOptionTable *next;
+    uint64_t hash;
+    size_t count;
+    const char **options;
+};
+
+void ListOptionTables_Init(struct ListOptionTables *tables, struct ListArena *arena)
+{
+    tables->arena = arena;
+    tables->buckets = NULL;
+    tables->bucket_count = 0;
+    tables->count = 0;
+}
+
+// option returns source's option index, with non-strings read as "".
+static const char *option(const void *source, size_t index, ListOptionsGet get)
+{
+    const char *value = get(source, index);
+    return value != NULL ? value : "";
+}
+
+// hash_options hashes the strings of an array with FNV-1a, including each
+// terminator so ["ab", "c"] and ["a", "bc"] differ.
+static uint64_t hash_options(const void *source, size_t count, ListOptionsGet get)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        const unsigned char *p = (const unsigned char *)option(source, i, get);
+        do
+        {
+            hash ^= *p;
+            hash *= 1099511628211ULL;
+        } while (*p++ != '\0');
+    }
+    return hash;
+}
+
+static bool same_options(const struct ListOptionTable *table, const void *source, size_t count, ListOptionsGet get)
+{
+    if (table->count != count)
+        return false;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strcmp(table->options[i], option(source, i, get)) != 0)
+            return false;
+    }
+    return true;
+}
+
+// grow doubles the bucket array once the index averages one array per bucket.
+static bool grow(struct ListOptionTables *tables)
+{
+    if (tables->count < tables->bucket_count)
+        return true;
+
+    size_t bucket_count = tables->bucket_count > 0 ? tables->bucket_count * 2 : 64;
+    struct ListOptionTable **buckets = calloc(bucket_count, sizeof(struct ListOptionTable *));
+    if (buckets == NULL)
+        return false;
+
+    for (size_t b = 0; b < tables->bucket_count; b++)
+    {
+        struct ListOptionTable *table = tables->buckets[b];
+        while (table != NULL)
+        {
+            struct ListOptionTable *next = table->next;
+            size_t slot = table->hash & (bucket_count - 1);
+            table->next = buckets[slot];
+            buckets[slot] = table;
+            table = next;
+        }
+    }
+    free(tables->buckets);
+    tables->buckets = buckets;
+    tables->bucket_count = bucket_count;
+    return true;
+}
+
+const char **ListOptionTables_Intern(struct ListOptionTables *tables, const void *source, size_t count, ListOptionsGet get)
+{
+    if (count == 0)
+        return NULL;
+
+    uint64_t hash = hash_options(source, count, get);
+    if (tables->bucket_count > 0)
+    {
+        struct ListOptionTable *table = tables->buckets[hash & (tables->bucket_count - 1)];
+        for (; table != NULL; table = table->next)
+        {
+            if (table->hash == hash && same_options(table, source, count, get))
+                return table->options;
+        }
+    }
+
+    if (!grow(tables))
+        return NULL;
+
+    struct ListOptionTable *table = ListArena_Alloc(tables->arena, sizeof(struct ListOptionTable));
+    const char **options = ListArena_Alloc(tables->arena, sizeof(const char *) * count);
+    if (table == NULL || options == NULL)
+        return NULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        options[i] = ListArena_Strdup(tables->arena, option(source, i, get));
+        if (options[i] == NULL)
+            return NULL;
+    }
+
+    table->hash = hash;
+    table->count = count;
+    table->options = options;
+    size_t slot = hash & (tables->bucket_count - 1);
+    table->next = tables->buckets[slot];
+    tables->buckets[slot] = table;
+    tables->count++;
+    return options;
+}
+
+void ListOptionTables_Free(struct ListOptionTables *tables)
+{
+    free(tables->buckets);
+    tables->buckets = NULL;
+    tables->bucket_count = 0;
+    tables->count = 0;
+}
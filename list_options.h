@@ -0,0 +1,48 @@
+#ifndef LIST_OPTIONS_H
+#define LIST_OPTIONS_H
+
+#include "list_arena.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// list_options interns item option arrays. Settings-style lists repeat the same
+// options on many items (["on", "off"], a 0-100 scale), so each distinct
+// array is copied into the list's arena once and every item that uses it
+// points at the shared, immutable copy. Keeping it display-free means it can
+// be unit tested with the host compiler (see tests/list_options_test.c).
+
+struct ListOptionTable;
+
+// ListOptionTables indexes the option arrays interned into one arena.
+// Initialize it with ListOptionTables_Init.
+struct ListOptionTables
+{
+    // where interned arrays, their strings and the index entries live
+    struct ListArena *arena;
+    // hash buckets of interned arrays (a power of two in size)
+    struct ListOptionTable **buckets;
+    size_t bucket_count;
+    // the number of distinct arrays interned
+    size_t count;
+};
+
+// ListOptionsGet returns option index of source, or NULL for an option that
+// is not a string (stored as "").
+typedef const char *(*ListOptionsGet)(const void *source, size_t index);
+
+// ListOptionTables_Init prepares an empty index whose arrays are allocated
+// from arena.
+void ListOptionTables_Init(struct ListOptionTables *tables, struct ListArena *arena);
+
+// ListOptionTables_Intern returns the shared array holding the count options
+// read from source with get, copying it into the arena the first time it is
+// seen. The array and its strings live as long as the arena. Returns NULL for
+// an empty array or when memory is exhausted.
+const char **ListOptionTables_Intern(struct ListOptionTables *tables, const void *source, size_t count, ListOptionsGet get);
+
+// ListOptionTables_Free releases the index. Interned arrays stay valid, since
+// they belong to the arena.
+void ListOptionTables_Free(struct ListOptionTables *tables);
+
+#endif // LIST_OPTIONS_H
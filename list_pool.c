@@ -0,0 +1,77 @@
+#include "list_pool.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+// ListPoolSlice is one worker's share of a ListPool_Run.
+struct ListPoolSlice
+{
+    pthread_t thread;
+    ListPoolSliceFunc fn;
+    void *context;
+    size_t worker;
+    size_t begin;
+    size_t end;
+    // whether the slice has its own thread to join
+    bool started;
+};
+
+size_t ListPool_WorkerCount(size_t count, size_t min_per_worker)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t workers = cpus > 0 ? (size_t)cpus : 1;
+    if (workers > LIST_POOL_MAX_WORKERS)
+        workers = LIST_POOL_MAX_WORKERS;
+    if (min_per_worker > 0 && workers > count / min_per_worker)
+        workers = count / min_per_worker;
+    return workers > 0 ? workers : 1;
+}
+
+size_t ListPool_SliceBegin(size_t count, size_t worker_count, size_t worker)
+{
+    if (worker >= worker_count)
+        return count;
+    // count * worker / worker_count without overflowing for large counts
+    return count / worker_count * worker + count % worker_count * worker / worker_count;
+}
+
+static void *slice_main(void *arg)
+{
+    struct ListPoolSlice *slice = arg;
+    slice->fn(slice->context, slice->worker, slice->begin, slice->end);
+    return NULL;
+}
+
+void ListPool_Run(size_t count, size_t worker_count, ListPoolSliceFunc fn, void *context)
+{
+    if (worker_count < 1)
+        worker_count = 1;
+    if (worker_count > LIST_POOL_MAX_WORKERS)
+        worker_count = LIST_POOL_MAX_WORKERS;
+
+    struct ListPoolSlice slices[LIST_POOL_MAX_WORKERS];
+    for (size_t w = 0; w < worker_count; w++)
+    {
+        slices[w] = (struct ListPoolSlice){
+            .fn = fn,
+            .context = context,
+            .worker = w,
+            .begin = ListPool_SliceBegin(count, worker_count, w),
+            .end = ListPool_SliceBegin(count, worker_count, w + 1),
+            .started = false,
+        };
+        if (w > 0)
+            slices[w].started = pthread_create(&slices[w].thread, NULL, slice_main, &slices[w]) == 0;
+    }
+
+    for (size_t w = 0; w < worker_count; w++)
+    {
+        if (!slices[w].started)
+            slice_main(&slices[w]);
+    }
+    for (size_t w = 1; w < worker_count; w++)
+    {
+        if (slices[w].started)
+            pthread_join(slices[w].thread, NULL);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef LIST_POOL_H
+#define LIST_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_pool runs a range of independent tasks across a few threads, one
+// contiguous slice of the range per thread, so a large list can be built on
+// every core of the device. Slices are contiguous and in order, which lets the
+// caller merge per-slice results deterministically (e.g. the lowest failing
+// index wins). Keeping it display-free means it can be unit tested with the
+// host compiler (see tests/list_pool_test.c).
+
+// the most threads a pool uses; the supported devices are quad-core
+#define LIST_POOL_MAX_WORKERS 4
+
+// ListPoolSliceFunc handles tasks [begin, end) as the given worker. Slices
+// run concurrently, so it may only touch state that belongs to its worker or
+// its slice.
+typedef void (*ListPoolSliceFunc)(void *context, size_t worker, size_t begin, size_t end);
+
+// ListPool_WorkerCount returns how many workers to split count tasks across:
+// one per online CPU, at most LIST_POOL_MAX_WORKERS, and few enough that every
+// worker gets at least min_per_worker tasks. Small ranges get a single worker,
+// since starting threads would cost more than it saves.
+size_t ListPool_WorkerCount(size_t count, size_t min_per_worker);
+
+// ListPool_SliceBegin returns the first task of a worker's slice. Worker w
+// handles [ListPool_SliceBegin(count, workers, w),
+// ListPool_SliceBegin(count, workers, w + 1)).
+size_t ListPool_SliceBegin(size_t count, size_t worker_count, size_t worker);
+
+// ListPool_Run splits [0, count) into worker_count slices and runs fn on each,
+// returning once every slice is done. The first slice runs on the calling
+// thread. A slice whose thread cannot be started also runs on the calling
+// thread, so every task is handled either way.
+void ListPool_Run(size_t count, size_t worker_count, ListPoolSliceFunc fn, void *context);
+
+#endif // LIST_POOL_H
@@ -0,0 +1,124 @@
+#include "list_range.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+bool ListRange_FormatValid(const char *format)
+{
+    int conversions = 0;
+    for (const char *p = format; *p != '\0'; p++)
+    {
+        if (*p != '%')
+            continue;
+
+        p++;
+        if (*p == '%')
+            continue;
+        while (*p != '\0' && strchr("-+ 0#", *p) != NULL)
+            p++;
+        while (isdigit((unsigned char)*p))
+            p++;
+        if (*p == '.')
+        {
+            p++;
+            while (isdigit((unsigned char)*p))
+                p++;
+        }
+        if (*p != 'd' && *p != 'i')
+            return false;
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+// whole_int reports whether value is a whole number that fits in an int.
+static bool whole_int(double value)
+{
+    return value == floor(value) && value >= INT_MIN && value <= INT_MAX;
+}
+
+bool ListRange_Init(struct ListRange *range, double min, double max, double step, const char *format, char *err, size_t err_size)
+{
+    if (!whole_int(min) || !whole_int(max) || !whole_int(step))
+    {
+        snprintf(err, err_size, "min, max and step must be whole numbers");
+        return false;
+    }
+    if (step <= 0)
+    {
+        snprintf(err, err_size, "step must be greater than 0");
+        return false;
+    }
+    if (max < min)
+    {
+        snprintf(err, err_size, "max must not be less than min");
+        return false;
+    }
+    if (format != NULL && !ListRange_FormatValid(format))
+    {
+        snprintf(err, err_size, "format must contain exactly one %%d");
+        return false;
+    }
+
+    long long count = ((long long)max - (long long)min) / (long long)step + 1;
+    if (count > INT_MAX)
+    {
+        snprintf(err, err_size, "the range has too many values");
+        return false;
+    }
+
+    range->min = (int)min;
+    range->max = (int)max;
+    range->step = (int)step;
+    range->format = format;
+    range->count = (int)count;
+    return true;
+}
+
+int ListRange_Value(const struct ListRange *range, int index)
+{
+    return (int)(range->min + (long long)index * range->step);
+}
+
+const char *ListRange_Format(const struct ListRange *range, int index, char *buf, size_t size)
+{
+    snprintf(buf, size, range->format != NULL ? range->format : "%d", ListRange_Value(range, index));
+    return buf;
+}
+
+int ListRange_Stride(int repeats, int count)
+{
+    if (repeats < LIST_RANGE_ACCEL_REPEATS)
+        return 1;
+
+    int limit = count / 16 > 1 ? count / 16 : 1;
+    int shift = repeats / LIST_RANGE_ACCEL_REPEATS;
+    if (shift > 20)
+        shift = 20;
+    int stride = 1 << shift;
+    return stride < limit ? stride : limit;
+}
+
+int ListRange_Step(int index, int count, int delta)
+{
+    if (count <= 0)
+        return 0;
+
+    int last = count - 1;
+    if (delta > 0)
+    {
+        if (index >= last)
+            return 0;
+        return delta > last - index ? last : index + delta;
+    }
+    if (delta < 0)
+    {
+        if (index <= 0)
+            return last;
+        return -delta > index ? 0 : index + delta;
+    }
+    return index;
+}
@@ -0,0 +1,58 @@
+#ifndef LIST_RANGE_H
+#define LIST_RANGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_range implements numeric range options: an item whose "options" is
+// {"min": 0, "max": 100, "step": 5, "format": "%d%%"} instead of an array of
+// strings. Option i is the value min + i * step, formatted only when it is
+// displayed or written out, so a range costs the same however many values it
+// spans. Holding LEFT or RIGHT on a range steps faster the longer it is held.
+// Keeping it display-free means it can be unit tested with the host compiler
+// (see tests/list_range_test.c).
+
+// the repeats that step one value at a time before a held button speeds up,
+// and the repeats between each doubling of the stride after that
+#define LIST_RANGE_ACCEL_REPEATS 8
+
+struct ListRange
+{
+    int min;
+    int max;
+    int step;
+    // the printf format for a value, with exactly one %d or %i conversion.
+    // NULL formats the plain number.
+    const char *format;
+    // the number of values, from min up to the last one not above max
+    int count;
+};
+
+// ListRange_FormatValid reports whether format is safe to format a value
+// with: exactly one %d or %i conversion (with optional flags, width and
+// precision) and no other conversion except %%.
+bool ListRange_FormatValid(const char *format);
+
+// ListRange_Init fills range from the values of a range spec. min, max and
+// step must be whole numbers, with step positive and max no less than min.
+// format may be NULL. On failure it writes why into err and returns false.
+bool ListRange_Init(struct ListRange *range, double min, double max, double step, const char *format, char *err, size_t err_size);
+
+// ListRange_Value returns the value of option index.
+int ListRange_Value(const struct ListRange *range, int index);
+
+// ListRange_Format writes option index into buf and returns buf.
+const char *ListRange_Format(const struct ListRange *range, int index, char *buf, size_t size);
+
+// ListRange_Stride returns how many values one button repeat moves when a
+// button has been held for repeats repeats, given the number of values. It is
+// one for the first LIST_RANGE_ACCEL_REPEATS repeats and then doubles every
+// LIST_RANGE_ACCEL_REPEATS repeats, up to a sixteenth of the range.
+int ListRange_Stride(int repeats, int count);
+
+// ListRange_Step moves index by delta within [0, count), stopping at the
+// first or last value. Moving past an end wraps around only from the end
+// itself, so a fast held stride lands on the last value before wrapping.
+int ListRange_Step(int index, int count, int delta);
+
+#endif // LIST_RANGE_H
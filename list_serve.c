@@ -0,0 +1,296 @@
+#include "list_serve.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// the Linux-only flags are dropped elsewhere: descriptors are then not
+// close-on-exec, and a server that has gone away raises SIGPIPE
+#ifndef SOCK_CLOEXEC
+#define SOCK_CLOEXEC 0
+#endif
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+
+// identifies a request, and its wire format version
+#define LIST_SERVE_MAGIC 0x4d4c5331u
+
+// RequestHeader starts every request. The descriptors travel with it; the
+// length bytes of NUL-terminated strings that follow are the working
+// directory and then argc arguments.
+struct RequestHeader
+{
+    uint32_t magic;
+    uint32_t argc;
+    uint32_t length;
+};
+
+// socket_address fills address for path, failing when path does not fit.
+static bool socket_address(struct sockaddr_un *address, const char *path)
+{
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address->sun_path))
+        return false;
+    strcpy(address->sun_path, path);
+    return true;
+}
+
+int ListServe_Listen(const char *path)
+{
+    struct sockaddr_un address;
+    if (!socket_address(&address, path))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    // a socket left behind by a server that is gone refuses connections;
+    // one that still accepts them belongs to a running server. Anything at
+    // path other than a socket is never removed.
+    struct stat existing;
+    if (lstat(path, &existing) == 0)
+    {
+        int probe = S_ISSOCK(existing.st_mode) ? ListServe_Connect(path) : -1;
+        if (!S_ISSOCK(existing.st_mode) || probe >= 0)
+        {
+            if (probe >= 0)
+                close(probe);
+            close(fd);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    mode_t mask = umask(0077);
+    int bound = bind(fd, (struct sockaddr *)&address, sizeof(address));
+    umask(mask);
+    if (bound != 0 || listen(fd, 8) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int ListServe_Connect(const char *path)
+{
+    struct sockaddr_un address;
+    if (!socket_address(&address, path))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// write_full sends all size bytes of data, retrying short writes. A peer that
+// has gone away fails the write rather than raising SIGPIPE.
+static bool write_full(int fd, const void *data, size_t size)
+{
+    const char *p = data;
+    while (size > 0)
+    {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// read_full reads exactly size bytes into data.
+static bool read_full(int fd, void *data, size_t size)
+{
+    char *p = data;
+    while (size > 0)
+    {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool ListServe_SendRequest(int fd, int argc, char *const argv[], const char *cwd, const int fds[3])
+{
+    size_t length = strlen(cwd) + 1;
+    for (int i = 0; i < argc; i++)
+        length += strlen(argv[i]) + 1;
+    if (argc < 0 || length > LIST_SERVE_MAX_REQUEST)
+        return false;
+
+    struct RequestHeader header = {LIST_SERVE_MAGIC, (uint32_t)argc, (uint32_t)length};
+    struct iovec iov = {&header, sizeof(header)};
+    union
+    {
+        struct cmsghdr align;
+        char buffer[CMSG_SPACE(sizeof(int) * 3)];
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr message = {0};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * 3);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * 3);
+
+    ssize_t sent;
+    do
+    {
+        sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent <= 0 || !write_full(fd, (char *)&header + sent, sizeof(header) - sent))
+        return false;
+
+    if (!write_full(fd, cwd, strlen(cwd) + 1))
+        return false;
+    for (int i = 0; i < argc; i++)
+    {
+        if (!write_full(fd, argv[i], strlen(argv[i]) + 1))
+            return false;
+    }
+    return true;
+}
+
+// close_fds closes the descriptors a request arrived with.
+static void close_fds(int fds[3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (fds[i] >= 0)
+            close(fds[i]);
+        fds[i] = -1;
+    }
+}
+
+bool ListServe_ReceiveRequest(int fd, struct ListServeRequest *request)
+{
+    memset(request, 0, sizeof(*request));
+    request->fds[0] = request->fds[1] = request->fds[2] = -1;
+
+    struct RequestHeader header;
+    struct iovec iov = {&header, sizeof(header)};
+    union
+    {
+        struct cmsghdr align;
+        char buffer[CMSG_SPACE(sizeof(int) * 3)];
+    } control;
+
+    struct msghdr message = {0};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    ssize_t received;
+    do
+    {
+        received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+    if (received <= 0)
+        return false;
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    if (cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN(sizeof(int) * 3))
+    {
+        memcpy(request->fds, CMSG_DATA(cmsg), sizeof(int) * 3);
+    }
+    else if (cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+    {
+        // the wrong number of descriptors: close whatever arrived
+        int count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        int *received_fds = (int *)CMSG_DATA(cmsg);
+        for (int i = 0; i < count; i++)
+            close(received_fds[i]);
+    }
+
+    bool ok = request->fds[0] >= 0 && (message.msg_flags & MSG_CTRUNC) == 0 &&
+              read_full(fd, (char *)&header + received, sizeof(header) - received) &&
+              header.magic == LIST_SERVE_MAGIC && header.length > 0 && header.length <= LIST_SERVE_MAX_REQUEST &&
+              header.argc < header.length;
+    if (ok)
+    {
+        request->buffer = malloc(header.length);
+        request->argv = malloc(sizeof(char *) * (header.argc + 2));
+        ok = request->buffer != NULL && request->argv != NULL && read_full(fd, request->buffer, header.length) &&
+             request->buffer[header.length - 1] == '\0';
+    }
+    if (ok)
+    {
+        // the strings are the working directory and then each argument
+        request->cwd = request->buffer;
+        request->argv[0] = "minui-list";
+        request->argc = 1;
+        char *p = request->buffer + strlen(request->buffer) + 1;
+        char *end = request->buffer + header.length;
+        while (p < end && request->argc <= (int)header.argc)
+        {
+            request->argv[request->argc++] = p;
+            p += strlen(p) + 1;
+        }
+        request->argv[request->argc] = NULL;
+        ok = p == end && request->argc == (int)header.argc + 1;
+    }
+    if (!ok)
+    {
+        ListServe_FreeRequest(request);
+        return false;
+    }
+    return true;
+}
+
+void ListServe_FreeRequest(struct ListServeRequest *request)
+{
+    close_fds(request->fds);
+    free(request->argv);
+    free(request->buffer);
+    request->argv = NULL;
+    request->buffer = NULL;
+    request->cwd = NULL;
+    request->argc = 0;
+}
+
+bool ListServe_SendExitCode(int fd, int exit_code)
+{
+    int32_t code = exit_code;
+    return write_full(fd, &code, sizeof(code));
+}
+
+bool ListServe_ReceiveExitCode(int fd, int *exit_code)
+{
+    int32_t code;
+    if (!read_full(fd, &code, sizeof(code)))
+        return false;
+    *exit_code = code;
+    return true;
+}
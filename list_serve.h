@@ -0,0 +1,59 @@
+#ifndef LIST_SERVE_H
+#define LIST_SERVE_H
+
+#include <stdbool.h>
+
+// list_serve carries list requests between a resident `minui-list --serve`
+// process and `minui-list --client` invocations over a Unix socket. A request
+// is the client's command-line arguments and working directory, sent along
+// with the client's stdin, stdout and stderr descriptors (SCM_RIGHTS), so the
+// server reads the list and writes its output exactly where the client would
+// have. The reply is the request's exit code. Keeping it display-free means it
+// can be unit tested with the host compiler (see tests/list_serve_test.c).
+
+// the most bytes of arguments and working directory one request may carry
+#define LIST_SERVE_MAX_REQUEST (1024 * 1024)
+
+// ListServeRequest is a request as received by the server.
+struct ListServeRequest
+{
+    // the arguments, with a placeholder program name in argv[0] so they can be
+    // handed to getopt as is. NULL-terminated.
+    int argc;
+    char **argv;
+    // the client's working directory
+    char *cwd;
+    // the client's stdin, stdout and stderr, owned by the request
+    int fds[3];
+    // holds the strings argv and cwd point into
+    char *buffer;
+};
+
+// ListServe_Listen creates the socket at path, replacing a stale one left by
+// a server that did not shut down cleanly, and returns the listening
+// descriptor or -1. The socket is only accessible to the current user.
+int ListServe_Listen(const char *path);
+
+// ListServe_Connect connects to the server at path and returns the
+// descriptor, or -1 when no server is listening there.
+int ListServe_Connect(const char *path);
+
+// ListServe_SendRequest sends argv[0..argc) (argv[0] being the first real
+// argument, not the program name), cwd and the three descriptors in fds.
+bool ListServe_SendRequest(int fd, int argc, char *const argv[], const char *cwd, const int fds[3]);
+
+// ListServe_ReceiveRequest reads one request into request. Returns false for
+// a closed connection or a malformed request; nothing needs freeing then.
+bool ListServe_ReceiveRequest(int fd, struct ListServeRequest *request);
+
+// ListServe_FreeRequest closes the request's descriptors and frees it.
+void ListServe_FreeRequest(struct ListServeRequest *request);
+
+// ListServe_SendExitCode replies to a request with its exit code.
+bool ListServe_SendExitCode(int fd, int exit_code);
+
+// ListServe_ReceiveExitCode waits for the reply to a request. Returns false
+// when the connection closes without one.
+bool ListServe_ReceiveExitCode(int fd, int *exit_code);
+
+#endif // LIST_SERVE_H
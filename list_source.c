@@ -0,0 +1,173 @@
+#include "list_source.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+// the size of each batch of directory entries read with getdents64
+#define LIST_SOURCE_BUFFER_SIZE (32 * 1024)
+
+bool ListSource_ExtensionMatches(const char *name, const char *extensions)
+{
+    if (extensions == NULL || extensions[0] == '\0')
+        return true;
+
+    size_t name_length = strlen(name);
+    const char *p = extensions;
+    while (*p != '\0')
+    {
+        const char *end = strchr(p, ',');
+        if (end == NULL)
+            end = p + strlen(p);
+
+        const char *extension = *p == '.' ? p + 1 : p;
+        size_t length = end - extension;
+        // the name needs something before the dot as well as the extension
+        if (length > 0 && name_length > length + 1 && name[name_length - length - 1] == '.' &&
+            strncasecmp(name + name_length - length, extension, length) == 0)
+        {
+            return true;
+        }
+
+        p = *end == ',' ? end + 1 : end;
+    }
+    return false;
+}
+
+size_t ListSource_StemLength(const char *name)
+{
+    const char *dot = strrchr(name, '.');
+    if (dot == NULL || dot == name)
+        return strlen(name);
+    return dot - name;
+}
+
+bool ListSource_IsResolution(const char *name)
+{
+    const char *p = name;
+    if (!isdigit((unsigned char)*p))
+        return false;
+    while (isdigit((unsigned char)*p))
+        p++;
+    if (*p != 'x')
+        return false;
+    p++;
+    if (!isdigit((unsigned char)*p))
+        return false;
+    while (isdigit((unsigned char)*p))
+        p++;
+    return *p == '\0';
+}
+
+// add_entry keeps one directory entry when it passes the filters. type is the
+// entry's DT_* type, which may be DT_UNKNOWN on filesystems that do not
+// report it; such entries are kept rather than stat'ed.
+static bool add_entry(struct ListSource *source, struct ListArena *arena, const char *name, unsigned char type, const char *extensions, bool dirs_only)
+{
+    if (name[0] == '.')
+        return true;
+    if (dirs_only && type != DT_DIR && type != DT_LNK && type != DT_UNKNOWN)
+        return true;
+    if (!ListSource_ExtensionMatches(name, extensions))
+        return true;
+
+    if (source->count == source->capacity)
+    {
+        size_t capacity = source->capacity > 0 ? source->capacity * 2 : 256;
+        const char **names = realloc(source->names, sizeof(const char *) * capacity);
+        if (names == NULL)
+            return false;
+        source->names = names;
+        source->capacity = capacity;
+    }
+
+    const char *copy = ListArena_Strdup(arena, name);
+    if (copy == NULL)
+        return false;
+    source->names[source->count++] = copy;
+    return true;
+}
+
+#ifdef __linux__
+// linux_dirent64 is the record layout getdents64 fills the buffer with.
+struct linux_dirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+bool ListSource_Read(struct ListSource *source, struct ListArena *arena, const char *path, const char *extensions, bool dirs_only)
+{
+    source->names = NULL;
+    source->count = 0;
+    source->capacity = 0;
+
+    int fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    char *buffer = malloc(LIST_SOURCE_BUFFER_SIZE);
+    bool ok = buffer != NULL;
+    while (ok)
+    {
+        long size = syscall(SYS_getdents64, fd, buffer, LIST_SOURCE_BUFFER_SIZE);
+        if (size <= 0)
+        {
+            ok = size == 0;
+            break;
+        }
+
+        for (long offset = 0; ok && offset < size;)
+        {
+            struct linux_dirent64 *entry = (struct linux_dirent64 *)(buffer + offset);
+            ok = add_entry(source, arena, entry->d_name, entry->d_type, extensions, dirs_only);
+            offset += entry->d_reclen;
+        }
+    }
+
+    free(buffer);
+    close(fd);
+    return ok;
+}
+#else
+bool ListSource_Read(struct ListSource *source, struct ListArena *arena, const char *path, const char *extensions, bool dirs_only)
+{
+    source->names = NULL;
+    source->count = 0;
+    source->capacity = 0;
+
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+        return false;
+
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(dir)) != NULL)
+    {
+        ok = add_entry(source, arena, entry->d_name, entry->d_type, extensions, dirs_only);
+    }
+
+    closedir(dir);
+    return ok;
+}
+#endif
+
+void ListSource_Free(struct ListSource *source)
+{
+    free(source->names);
+    source->names = NULL;
+    source->count = 0;
+    source->capacity = 0;
+}
@@ -0,0 +1,53 @@
+#ifndef LIST_SOURCE_H
+#define LIST_SOURCE_H
+
+#include "list_arena.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_source builds a list straight from a directory for --source-dir, in
+// place of a shell pipeline that lists the directory and reshapes it into
+// JSON. Entries are read in large batches with getdents64 on Linux (readdir
+// elsewhere) and are never stat'ed: the type the directory reports is enough
+// to pick entries, and whether an item's artwork exists is only checked once
+// the item is drawn. Keeping it display-free means it can be unit tested with
+// the host compiler (see tests/list_source_test.c).
+
+// ListSource is the names read from one directory.
+struct ListSource
+{
+    // the entry names, in directory order. The strings live in the arena
+    // passed to ListSource_Read.
+    const char **names;
+    size_t count;
+    size_t capacity;
+};
+
+// ListSource_ExtensionMatches reports whether name ends in one of the
+// comma-separated extensions (e.g. "zip,7z,gb"), compared without regard to
+// case. A leading dot on an extension is optional. A NULL or empty list
+// matches every name.
+bool ListSource_ExtensionMatches(const char *name, const char *extensions);
+
+// ListSource_StemLength returns the length of name without its extension.
+// A name whose only dot is its first character has no extension.
+size_t ListSource_StemLength(const char *name);
+
+// ListSource_IsResolution reports whether name is a "WIDTHxHEIGHT"
+// resolution key such as "1280x720".
+bool ListSource_IsResolution(const char *name);
+
+// ListSource_Read reads the entries of the directory at path into source,
+// copying their names into arena. Hidden entries (names starting with a dot,
+// including "." and "..") are skipped, as are entries that do not match
+// extensions (see ListSource_ExtensionMatches). With dirs_only set, only
+// entries that are or may be directories are kept. Returns false when the
+// directory cannot be read; call ListSource_Free either way.
+bool ListSource_Read(struct ListSource *source, struct ListArena *arena, const char *path, const char *extensions, bool dirs_only);
+
+// ListSource_Free releases the names array. The names themselves belong to
+// the arena.
+void ListSource_Free(struct ListSource *source);
+
+#endif // LIST_SOURCE_H
@@ -0,0 +1,116 @@
+#include "list_timing.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// the report key for each phase, in enum ListTimingPhase order
+static const char *const phase_keys[LIST_TIMING_PHASE_COUNT] = {
+    [LIST_TIMING_ARGUMENTS] = "arguments_ms",
+    [LIST_TIMING_LOAD] = "load_ms",
+    [LIST_TIMING_SORT] = "sort_ms",
+    [LIST_TIMING_INIT] = "init_ms",
+    [LIST_TIMING_IMAGES] = "images_ms",
+    [LIST_TIMING_FONTS] = "fonts_ms",
+    [LIST_TIMING_FIRST_FRAME] = "first_frame_ms",
+};
+
+double ListTiming_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+void ListTiming_Init(struct ListTiming *timing)
+{
+    memset(timing, 0, sizeof(*timing));
+    timing->origin = ListTiming_Now();
+    timing->first_paint = -1;
+}
+
+void ListTiming_Begin(struct ListTiming *timing, enum ListTimingPhase phase)
+{
+    timing->started[phase] = ListTiming_Now();
+}
+
+void ListTiming_End(struct ListTiming *timing, enum ListTimingPhase phase)
+{
+    timing->durations[phase] += ListTiming_Now() - timing->started[phase];
+    timing->recorded[phase] = true;
+}
+
+void ListTiming_Paint(struct ListTiming *timing)
+{
+    if (timing->first_paint < 0)
+        timing->first_paint = ListTiming_Now() - timing->origin;
+}
+
+// append formats one "key":value pair onto buf at *used, with value null when
+// it is not recorded. Returns false once buf is full.
+static bool append(char *buf, size_t size, size_t *used, const char *key, bool recorded, double value)
+{
+    const char *separator = *used > 1 ? "," : "";
+    int n = recorded ? snprintf(buf + *used, size - *used, "%s\"%s\":%.3f", separator, key, value)
+                     : snprintf(buf + *used, size - *used, "%s\"%s\":null", separator, key);
+    if (n < 0 || (size_t)n >= size - *used)
+        return false;
+    *used += n;
+    return true;
+}
+
+bool ListTiming_Format(const struct ListTiming *timing, char *buf, size_t size)
+{
+    if (size < 2)
+        return false;
+
+    buf[0] = '{';
+    buf[1] = '\0';
+    size_t used = 1;
+    for (int phase = 0; phase < LIST_TIMING_PHASE_COUNT; phase++)
+    {
+        if (!append(buf, size, &used, phase_keys[phase], timing->recorded[phase], timing->durations[phase]))
+            return false;
+    }
+    if (!append(buf, size, &used, "first_paint_ms", timing->first_paint >= 0, timing->first_paint))
+        return false;
+    if (used + 2 > size)
+        return false;
+    buf[used++] = '}';
+    buf[used] = '\0';
+    return true;
+}
+
+bool ListTiming_Write(const struct ListTiming *timing, const char *destination)
+{
+    char line[512];
+    if (!ListTiming_Format(timing, line, sizeof(line)))
+        return false;
+    return ListTiming_WriteLine(line, destination);
+}
+
+bool ListTiming_WriteLine(const char *line, const char *destination)
+{
+    char buf[1024];
+    int length = snprintf(buf, sizeof(buf), "%s\n", line);
+    if (length < 0 || (size_t)length >= sizeof(buf))
+        return false;
+
+    if (strcmp(destination, "-") == 0)
+    {
+        fputs(buf, stderr);
+        fflush(stderr);
+        return true;
+    }
+
+    // one write to an O_APPEND file, so lines from launches that overlap do
+    // not interleave
+    int fd = open(destination, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    bool ok = write(fd, buf, length) == (ssize_t)length;
+    close(fd);
+    return ok;
+}
@@ -0,0 +1,85 @@
+#ifndef LIST_TIMING_H
+#define LIST_TIMING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// list_timing records how long each startup phase takes for --timings, so slow
+// launches can be traced to argument parsing, loading the list, sorting it,
+// bringing up the display, resolving images, opening fonts or drawing the
+// first frame. Phases are timed with the monotonic clock and reported as one
+// line of JSON once the first frame is on screen. Keeping it display-free
+// means it can be unit tested with the host compiler (see
+// tests/list_timing_test.c).
+
+// ListTimingPhase is a timed startup phase. The list loads and sorts on a
+// thread of its own while the display comes up and the fonts open, so those
+// phases overlap.
+enum ListTimingPhase
+{
+    // parse_arguments
+    LIST_TIMING_ARGUMENTS,
+    // ListState_New, plus the wait for the first screenful of a
+    // --progressive-load list
+    LIST_TIMING_LOAD,
+    // the --alphabetic-scroll sort
+    LIST_TIMING_SORT,
+    // init(): display, input and power management
+    LIST_TIMING_INIT,
+    // ListState_ResolveImages
+    LIST_TIMING_IMAGES,
+    // open_fonts
+    LIST_TIMING_FONTS,
+    // the first draw_screen and GFX_flip
+    LIST_TIMING_FIRST_FRAME,
+    LIST_TIMING_PHASE_COUNT,
+};
+
+struct ListTiming
+{
+    // when timing started, in milliseconds on the monotonic clock
+    double origin;
+    // the start of each phase that is running
+    double started[LIST_TIMING_PHASE_COUNT];
+    // the time spent in each phase
+    double durations[LIST_TIMING_PHASE_COUNT];
+    // whether each phase has run (a phase that was skipped reports null)
+    bool recorded[LIST_TIMING_PHASE_COUNT];
+    // milliseconds from origin until the first frame was shown, or a
+    // negative value until then
+    double first_paint;
+};
+
+// ListTiming_Now returns the monotonic clock in milliseconds.
+double ListTiming_Now(void);
+
+// ListTiming_Init starts timing from now.
+void ListTiming_Init(struct ListTiming *timing);
+
+// ListTiming_Begin marks the start of phase.
+void ListTiming_Begin(struct ListTiming *timing, enum ListTimingPhase phase);
+
+// ListTiming_End marks the end of phase. A phase that runs more than once
+// adds up its durations.
+void ListTiming_End(struct ListTiming *timing, enum ListTimingPhase phase);
+
+// ListTiming_Paint records the first frame being shown. Later calls are
+// ignored.
+void ListTiming_Paint(struct ListTiming *timing);
+
+// ListTiming_Format writes the report into buf as one line of JSON, e.g.
+// {"arguments_ms":0.042,"load_ms":3.108,"sort_ms":null,...,"first_paint_ms":131.870},
+// without a trailing newline. Returns false when buf is too small.
+bool ListTiming_Format(const struct ListTiming *timing, char *buf, size_t size);
+
+// ListTiming_Write appends the report and a newline to destination: stderr
+// for "-", otherwise the file at that path, which is created if needed, so a
+// file collects one line per launch. Returns false when it cannot be written.
+bool ListTiming_Write(const struct ListTiming *timing, const char *destination);
+
+// ListTiming_WriteLine appends line and a newline to destination the way
+// ListTiming_Write does, for reports made after startup (such as the
+// --filter-index build). Returns false when it cannot be written.
+bool ListTiming_WriteLine(const char *line, const char *destination);
+
+#endif // LIST_TIMING_H
@@ -0,0 +1,205 @@
+#include "list_trigram.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// trigram_bucket hashes the three bytes at text to a bucket.
+static uint32_t trigram_bucket(const char *text)
+{
+    const unsigned char *bytes = (const unsigned char *)text;
+    uint32_t trigram = bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16;
+    return (trigram * 2654435761u) >> (32 - LIST_TRIGRAM_BITS);
+}
+
+bool ListTrigramIndex_Build(struct ListTrigramIndex *index, size_t count, ListTrigramKeyFunc key, void *context)
+{
+    memset(index, 0, sizeof(*index));
+    if (count > UINT32_MAX)
+        return false;
+
+    index->offsets = calloc(LIST_TRIGRAM_BUCKETS + 1, sizeof(uint32_t));
+    // during the count pass, the item (plus one) that last added to a bucket;
+    // during the fill pass, where the bucket's next posting goes
+    uint32_t *cursor = calloc(LIST_TRIGRAM_BUCKETS, sizeof(uint32_t));
+    if (index->offsets == NULL || cursor == NULL)
+    {
+        free(cursor);
+        return false;
+    }
+
+    // count each item once per bucket its trigrams fall in
+    size_t always_count = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t length = 0;
+        bool always = false;
+        const char *text = key(context, i, &length, &always);
+        if (always)
+        {
+            always_count++;
+            continue;
+        }
+        for (size_t j = 0; text != NULL && j + 3 <= length; j++)
+        {
+            uint32_t bucket = trigram_bucket(text + j);
+            if (cursor[bucket] != i + 1)
+            {
+                cursor[bucket] = i + 1;
+                index->offsets[bucket + 1]++;
+            }
+        }
+    }
+
+    size_t total = 0;
+    for (size_t bucket = 0; bucket < LIST_TRIGRAM_BUCKETS; bucket++)
+    {
+        total += index->offsets[bucket + 1];
+        if (total > UINT32_MAX)
+        {
+            free(cursor);
+            return false;
+        }
+        index->offsets[bucket + 1] = total;
+        cursor[bucket] = index->offsets[bucket];
+    }
+
+    index->postings = malloc(sizeof(uint32_t) * (total > 0 ? total : 1));
+    index->always = malloc(sizeof(uint32_t) * (always_count > 0 ? always_count : 1));
+    if (index->postings == NULL || index->always == NULL)
+    {
+        free(cursor);
+        return false;
+    }
+
+    // items are visited in order, so a bucket already holding this item has
+    // it as its last posting
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t length = 0;
+        bool always = false;
+        const char *text = key(context, i, &length, &always);
+        if (always)
+        {
+            index->always[index->always_count++] = i;
+            continue;
+        }
+        for (size_t j = 0; text != NULL && j + 3 <= length; j++)
+        {
+            uint32_t bucket = trigram_bucket(text + j);
+            if (cursor[bucket] == index->offsets[bucket] || index->postings[cursor[bucket] - 1] != i)
+                index->postings[cursor[bucket]++] = i;
+        }
+    }
+
+    free(cursor);
+    index->item_count = count;
+    return true;
+}
+
+size_t ListTrigramIndex_Estimate(const struct ListTrigramIndex *index, const char *query, size_t length)
+{
+    if (index == NULL || index->offsets == NULL || length < 3)
+        return SIZE_MAX;
+
+    size_t shortest = SIZE_MAX;
+    for (size_t j = 0; j + 3 <= length; j++)
+    {
+        uint32_t bucket = trigram_bucket(query + j);
+        size_t postings = index->offsets[bucket + 1] - index->offsets[bucket];
+        if (postings < shortest)
+            shortest = postings;
+    }
+    return shortest + index->always_count;
+}
+
+// seek returns the first position in [position, end) of postings holding an
+// item no lower than item, galloping ahead and then bisecting.
+static uint32_t seek(const uint32_t *postings, uint32_t position, uint32_t end, uint32_t item)
+{
+    uint32_t step = 1;
+    uint32_t low = position;
+    while (position < end && postings[position] < item)
+    {
+        low = position + 1;
+        position = end - position > step ? position + step : end;
+        step *= 2;
+    }
+
+    uint32_t high = position;
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+        if (postings[middle] < item)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+size_t ListTrigramIndex_Candidates(const struct ListTrigramIndex *index, const char *query, size_t length, uint32_t *out)
+{
+    if (index == NULL || index->offsets == NULL || length < 3)
+        return 0;
+
+    // every bucket of the query, and how far each has been searched
+    size_t trigrams = length - 2;
+    uint32_t *buckets = malloc(sizeof(uint32_t) * trigrams * 2);
+    if (buckets == NULL)
+        return SIZE_MAX;
+    uint32_t *positions = buckets + trigrams;
+
+    size_t shortest = 0;
+    for (size_t j = 0; j < trigrams; j++)
+    {
+        buckets[j] = trigram_bucket(query + j);
+        positions[j] = index->offsets[buckets[j]];
+        if (index->offsets[buckets[j] + 1] - positions[j] < index->offsets[buckets[shortest] + 1] - positions[shortest])
+            shortest = j;
+    }
+
+    // walk the shortest posting list, keeping the items every other list
+    // also holds, and merge the always items in between
+    size_t count = 0;
+    size_t always = 0;
+    uint32_t end = index->offsets[buckets[shortest] + 1];
+    for (uint32_t p = index->offsets[buckets[shortest]]; p < end; p++)
+    {
+        uint32_t item = index->postings[p];
+        bool found = true;
+        for (size_t j = 0; j < trigrams && found; j++)
+        {
+            if (j == shortest)
+                continue;
+            uint32_t bucket_end = index->offsets[buckets[j] + 1];
+            positions[j] = seek(index->postings, positions[j], bucket_end, item);
+            found = positions[j] < bucket_end && index->postings[positions[j]] == item;
+        }
+        if (!found)
+            continue;
+
+        while (always < index->always_count && index->always[always] < item)
+            out[count++] = index->always[always++];
+        out[count++] = item;
+    }
+    while (always < index->always_count)
+        out[count++] = index->always[always++];
+
+    free(buckets);
+    return count;
+}
+
+size_t ListTrigramIndex_Bytes(const struct ListTrigramIndex *index)
+{
+    if (index->offsets == NULL)
+        return sizeof(*index);
+    return sizeof(*index) + sizeof(uint32_t) * (LIST_TRIGRAM_BUCKETS + 1 + index->offsets[LIST_TRIGRAM_BUCKETS] + index->always_count);
+}
+
+void ListTrigramIndex_Free(struct ListTrigramIndex *index)
+{
+    free(index->offsets);
+    free(index->postings);
+    free(index->always);
+    memset(index, 0, sizeof(*index));
+}
@@ -0,0 +1,62 @@
+#ifndef LIST_TRIGRAM_H
+#define LIST_TRIGRAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// list_trigram is the optional --filter-index: a trigram index over the
+// items' search keys, so filtering a very large list only verifies the items
+// that contain every three-byte run of the filter instead of scanning them
+// all. Trigrams are hashed into a fixed number of buckets, each holding the
+// ascending indices of the items with a trigram in it. A collision only adds
+// candidates, which the caller verifies anyway. Keeping it display-free means
+// it can be unit tested with the host compiler (see
+// tests/list_trigram_test.c).
+
+// the number of trigram buckets, as a power of two
+#define LIST_TRIGRAM_BITS 16
+#define LIST_TRIGRAM_BUCKETS (1 << LIST_TRIGRAM_BITS)
+
+// ListTrigramKeyFunc returns the search key of item i and its length in
+// bytes. Setting *always makes the item a candidate for every query (a row
+// pinned with display_on_filter).
+typedef const char *(*ListTrigramKeyFunc)(void *context, size_t i, size_t *length, bool *always);
+
+struct ListTrigramIndex
+{
+    // the number of items indexed
+    size_t item_count;
+    // bucket b's items are postings[offsets[b]] to postings[offsets[b + 1]]
+    uint32_t *offsets;
+    uint32_t *postings;
+    // the items that are candidates for every query, ascending
+    uint32_t *always;
+    size_t always_count;
+};
+
+// ListTrigramIndex_Build indexes items [0, count) as returned by key. Returns
+// false when memory runs out; call ListTrigramIndex_Free either way.
+bool ListTrigramIndex_Build(struct ListTrigramIndex *index, size_t count, ListTrigramKeyFunc key, void *context);
+
+// ListTrigramIndex_Estimate returns the most candidates
+// ListTrigramIndex_Candidates can return for the folded query of length
+// bytes, or SIZE_MAX when the query is shorter than a trigram and the index
+// cannot narrow it down.
+size_t ListTrigramIndex_Estimate(const struct ListTrigramIndex *index, const char *query, size_t length);
+
+// ListTrigramIndex_Candidates writes the ascending indices of the items that
+// may contain query to out, which has room for
+// ListTrigramIndex_Estimate(index, query, length) items, and returns how many
+// it wrote, or SIZE_MAX when memory runs out. Every item that contains query
+// is among them, as are the always items; the rest must be verified by the
+// caller.
+size_t ListTrigramIndex_Candidates(const struct ListTrigramIndex *index, const char *query, size_t length, uint32_t *out);
+
+// ListTrigramIndex_Bytes returns the memory the index uses.
+size_t ListTrigramIndex_Bytes(const struct ListTrigramIndex *index);
+
+// ListTrigramIndex_Free releases the index.
+void ListTrigramIndex_Free(struct ListTrigramIndex *index);
+
+#endif // LIST_TRIGRAM_H
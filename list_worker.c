@@ -0,0 +1,108 @@
+#include "list_worker.h"
+
+#include <string.h>
+
+// worker_main runs the latest job whenever one is waiting, until the worker
+// is stopped.
+static void *worker_main(void *arg)
+{
+    struct ListWorker *worker = arg;
+    pthread_mutex_lock(&worker->lock);
+    for (;;)
+    {
+        while (!worker->stopping && (worker->submitted == worker->started || worker->submitted <= worker->cancelled))
+            pthread_cond_wait(&worker->changed, &worker->lock);
+        if (worker->stopping)
+            break;
+
+        unsigned long job = worker->submitted;
+        worker->started = job;
+        worker->busy = true;
+        pthread_mutex_unlock(&worker->lock);
+
+        bool completed = worker->func(worker->context, worker, job);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->busy = false;
+        if (completed)
+            worker->finished = job;
+        pthread_cond_broadcast(&worker->changed);
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return NULL;
+}
+
+bool ListWorker_Start(struct ListWorker *worker, ListWorkerFunc func, void *context)
+{
+    memset(worker, 0, sizeof(*worker));
+    worker->func = func;
+    worker->context = context;
+    pthread_mutex_init(&worker->lock, NULL);
+    pthread_cond_init(&worker->changed, NULL);
+
+    if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0)
+    {
+        pthread_cond_destroy(&worker->changed);
+        pthread_mutex_destroy(&worker->lock);
+        return false;
+    }
+    worker->running = true;
+    return true;
+}
+
+unsigned long ListWorker_Submit(struct ListWorker *worker)
+{
+    pthread_mutex_lock(&worker->lock);
+    unsigned long job = ++worker->submitted;
+    pthread_cond_broadcast(&worker->changed);
+    pthread_mutex_unlock(&worker->lock);
+    return job;
+}
+
+void ListWorker_Cancel(struct ListWorker *worker)
+{
+    pthread_mutex_lock(&worker->lock);
+    worker->cancelled = worker->submitted;
+    pthread_cond_broadcast(&worker->changed);
+    pthread_mutex_unlock(&worker->lock);
+}
+
+bool ListWorker_Cancelled(struct ListWorker *worker, unsigned long job)
+{
+    pthread_mutex_lock(&worker->lock);
+    bool cancelled = worker->stopping || job != worker->submitted || job <= worker->cancelled;
+    pthread_mutex_unlock(&worker->lock);
+    return cancelled;
+}
+
+bool ListWorker_Finished(struct ListWorker *worker, unsigned long job)
+{
+    pthread_mutex_lock(&worker->lock);
+    bool finished = worker->finished == job;
+    pthread_mutex_unlock(&worker->lock);
+    return finished;
+}
+
+void ListWorker_Wait(struct ListWorker *worker)
+{
+    pthread_mutex_lock(&worker->lock);
+    while (worker->busy || (worker->submitted != worker->started && worker->submitted > worker->cancelled))
+        pthread_cond_wait(&worker->changed, &worker->lock);
+    pthread_mutex_unlock(&worker->lock);
+}
+
+void ListWorker_Stop(struct ListWorker *worker)
+{
+    if (!worker->running)
+        return;
+
+    pthread_mutex_lock(&worker->lock);
+    worker->stopping = true;
+    pthread_cond_broadcast(&worker->changed);
+    pthread_mutex_unlock(&worker->lock);
+    pthread_join(worker->thread, NULL);
+    worker->running = false;
+
+    pthread_cond_destroy(&worker->changed);
+    pthread_mutex_destroy(&worker->lock);
+}
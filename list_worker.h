@@ -0,0 +1,76 @@
+#ifndef LIST_WORKER_H
+#define LIST_WORKER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+// list_worker runs one job at a time on a background thread, for work the UI
+// thread must not wait on, such as filtering a very long list while the user
+// types. Submitting a job supersedes the one in flight, which notices with
+// ListWorker_Cancelled and gives up early; the UI thread then picks up the
+// result of the latest job once it is done. Job input and output live with
+// the caller: the UI thread only touches them while the worker is idle (see
+// ListWorker_Wait), and the lock taken by every call orders those accesses
+// with the worker's. Keeping it display-free means it can be unit tested with
+// the host compiler (see tests/list_worker_test.c).
+
+struct ListWorker;
+
+// ListWorkerFunc runs job number job for context. It should call
+// ListWorker_Cancelled every so often and return false as soon as it reports
+// true; it returns true when the job ran to completion.
+typedef bool (*ListWorkerFunc)(void *context, struct ListWorker *worker, unsigned long job);
+
+struct ListWorker
+{
+    pthread_t thread;
+    // guards every field below
+    pthread_mutex_t lock;
+    // signalled when a job is submitted or cancelled, a job ends, or the
+    // worker is stopped
+    pthread_cond_t changed;
+    ListWorkerFunc func;
+    void *context;
+    // whether the thread was started and has not been joined yet
+    bool running;
+    // whether the thread has been asked to exit
+    bool stopping;
+    // the number of the latest job submitted (0 before the first)
+    unsigned long submitted;
+    // jobs up to this number are cancelled
+    unsigned long cancelled;
+    // the job the thread is running or ran last
+    unsigned long started;
+    // the last job that ran to completion
+    unsigned long finished;
+    // whether the thread is running a job
+    bool busy;
+};
+
+// ListWorker_Start starts the worker thread, which runs func(context, ...)
+// for each job submitted. Returns false if the thread could not be started.
+bool ListWorker_Start(struct ListWorker *worker, ListWorkerFunc func, void *context);
+
+// ListWorker_Submit queues a new job, cancelling any earlier one, and returns
+// its number.
+unsigned long ListWorker_Submit(struct ListWorker *worker);
+
+// ListWorker_Cancel cancels every job submitted so far.
+void ListWorker_Cancel(struct ListWorker *worker);
+
+// ListWorker_Cancelled reports whether job has been superseded or cancelled,
+// or the worker is stopping.
+bool ListWorker_Cancelled(struct ListWorker *worker, unsigned long job);
+
+// ListWorker_Finished reports whether job ran to completion.
+bool ListWorker_Finished(struct ListWorker *worker, unsigned long job);
+
+// ListWorker_Wait blocks until the worker has no job running and none left to
+// run.
+void ListWorker_Wait(struct ListWorker *worker);
+
+// ListWorker_Stop cancels any job, waits for the thread to exit and releases
+// the worker.
+void ListWorker_Stop(struct ListWorker *worker);
+
+#endif // LIST_WORKER_H
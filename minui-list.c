@@ -1,13 +1,17 @@
 #include <ctype.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <limits.h>
 #include <msettings.h>
 #include <parson/parson.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <strings.h>
+#include <sys/socket.h>
 #include <unistd.h>
 #ifdef USE_SDL2
 #include <SDL2/SDL_ttf.h>
@@ -19,13 +23,28 @@
 #include "api.h"
 #include "utils.h"
 
+#include "list_arena.h"
+#include "list_cache.h"
+#include "list_columns.h"
 #include "list_filter.h"
 #include "list_hint.h"
 #include "list_image.h"
+#include "list_input.h"
+#include "list_json.h"
 #include "list_keyboard.h"
+#include "list_keypath.h"
+#include "list_loader.h"
 #include "list_nav.h"
+#include "list_options.h"
+#include "list_pool.h"
+#include "list_range.h"
 #include "list_scroll.h"
+#include "list_serve.h"
+#include "list_source.h"
 #include "list_theme.h"
+#include "list_timing.h"
+#include "list_trigram.h"
+#include "list_worker.h"
 
 // the largest image column width is a third of the screen width, per issue #13
 #define IMAGE_MAX_WIDTH_DIVISOR 3
@@ -216,12 +235,46 @@ typedef int ExitCode;
 
 #define OPTION_PADDING 8
 
+// log_capture, when set, receives a copy of every message passed to
+// log_error, so the warnings printed while loading a list can be stored in its
+// --cache-dir cache and printed again whenever the cache is used. It belongs
+// to the thread loading the list, so messages other threads log meanwhile are
+// not stored with the list's warnings.
+static __thread struct ListCacheWriter *log_capture = NULL;
+static __thread uint32_t log_capture_count = 0;
+
+// log_lock is held while a message is printed, and by
+// swallow_stdout_from_function while stderr points at /dev/null, so messages
+// logged on another thread meanwhile wait to be printed instead of being lost.
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// log_deferred, when set, collects this thread's messages instead of printing
+// them. Items built on worker threads log through it, and the messages are
+// printed afterwards in item order (see ListState_LoadItems).
+static __thread struct ListCacheWriter *log_deferred = NULL;
+
 // log_error logs a message to stderr for debugging purposes
 void log_error(const char *msg)
 {
+    if (log_deferred != NULL)
+    {
+        ListCacheWriter_PutString(log_deferred, msg);
+        return;
+    }
+
+    pthread_mutex_lock(&log_lock);
+
     // Set stderr to unbuffered mode
     setvbuf(stderr, NULL, _IONBF, 0);
     fprintf(stderr, "%s\n", msg);
+
+    if (log_capture != NULL)
+    {
+        ListCacheWriter_PutString(log_capture, msg);
+        log_capture_count++;
+    }
+
+    pthread_mutex_unlock(&log_lock);
 }
 
 // log_info logs a message to stdout for debugging purposes
@@ -232,74 +285,163 @@ void log_info(const char *msg)
     printf("%s\n", msg);
 }
 
+// ListItemAlignment is the horizontal alignment of an item's text
+enum ListItemAlignment
+{
+    ALIGNMENT_LEFT,
+    ALIGNMENT_CENTER,
+    ALIGNMENT_RIGHT,
+};
+
+// ListItemAlignment_Name returns the JSON spelling of an alignment
+static const char *ListItemAlignment_Name(enum ListItemAlignment alignment)
+{
+    switch (alignment)
+    {
+    case ALIGNMENT_CENTER:
+        return "center";
+    case ALIGNMENT_RIGHT:
+        return "right";
+    default:
+        return "left";
+    }
+}
+
+// ListItemFeature holds an item's per-item features. Strings are shared rather
+// than copied: they point at the list-wide defaults in AppState or at a single
+// copy in the list's arena. Booleans are packed into bits, so the whole struct
+// is a few words per item.
 struct ListItemFeature
 {
     // the background color to use for the list
-    char background_color[1024];
+    const char *background_color;
     // path to the background image to use for the list
-    char background_image[1024];
-    // whether the background image exists
-    bool background_image_exists;
-    // whether the item can be disabled
-    bool can_disable;
+    const char *background_image;
     // the confirm text to display on the confirm button
-    char confirm_text[1024];
+    const char *confirm_text;
+    // alignment of the item text
+    enum ListItemAlignment alignment;
+
+    // whether the background image is known to exist. Checked on first touch
+    // by ListItem_BackgroundImageExists rather than when the item is built.
+    bool background_image_exists : 1;
+    // whether the item can be disabled
+    bool can_disable : 1;
     // whether the item is disabled
-    bool disabled;
+    bool disabled : 1;
     // whether to draw arrows around the item
-    bool draw_arrows;
+    bool draw_arrows : 1;
     // whether to hide the action button when the item is selected
-    bool hide_action;
+    bool hide_action : 1;
     // whether to hide the cancel button when the item is selected
-    bool hide_cancel;
+    bool hide_cancel : 1;
     // whether to hide the confirm button when the item is selected
-    bool hide_confirm;
+    bool hide_confirm : 1;
     // whether to show the confirm button when the default option is selected
-    bool show_confirm;
+    bool show_confirm : 1;
     // whether or not the item is a header
-    bool is_header;
+    bool is_header : 1;
     // whether or not the item is unselectable
-    bool unselectable;
+    bool unselectable : 1;
     // whether the item stays visible even when it does not match an active filter
-    bool display_on_filter;
-    // alignment of the item text ('left', 'center', 'right')
-    char alignment[1024];
+    bool display_on_filter : 1;
 
     // whether the item has a background_color field
-    bool has_background_color;
+    bool has_background_color : 1;
     // whether the item has a background_image field
-    bool has_background_image;
+    bool has_background_image : 1;
     // whether the item has a can_disable field
-    bool has_can_disable;
+    bool has_can_disable : 1;
     // whether the item has a confirm_text field
-    bool has_confirm_text;
+    bool has_confirm_text : 1;
     // whether the item has a disabled field
-    bool has_disabled;
+    bool has_disabled : 1;
     // whether the item has a draw_arrows field
-    bool has_draw_arrows;
+    bool has_draw_arrows : 1;
     // whether the item has a hide_action field
-    bool has_hide_action;
+    bool has_hide_action : 1;
     // whether the item has a hide_cancel field
-    bool has_hide_cancel;
+    bool has_hide_cancel : 1;
     // whether the item has a hide_confirm field
-    bool has_hide_confirm;
+    bool has_hide_confirm : 1;
     // whether the item has a show_confirm field
-    bool has_show_confirm;
+    bool has_show_confirm : 1;
     // whether the item has a is_header field
-    bool has_is_header;
+    bool has_is_header : 1;
     // whether the item has a unselectable field
-    bool has_unselectable;
+    bool has_unselectable : 1;
     // whether the item has a display_on_filter field
-    bool has_display_on_filter;
+    bool has_display_on_filter : 1;
     // whether the item has a alignment field
-    bool has_alignment;
+    bool has_alignment : 1;
 };
 
+// LIST_ITEM_FEATURE_FLAGS lists every boolean feature in a fixed order, so the
+// list cache can pack them into one word without addressing the bitfields.
+// Append new flags at the end and bump LIST_CACHE_VERSION.
+#define LIST_ITEM_FEATURE_FLAGS(X) \
+    X(background_image_exists)     \
+    X(can_disable)                 \
+    X(disabled)                    \
+    X(draw_arrows)                 \
+    X(hide_action)                 \
+    X(hide_cancel)                 \
+    X(hide_confirm)                \
+    X(show_confirm)                \
+    X(is_header)                   \
+    X(unselectable)                \
+    X(display_on_filter)           \
+    X(has_background_color)        \
+    X(has_background_image)        \
+    X(has_can_disable)             \
+    X(has_confirm_text)            \
+    X(has_disabled)                \
+    X(has_draw_arrows)             \
+    X(has_hide_action)             \
+    X(has_hide_cancel)             \
+    X(has_hide_confirm)            \
+    X(has_show_confirm)            \
+    X(has_is_header)               \
+    X(has_unselectable)            \
+    X(has_display_on_filter)       \
+    X(has_alignment)
+
+// ListItemFeature_PackFlags returns the feature's boolean fields as bits, in
+// LIST_ITEM_FEATURE_FLAGS order.
+static uint32_t ListItemFeature_PackFlags(const struct ListItemFeature *features)
+{
+    uint32_t flags = 0;
+    int bit = 0;
+#define PACK_FLAG(field)                                 \
+    flags |= (uint32_t)(features->field ? 1 : 0) << bit; \
+    bit++;
+    LIST_ITEM_FEATURE_FLAGS(PACK_FLAG)
+#undef PACK_FLAG
+    return flags;
+}
+
+// ListItemFeature_UnpackFlags sets the feature's boolean fields from bits
+// produced by ListItemFeature_PackFlags.
+static void ListItemFeature_UnpackFlags(struct ListItemFeature *features, uint32_t flags)
+{
+    int bit = 0;
+#define UNPACK_FLAG(field)                       \
+    features->field = ((flags >> bit) & 1) != 0; \
+    bit++;
+    LIST_ITEM_FEATURE_FLAGS(UNPACK_FLAG)
+#undef UNPACK_FLAG
+}
+
 // ListItem holds the configuration for a list item
 struct ListItem
 {
     // the name of the item
     char *name;
+    // the name case-folded for filtering (see ListFilter_Fold), or the name
+    // itself when folding leaves it unchanged. NULL until the item's row is
+    // first indexed.
+    const char *search_key;
+    uint32_t search_key_length;
     // whether the item has features
     bool has_features;
     // whether the item has options field
@@ -308,8 +450,12 @@ struct ListItem
     bool has_selected;
     // the number of options for the item
     int option_count;
-    // a list of char options for the item
-    char **options;
+    // the item's options: a shared array interned by list_options, so items
+    // with the same options point at one copy. Never modified.
+    const char **options;
+    // the item's numeric range when its options are a range spec rather than
+    // an array (options is then NULL); see ListItem_Option
+    const struct ListRange *range;
     // the selected option index
     int selected;
     // the initial selected option index
@@ -320,20 +466,71 @@ struct ListItem
     // whether the item specifies a right-hand-side image (image/images, in the
     // item object or under features)
     bool has_image;
-    // the per-resolution image variants (heap array sized to image_variant_count)
+    // the per-resolution image variants (arena array sized to image_variant_count)
     struct ImageVariant *image_variants;
     // the number of image variants
     int image_variant_count;
 
     // the image path selected for the active screen resolution, fixed for the
-    // run (empty when no variant matches and there is no "default")
-    char resolved_path[1024];
-    // the path image_surface was loaded from (empty when nothing is cached)
-    char image_active_path[1024];
+    // run (empty when no variant matches and there is no "default"). Points at
+    // one of image_variants' paths. NULL until the item is first drawn; see
+    // ListItem_ResolvedPath.
+    const char *resolved_path;
+    // the path image_surface was loaded from (empty when nothing is cached).
+    // Points at resolved_path or the --fallback-image value, both of which
+    // live for the run.
+    const char *image_active_path;
     // the cached, pre-scaled image surface (NULL when nothing is loaded)
     SDL_Surface *image_surface;
 };
 
+// ListRowFlag marks the per-item properties read by the navigation and filter
+// scans, packed into one byte of the item's ListRow.
+enum ListRowFlag
+{
+    // the item is a header or unselectable, so selection skips over it
+    LIST_ROW_SKIP = 1 << 0,
+    // the item is a header, which drops out while a filter is active
+    LIST_ROW_HEADER = 1 << 1,
+    // the item stays visible while a filter is active (display_on_filter)
+    LIST_ROW_PINNED = 1 << 2,
+};
+
+// ListRow is the hot part of a list item: just what the per-keystroke filter
+// scan and the UP/DOWN skip loops touch. Rows are kept in a dense array
+// parallel to items so those scans walk a few bytes per item instead of
+// striding over whole ListItems.
+struct ListRow
+{
+    // the item's search key (same pointer as ListItem.search_key)
+    const char *key;
+    uint32_t key_length;
+    // ListRowFlag bits
+    unsigned char flags;
+};
+
+// ListFilterJob is a filter pass handed to the filter worker (see
+// ListState_ApplyFilter). The UI thread fills it in before submitting it and
+// reads the result once the worker has finished it.
+struct ListFilterJob
+{
+    // the query to match
+    struct ListFilterQuery query;
+    // the source indices to match (the view being narrowed), then the items
+    // from index first on
+    const int *from;
+    int from_count;
+    size_t first;
+    // whether the result narrows the view shown when the pass was submitted
+    bool narrows;
+    // the worker's job number (0 when no pass is in flight)
+    unsigned long id;
+    // the matching source indices, in display order (NULL if the pass ran out
+    // of memory)
+    int *visible;
+    int visible_count;
+};
+
 // ListState holds the state of the list
 struct ListState
 {
@@ -341,6 +538,8 @@ struct ListState
     struct ListItem *items;
     // number of items in the list
     size_t item_count;
+    // the hot per-item data, parallel to items (see ListState_IndexRows)
+    struct ListRow *rows;
 
     // the filtered view: visible[k] is the source index of the k-th visible item.
     // With no active filter this is the identity (visible[k] == k) and
@@ -350,6 +549,22 @@ struct ListState
     int *visible;
     // number of currently visible items (length of the meaningful prefix of visible)
     int visible_count;
+    // the query visible was filtered with (empty when no filter is active)
+    struct ListFilterQuery filter_query;
+    // how filter_query matches (--filter-mode); a fuzzy query orders visible
+    // best match first (see ListState_Rank)
+    enum ListFilterMode filter_mode;
+    // the result sets of the shorter queries the filter narrowed from, for
+    // backspace (see ListState_ApplyFilter)
+    struct ListFilterHistory filter_history;
+    // the --filter-index trigram index over the rows (NULL until the filter
+    // keyboard first opens; see ListState_BuildIndex)
+    struct ListTrigramIndex *filter_index;
+    // matches queries on big lists off the UI thread (started on first use;
+    // see ListState_ApplyFilter)
+    struct ListWorker filter_worker;
+    // the pass filter_worker is running, if any
+    struct ListFilterJob filter_job;
 
     // rendering state
     // display position of the first visible row
@@ -361,6 +576,48 @@ struct ListState
 
     // whether or not any items in the list have options
     bool has_options;
+
+    // allocated length of items
+    size_t item_capacity;
+    // the loaded input; text-format item names point into its buffer, so it
+    // lives as long as the list
+    struct ListInput input;
+    // owns every other per-item allocation (names, options, image variants)
+    struct ListArena arena;
+
+    // the settings read from the root JSON object, kept so a --cache-dir
+    // cache can apply them again without the JSON
+    // whether the root object turned on alphabetic_scroll
+    bool root_alphabetic_scroll;
+    // the root object's scroll_method (NULL when absent)
+    const char *root_scroll_method;
+
+    // the background loader for --progressive-load (NULL when the list was
+    // loaded up front). Item names point into its arena, so it lives as long
+    // as the list.
+    struct ListLoader *loader;
+    // whether the loader is still reading; items keep arriving until it clears
+    bool loading;
+    // whether the loader's lines are jsonl items rather than text names, and
+    // how many lines have been taken from it so far (blank ones included)
+    bool load_jsonl;
+    size_t load_line;
+    // a batch of lines taken from the loader but not added yet, because there
+    // was no memory for it (see ListState_PollLoader), and whether it was the
+    // last one
+    const char **load_held;
+    size_t load_held_count;
+    bool load_held_done;
+    // the option arrays of jsonl items, shared like ListState_LoadItems does
+    struct ListOptionTables load_option_tables;
+    // the defaults for items that arrive after ListState_New returns
+    const char *load_confirm_text;
+    const char *load_background_image;
+    const char *load_background_color;
+
+    // the resolution key image variants are selected by, set once by
+    // ListState_ResolveImages
+    char image_resolution[32];
 };
 
 // Fonts holds the fonts for the list
@@ -392,6 +649,9 @@ struct AppState
     // which hardware settings overlay to show, matching the MinUI SDK
     // convention written back by PWR_update: 0 = none, 1 = brightness, 2 = volume
     int show_brightness_setting;
+    // how many times LEFT or RIGHT has repeated since it was pressed, which
+    // speeds up stepping through range options
+    int option_repeats;
     // the button to display on the Action button
     char action_button[1024];
     // the text to display on the Action button
@@ -400,6 +660,29 @@ struct AppState
     char background_image[1024];
     // the background color to display
     char background_color[1024];
+    // a directory for binary caches of JSON lists (empty means no caching)
+    char cache_dir[1024];
+    // whether text lists are read on a background thread and drawn while
+    // they are still loading
+    bool progressive_load;
+    // a directory whose entries become the list (empty means --file is read)
+    char source_dir[1024];
+    // the comma-separated extensions --source-dir entries must have (empty
+    // keeps every entry)
+    char source_extensions[1024];
+    // a directory of <name without extension>.png artwork for --source-dir
+    // items, with optional WIDTHxHEIGHT subdirectories (empty means no images)
+    char source_image_dir[1024];
+    // where --timings writes the startup report ("-" for stderr, empty for
+    // no report)
+    char timings[1024];
+    // the startup phase timings, reported once the first frame is shown
+    struct ListTiming timing;
+    // the socket a --serve server listens on (empty when not serving)
+    char serve_socket[1024];
+    // the socket of the --serve server that --client hands the list to (empty
+    // shows the list from this process)
+    char client_socket[1024];
     // the screen resolution ("WIDTHxHEIGHT") used to pick per-item images from
     // an "images" map; empty means auto-detect from the device resolution
     char screen_resolution[32];
@@ -430,6 +713,10 @@ struct AppState
     char filter_input[1024];
     // a file path to also write the filter value to on exit (empty = none)
     char filter_text_file[1024];
+    // whether the filter keyboard builds a trigram index over the items
+    bool filter_index;
+    // how the filter matches names: "substring" or "fuzzy"
+    char filter_mode[1024];
     // whether the filter keyboard is currently shown
     bool filter_keyboard_active;
     // the current filter text being typed / applied
@@ -503,82 +790,6 @@ bool has_left_button_group(struct AppState *app_state, struct ListState *list_st
     return true;
 }
 
-char *read_stdin()
-{
-    // Read all of stdin into a string
-    char *stdin_contents = NULL;
-    size_t stdin_size = 0;
-    size_t stdin_used = 0;
-    char buffer[4096];
-    size_t bytes_read;
-
-    while ((bytes_read = fread(buffer, 1, sizeof(buffer), stdin)) > 0)
-    {
-        if (stdin_contents == NULL)
-        {
-            stdin_size = bytes_read * 2;
-            stdin_contents = malloc(stdin_size);
-        }
-        else if (stdin_used + bytes_read > stdin_size)
-        {
-            stdin_size *= 2;
-            stdin_contents = realloc(stdin_contents, stdin_size);
-        }
-
-        memcpy(stdin_contents + stdin_used, buffer, bytes_read);
-        stdin_used += bytes_read;
-    }
-
-    // Null terminate the string
-    if (stdin_contents)
-    {
-        if (stdin_used == stdin_size)
-        {
-            stdin_contents = realloc(stdin_contents, stdin_size + 1);
-        }
-        stdin_contents[stdin_used] = '\0';
-    }
-
-    return stdin_contents;
-}
-
-char *read_file(const char *filename)
-{
-    FILE *file = fopen(filename, "r");
-    if (!file)
-    {
-        return NULL;
-    }
-
-    // Get file size
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    // Allocate buffer with extra byte for null terminator
-    char *contents = malloc(file_size + 1);
-    if (!contents)
-    {
-        fclose(file);
-        return NULL;
-    }
-
-    // Read file contents
-    size_t bytes_read = fread(contents, 1, file_size, file);
-    fclose(file);
-
-    if (bytes_read != file_size)
-    {
-        free(contents);
-        return NULL;
-    }
-
-    // Add null terminator
-    contents[file_size] = '\0';
-
-    return contents;
-}
-
 // compare_items_alphabetic compares ListItem structs by name (case-insensitive)
 static int compare_items_alphabetic(const void *a, const void *b)
 {
@@ -632,16 +843,16 @@ static void ListItem_InitImage(struct ListItem *item)
     item->has_image = false;
     item->image_variants = NULL;
     item->image_variant_count = 0;
-    item->resolved_path[0] = '\0';
-    item->image_active_path[0] = '\0';
+    item->resolved_path = NULL;
+    item->image_active_path = "";
     item->image_surface = NULL;
 }
 
 // ListItem_UpsertVariant sets or replaces the path for a resolution key in the
-// item's variant array, growing it as needed (mirroring the options heap array).
-// Empty resolutions or paths are ignored, so callers can pass optional keys
-// directly.
-static void ListItem_UpsertVariant(struct ListItem *item, const char *resolution, const char *path)
+// item's variant array. The caller reserves room for the new entry up front
+// (the array lives in the list's arena and cannot grow in place). Empty
+// resolutions or paths are ignored, so callers can pass optional keys directly.
+static void ListItem_UpsertVariant(struct ListItem *item, struct ListArena *arena, const char *resolution, const char *path)
 {
     if (resolution == NULL || resolution[0] == '\0' || path == NULL || path[0] == '\0')
         return;
@@ -650,28 +861,22 @@ static void ListItem_UpsertVariant(struct ListItem *item, const char *resolution
     {
         if (strcmp(item->image_variants[k].resolution, resolution) == 0)
         {
-            strncpy(item->image_variants[k].path, path, sizeof(item->image_variants[k].path) - 1);
-            item->image_variants[k].path[sizeof(item->image_variants[k].path) - 1] = '\0';
+            item->image_variants[k].path = ListArena_Strdup(arena, path);
             return;
         }
     }
 
-    struct ImageVariant *grown = realloc(item->image_variants, sizeof(struct ImageVariant) * (item->image_variant_count + 1));
-    if (grown == NULL)
-        return;
-    item->image_variants = grown;
-
     struct ImageVariant *variant = &item->image_variants[item->image_variant_count];
-    memset(variant, 0, sizeof(*variant));
-    strncpy(variant->resolution, resolution, sizeof(variant->resolution) - 1);
-    strncpy(variant->path, path, sizeof(variant->path) - 1);
+    variant->resolution = ListArena_Strdup(arena, resolution);
+    variant->path = ListArena_Strdup(arena, path);
     item->image_variant_count++;
 }
 
 // ListItem_ReadImages reads the optional "images" map from an item's "features"
 // object into the item's variant array. Keys are resolution strings ("default"
 // or "WIDTHxHEIGHT"); the "default" entry is used when no exact match is found.
-static void ListItem_ReadImages(struct ListItem *item, JSON_Object *features)
+// The variant array is allocated from the list's arena at its final size.
+static void ListItem_ReadImages(struct ListItem *item, JSON_Object *features, struct ListArena *arena)
 {
     if (features == NULL)
         return;
@@ -681,952 +886,2566 @@ static void ListItem_ReadImages(struct ListItem *item, JSON_Object *features)
         return;
 
     size_t images_count = json_object_get_count(images);
+    if (images_count == 0)
+        return;
+
+    item->image_variants = ListArena_Alloc(arena, sizeof(struct ImageVariant) * images_count);
+    if (item->image_variants == NULL)
+        return;
+
     for (size_t k = 0; k < images_count; k++)
     {
         const char *resolution = json_object_get_name(images, k);
         const char *path = json_value_get_string(json_object_get_value_at(images, k));
-        ListItem_UpsertVariant(item, resolution, path);
+        ListItem_UpsertVariant(item, arena, resolution, path);
     }
 }
 
-// ListState_New creates a new ListState from a JSON file
-// ListState_InitVisibleIdentity allocates the filtered-view index and sets it to
-// the identity mapping (every item visible, in source order) so an unfiltered
-// list behaves exactly as it did before filtering existed.
-static void ListState_InitVisibleIdentity(struct ListState *state)
+// ListItem_InitDefaults resets a list item to a plain row: the given name, no
+// options, no per-item features, left alignment and the default confirm text
+// (shared, not copied).
+// Backgrounds are left empty; callers apply the list-wide defaults with
+// ListItem_SetDefaultBackground or read them from the item's features.
+static void ListItem_InitDefaults(struct ListItem *item, char *name, const char *confirm_text)
 {
-    size_t n = state->item_count > 0 ? state->item_count : 1;
-    state->visible = malloc(sizeof(int) * n);
-    state->visible_count = (int)state->item_count;
-    for (size_t i = 0; i < state->item_count; i++)
+    item->name = name;
+    item->search_key = NULL;
+    item->search_key_length = 0;
+    item->has_features = false;
+    item->has_options = false;
+    item->has_selected = false;
+    item->option_count = 0;
+    item->options = NULL;
+    item->range = NULL;
+    item->selected = 0;
+    item->initial_selected = 0;
+    ListItem_InitImage(item);
+    item->features = (struct ListItemFeature){
+        .background_color = "",
+        .background_image = "",
+        .confirm_text = confirm_text,
+        .alignment = ALIGNMENT_LEFT,
+    };
+}
+
+// ListItem_Option returns the text of option index: the shared string for
+// array options, or the range value formatted into buf (of size bytes).
+static const char *ListItem_Option(const struct ListItem *item, int index, char *buf, size_t size)
+{
+    if (item->range != NULL)
     {
-        state->visible[i] = (int)i;
+        return ListRange_Format(item->range, index, buf, size);
     }
+    return item->options[index];
 }
 
-struct ListState *ListState_New(const char *filename, const char *format, const char *item_key, const char *confirm_text, const char *default_background_image, const char *default_background_color, struct AppState *app_state)
+// ListItem_SetDefaultBackground points an item's features at the
+// --background-image and --background-color defaults.
+static void ListItem_SetDefaultBackground(struct ListItem *item, const char *default_background_image, const char *default_background_color)
 {
-    struct ListState *state = malloc(sizeof(struct ListState));
-    state->selected = -1;
-    state->first_visible = 0;
-    state->last_visible = 0;
-    state->visible = NULL;
-    state->visible_count = 0;
+    if (default_background_image != NULL)
+    {
+        item->features.background_image = default_background_image;
+    }
+    if (default_background_color != NULL)
+    {
+        item->features.background_color = default_background_color;
+    }
+}
 
-    if (strcmp(format, "text") == 0)
+// shared_string returns shared when value has the same contents, so an item
+// that repeats a list-wide default points at it instead of storing a copy, and
+// otherwise copies value into the arena.
+static const char *shared_string(struct ListArena *arena, const char *value, const char *shared)
+{
+    if (shared != NULL && strcmp(value, shared) == 0)
     {
-        char *contents = NULL;
-        if (strcmp(filename, "-") == 0)
+        return shared;
+    }
+    return ListArena_Strdup(arena, value);
+}
+
+// ListItem_ReadFeatures reads an item's "features" object into item->features,
+// falling back to the list-wide background defaults for keys it does not set.
+// Warnings for out-of-range values are logged and the value is corrected.
+static void ListItem_ReadFeatures(struct ListItem *item, struct ListArena *arena, JSON_Object *features, const char *default_background_image, const char *default_background_color)
+{
+    // read in the background_image from the json object
+    // if there is no background_image, set it to ""
+    // if there is a background_image, treat it as a string
+    const char *background_image = json_object_get_string(features, "background_image");
+    if (background_image != NULL)
+    {
+        item->features.background_image = shared_string(arena, background_image, default_background_image);
+        item->features.has_background_image = true;
+    }
+    else
+    {
+        if (default_background_image != NULL)
         {
-            contents = read_stdin();
+            item->features.background_image = default_background_image;
+            item->features.has_background_image = true;
         }
         else
         {
-            contents = read_file(filename);
-        }
-
-        if (contents == NULL)
-        {
-            log_error("Failed to read file or stdin");
-            free(state);
-            return NULL;
+            item->features.has_background_image = false;
         }
+    }
 
-        // Count number of non-empty lines
-        size_t item_count = 0;
-        char *line_start = contents;
-        while (*line_start != '\0')
+    // read in the background_color from the json object
+    // if there is no background_color, set it to ""
+    // if there is a background_color, treat it as a string
+    const char *background_color = json_object_get_string(features, "background_color");
+    if (background_color != NULL)
+    {
+        item->features.background_color = shared_string(arena, background_color, default_background_color);
+        item->features.has_background_color = true;
+    }
+    else
+    {
+        if (default_background_color != NULL)
         {
-            char *line_end = strchr(line_start, '\n');
-            if (!line_end)
-            {
-                line_end = line_start + strlen(line_start);
-            }
-
-            // Check if line has non-whitespace content
-            char *p;
-            for (p = line_start; p < line_end && isspace(*p); p++)
-                ;
-            if (p < line_end)
-            {
-                item_count++;
-            }
-
-            if (*line_end == '\0')
-            {
-                break;
-            }
-            line_start = line_end + 1;
+            item->features.background_color = default_background_color;
+            item->features.has_background_color = true;
         }
-
-        // Allocate array for items
-        state->items = malloc(sizeof(struct ListItem) * item_count);
-        state->item_count = item_count;
-
-        // Add non-empty lines to items array
-        size_t item_index = 0;
-        line_start = contents;
-        while (*line_start != '\0')
+        else
         {
-            char *line_end = strchr(line_start, '\n');
-            if (!line_end)
-            {
-                line_end = line_start + strlen(line_start);
-            }
-
-            // Check if line has non-whitespace content
-            char *p;
-            for (p = line_start; p < line_end && isspace(*p); p++)
-                ;
-            if (p < line_end)
-            {
-                size_t line_len = line_end - line_start;
-                char *line = malloc(line_len + 1);
-                memcpy(line, line_start, line_len);
-                line[line_len] = '\0';
-                state->items[item_index].name = line;
-                state->items[item_index].has_features = false;
-                state->items[item_index].has_options = false;
-                state->items[item_index].has_selected = false;
-                state->items[item_index].option_count = 0;
-                state->items[item_index].options = NULL;
-                state->items[item_index].selected = 0;
-                state->items[item_index].initial_selected = 0;
-                ListItem_InitImage(&state->items[item_index]);
-                state->items[item_index].features = (struct ListItemFeature){
-                    .background_color = "",
-                    .background_image = "",
-                    .background_image_exists = false,
-                    .can_disable = false,
-                    .confirm_text = "",
-                    .disabled = false,
-                    .draw_arrows = false,
-                    .hide_action = false,
-                    .hide_cancel = false,
-                    .hide_confirm = false,
-                    .show_confirm = false,
-                    .is_header = false,
-                    .unselectable = false,
-                    .display_on_filter = false,
-                    .alignment = "",
-                    .has_background_color = false,
-                    .has_background_image = false,
-                    .has_can_disable = false,
-                    .has_confirm_text = false,
-                    .has_draw_arrows = false,
-                    .has_disabled = false,
-                    .has_hide_action = false,
-                    .has_hide_cancel = false,
-                    .has_hide_confirm = false,
-                    .has_show_confirm = false,
-                    .has_is_header = false,
-                    .has_unselectable = false,
-                    .has_display_on_filter = false,
-                    .has_alignment = false,
-                };
-                strncpy(state->items[item_index].features.alignment, "left", sizeof(state->items[item_index].features.alignment) - 1);
-                strncpy(state->items[item_index].features.confirm_text, confirm_text, sizeof(state->items[item_index].features.confirm_text) - 1);
-                if (default_background_image != NULL)
-                {
-                    strncpy(state->items[item_index].features.background_image, default_background_image, sizeof(state->items[item_index].features.background_image) - 1);
-                    if (access(default_background_image, F_OK) != -1)
-                    {
-                        state->items[item_index].features.background_image_exists = true;
-                    }
-                }
-                if (default_background_color != NULL)
-                {
-                    strncpy(state->items[item_index].features.background_color, default_background_color, sizeof(state->items[item_index].features.background_color) - 1);
-                }
-
-                item_index++;
-            }
-
-            if (*line_end == '\0')
-            {
-                break;
-            }
-            line_start = line_end + 1;
+            item->features.has_background_color = false;
         }
+    }
 
-        free(contents);
-        ListState_InitVisibleIdentity(state);
-        return state;
+    // read in the can_disable from the json object
+    // if there is no can_disable, set it to false
+    // if there is a can_disable, treat it as a boolean
+    if (json_object_get_boolean(features, "can_disable") == 1)
+    {
+        item->features.can_disable = true;
+        item->features.has_can_disable = true;
+    }
+    else if (json_object_get_boolean(features, "can_disable") == 0)
+    {
+        item->features.can_disable = false;
+        item->features.has_can_disable = true;
+    }
+    else
+    {
+        item->features.can_disable = false;
+        item->features.has_can_disable = false;
     }
 
-    JSON_Value *root_value;
-    if (strcmp(filename, "-") == 0)
+    // read in the disabled from the json object
+    // if there is no disabled, set it to false
+    // if there is an disabled, treat it as a boolean
+    if (json_object_get_boolean(features, "disabled") == 1)
+    {
+        item->features.disabled = true;
+        item->features.has_disabled = true;
+    }
+    else if (json_object_get_boolean(features, "disabled") == 0)
     {
-        char *contents = read_stdin();
-        if (contents == NULL)
+        item->features.disabled = false;
+        item->features.has_disabled = true;
+        if (!item->features.can_disable)
         {
-            log_error("Failed to read stdin");
-            free(state);
-            return NULL;
+            char error_message[256];
+            snprintf(error_message, sizeof(error_message), "Item %s has no can_disable, but is disabled", item->name);
+            log_error(error_message);
         }
+    }
+    else
+    {
+        item->features.disabled = false;
+        item->features.has_disabled = false;
+    }
 
-        root_value = json_parse_string_with_comments(contents);
-        free(contents);
+    // read in the draw_arrows from the json object
+    // if there is no draw_arrows, set it to false
+    // if there is a draw_arrows, treat it as a boolean
+    if (json_object_get_boolean(features, "draw_arrows") == 1)
+    {
+        item->features.draw_arrows = true;
+        item->features.has_draw_arrows = true;
+    }
+    else if (json_object_get_boolean(features, "draw_arrows") == 0)
+    {
+        item->features.draw_arrows = false;
+        item->features.has_draw_arrows = true;
     }
     else
     {
-        root_value = json_parse_file_with_comments(filename);
+        item->features.draw_arrows = false;
+        item->features.has_draw_arrows = false;
     }
 
-    if (root_value == NULL)
+    // read in the hide_action from the json object
+    // if there is no hide_action, set it to false
+    // if there is a hide_action, treat it as a boolean
+    if (json_object_get_boolean(features, "hide_action") == 1)
     {
-        log_error("Failed to parse JSON file");
-        free(state);
-        return NULL;
+        item->features.hide_action = true;
+        item->features.has_hide_action = true;
+    }
+    else if (json_object_get_boolean(features, "hide_action") == 0)
+    {
+        item->features.hide_action = false;
+        item->features.has_hide_action = true;
+    }
+    else
+    {
+        item->features.hide_action = false;
+        item->features.has_hide_action = false;
     }
 
-    // Check for alphabetic_scroll in root JSON object
-    JSON_Object *root_object = json_value_get_object(root_value);
-    if (root_object != NULL && json_object_has_value(root_object, "alphabetic_scroll"))
+    // read in the hide_cancel from the json object
+    // if there is no hide_cancel, set it to false
+    // if there is a hide_cancel, treat it as a boolean
+    if (json_object_get_boolean(features, "hide_cancel") == 1)
     {
-        if (json_object_get_boolean(root_object, "alphabetic_scroll") == 1)
-        {
-            app_state->alphabetic_scroll = true;
-        }
+        item->features.hide_cancel = true;
+        item->features.has_hide_cancel = true;
+    }
+    else if (json_object_get_boolean(features, "hide_cancel") == 0)
+    {
+        item->features.hide_cancel = false;
+        item->features.has_hide_cancel = true;
+    }
+    else
+    {
+        item->features.hide_cancel = false;
+        item->features.has_hide_cancel = false;
     }
 
-    // Check for scroll_method in root JSON object. When present it takes
-    // precedence over the --scroll-method flag. An unrecognized value is not a
-    // hard error: ScrollMethod_Parse maps it to SCROLL_NONE at render time.
-    if (root_object != NULL && json_object_has_value(root_object, "scroll_method"))
+    // read in the hide_confirm from the json object
+    // if there is no hide_confirm, set it to false
+    // if there is a hide_confirm, treat it as a boolean
+    if (json_object_get_boolean(features, "hide_confirm") == 1)
     {
-        const char *scroll_method = json_object_get_string(root_object, "scroll_method");
-        if (scroll_method != NULL)
-        {
-            strncpy(app_state->scroll_method, scroll_method, sizeof(app_state->scroll_method) - 1);
-            app_state->scroll_method[sizeof(app_state->scroll_method) - 1] = '\0';
-        }
+        item->features.hide_confirm = true;
+        item->features.has_hide_confirm = true;
+    }
+    else if (json_object_get_boolean(features, "hide_confirm") == 0)
+    {
+        item->features.hide_confirm = false;
+        item->features.has_hide_confirm = true;
+    }
+    else
+    {
+        item->features.hide_confirm = false;
+        item->features.has_hide_confirm = false;
     }
 
-    // decide array form vs object form from the root JSON type, not from whether
-    // --item-key was supplied. a root object is the object form (items live under
-    // item_key, "items" by default); a root array is the array-of-strings form and
-    // ignores item_key.
-    bool use_object_form = json_value_get_type(root_value) == JSONObject;
+    // read in the show_confirm from the json object
+    // if there is no show_confirm, set it to false
+    // if there is a show_confirm, treat it as a boolean
+    if (json_object_get_boolean(features, "show_confirm") == 1)
+    {
+        item->features.show_confirm = true;
+        item->features.has_show_confirm = true;
+    }
+    else if (json_object_get_boolean(features, "show_confirm") == 0)
+    {
+        item->features.show_confirm = false;
+        item->features.has_show_confirm = true;
+    }
+    else
+    {
+        item->features.show_confirm = false;
+        item->features.has_show_confirm = false;
+    }
 
-    JSON_Array *items_array;
-    if (use_object_form)
+    // read in the unselectable from the json object
+    // if there is no unselectable, set it to false
+    // if there is a unselectable, treat it as a boolean
+    if (json_object_get_boolean(features, "unselectable") == 1)
     {
-        items_array = json_value_get_array(json_object_get_value(json_value_get_object(root_value), item_key));
+        item->features.unselectable = true;
+        item->features.has_unselectable = true;
+    }
+    else if (json_object_get_boolean(features, "unselectable") == 0)
+    {
+        item->features.unselectable = false;
+        item->features.has_unselectable = true;
     }
     else
     {
-        items_array = json_value_get_array(root_value);
+        item->features.unselectable = false;
+        item->features.has_unselectable = false;
     }
 
-    size_t item_count = json_array_get_count(items_array);
+    // read in the is_header from the json object
+    // if there is no is_header, set it to false
+    // if there is a is_header, treat it as a boolean
+    // headers are not selectable, so this has to go last such that we can set the unselectable flag
+    if (json_object_get_boolean(features, "is_header") == 1)
+    {
+        item->features.is_header = true;
+        item->features.has_is_header = true;
+        item->features.unselectable = true;
+    }
+    else if (json_object_get_boolean(features, "is_header") == 0)
+    {
+        item->features.is_header = false;
+        item->features.has_is_header = true;
+    }
+    else
+    {
+        item->features.is_header = false;
+        item->features.has_is_header = false;
+    }
 
-    // validate each element's shape before allocating or rendering.
-    // invalid input (objects in a top-level array, or non-object/nameless
-    // items under an item key) would otherwise yield empty item names that
-    // crash the renderer, so fail here the way other malformed input does.
-    for (size_t i = 0; i < item_count; i++)
+    // read in the display_on_filter from the json object
+    // if there is no display_on_filter, set it to false
+    // if there is a display_on_filter, treat it as a boolean
+    if (json_object_get_boolean(features, "display_on_filter") == 1)
+    {
+        item->features.display_on_filter = true;
+        item->features.has_display_on_filter = true;
+    }
+    else if (json_object_get_boolean(features, "display_on_filter") == 0)
+    {
+        item->features.display_on_filter = false;
+        item->features.has_display_on_filter = true;
+    }
+    else
     {
-        JSON_Value *element = json_array_get_value(items_array, i);
-        char error_message[256];
-        error_message[0] = '\0';
+        item->features.display_on_filter = false;
+        item->features.has_display_on_filter = false;
+    }
 
-        if (!use_object_form)
+    // read in the alignment from the json object
+    // if there is no alignment, set it to 'left'
+    // if there is a alignment, it should be 'left', 'center', or 'right'
+    const char *alignment = json_object_get_string(features, "alignment");
+    if (alignment != NULL)
+    {
+        if (strcmp(alignment, "left") == 0 || strcmp(alignment, "center") == 0 || strcmp(alignment, "right") == 0)
         {
-            if (json_value_get_type(element) != JSONString)
-            {
-                snprintf(error_message, sizeof(error_message), "Array item %zu is not a string; use --item-key for object lists", i);
-            }
-            else
-            {
-                const char *element_name = json_value_get_string(element);
-                if (element_name == NULL || element_name[0] == '\0')
-                {
-                    snprintf(error_message, sizeof(error_message), "Array item %zu has an empty name", i);
-                }
-            }
+            item->features.alignment = strcmp(alignment, "center") == 0  ? ALIGNMENT_CENTER
+                                       : strcmp(alignment, "right") == 0 ? ALIGNMENT_RIGHT
+                                                                         : ALIGNMENT_LEFT;
+            item->features.has_alignment = true;
         }
         else
         {
-            if (json_value_get_type(element) != JSONObject)
-            {
-                snprintf(error_message, sizeof(error_message), "Item %zu under key '%s' is not an object", i, item_key);
-            }
-            else
-            {
-                JSON_Object *element_object = json_value_get_object(element);
-                const char *element_name = json_object_get_string(element_object, "name");
-                if (element_name == NULL || element_name[0] == '\0')
-                {
-                    snprintf(error_message, sizeof(error_message), "Item %zu under key '%s' is missing a name", i, item_key);
-                }
-                else
-                {
-                    char item_desc[160];
-                    snprintf(item_desc, sizeof(item_desc), "Item %zu under key '%s'", i, item_key);
-                    validate_features_images(json_object_get_object(element_object, "features"), item_desc, error_message, sizeof(error_message));
-                }
-            }
+            char error_message[256];
+            snprintf(error_message, sizeof(error_message), "Item %s has invalid alignment %s. Must be 'left', 'center', or 'right'. Using default (left).", item->name, alignment);
+            log_error(error_message);
+            item->features.alignment = ALIGNMENT_LEFT;
+            item->features.has_alignment = false;
         }
+    }
+    else
+    {
+        item->features.alignment = ALIGNMENT_LEFT;
+        item->features.has_alignment = false;
+    }
 
-        if (error_message[0] != '\0')
+    // read in the confirm_text from the json object
+    // if there is no confirm_text, keep the default
+    // if there is a non-empty confirm_text, treat it as a string
+    const char *confirm_text = json_object_get_string(features, "confirm_text");
+    if (confirm_text != NULL)
+    {
+        if (strlen(confirm_text) > 0)
         {
-            log_error(error_message);
-            json_value_free(root_value);
-            free(state);
-            return NULL;
+            item->features.confirm_text = shared_string(arena, confirm_text, item->features.confirm_text);
+            item->features.has_confirm_text = true;
         }
     }
+}
 
-    state->items = malloc(sizeof(struct ListItem) * item_count);
-    state->has_options = false;
+// json_option_at reads one option of a JSON options array for
+// ListOptionTables_Intern.
+static const char *json_option_at(const void *options_array, size_t index)
+{
+    return json_array_get_string(options_array, index);
+}
 
+// ListItem_FromJSON validates one element of the items array and builds the
+// list item from it in the same step, so each element is visited once. Strings
+// and arrays are allocated from arena. A malformed element writes the same
+// message the old standalone validation loop reported into err and returns
+// false; nothing is allocated in that case. A NULL item_key marks a jsonl
+// line, which is described by its line number (index) instead.
+static bool ListItem_FromJSON(struct ListItem *item, struct ListArena *arena, struct ListOptionTables *option_tables, JSON_Value *element, size_t index, bool use_object_form, const char *item_key, const char *confirm_text, const char *default_background_image, const char *default_background_color, char *err, size_t err_size)
+{
+    // validate the element's shape before building from it. invalid input
+    // (objects in a top-level array, or non-object/nameless items under an item
+    // key) would otherwise yield empty item names that crash the renderer, so
+    // fail here the way other malformed input does.
     if (!use_object_form)
     {
-        for (size_t i = 0; i < item_count; i++)
-        {
-            const char *name = json_array_get_string(items_array, i);
-            state->items[i].name = name ? strdup(name) : "";
-
-            // set defaults for the other fields
-            state->items[i].has_features = false;
-            state->items[i].has_options = false;
-            state->items[i].has_selected = false;
-            state->items[i].option_count = 0;
-            state->items[i].options = NULL;
-            state->items[i].selected = 0;
-            state->items[i].initial_selected = 0;
-            ListItem_InitImage(&state->items[i]);
-            state->items[i].features = (struct ListItemFeature){
-                .background_color = "",
-                .background_image = "",
-                .background_image_exists = false,
-                .can_disable = false,
-                .confirm_text = "",
-                .disabled = false,
-                .draw_arrows = false,
-                .hide_action = false,
-                .hide_cancel = false,
-                .hide_confirm = false,
-                .show_confirm = false,
-                .is_header = false,
-                .unselectable = false,
-                .display_on_filter = false,
-                .alignment = "",
-                .has_background_color = false,
-                .has_background_image = false,
-                .has_can_disable = false,
-                .has_confirm_text = false,
-                .has_disabled = false,
-                .has_draw_arrows = false,
-                .has_hide_action = false,
-                .has_hide_cancel = false,
-                .has_hide_confirm = false,
-                .has_show_confirm = false,
-                .has_is_header = false,
-                .has_unselectable = false,
-                .has_display_on_filter = false,
-                .has_alignment = false,
-            };
-            strncpy(state->items[i].features.alignment, "left", sizeof(state->items[i].features.alignment) - 1);
-            strncpy(state->items[i].features.confirm_text, confirm_text, sizeof(state->items[i].features.confirm_text) - 1);
-            if (default_background_image != NULL)
+        if (json_value_get_type(element) != JSONString)
+        {
+            snprintf(err, err_size, "Array item %zu is not a string; use --item-key for object lists", index);
+            return false;
+        }
+
+        const char *name = json_value_get_string(element);
+        if (name == NULL || name[0] == '\0')
+        {
+            snprintf(err, err_size, "Array item %zu has an empty name", index);
+            return false;
+        }
+
+        ListItem_InitDefaults(item, ListArena_Strdup(arena, name), confirm_text);
+        ListItem_SetDefaultBackground(item, default_background_image, default_background_color);
+        return true;
+    }
+
+    char item_desc[160];
+    if (item_key != NULL)
+    {
+        snprintf(item_desc, sizeof(item_desc), "Item %zu under key '%s'", index, item_key);
+    }
+    else
+    {
+        snprintf(item_desc, sizeof(item_desc), "Line %zu", index);
+    }
+
+    if (json_value_get_type(element) != JSONObject)
+    {
+        snprintf(err, err_size, "%s is not an object", item_desc);
+        return false;
+    }
+
+    JSON_Object *object = json_value_get_object(element);
+    const char *name = json_object_get_string(object, "name");
+    if (name == NULL || name[0] == '\0')
+    {
+        snprintf(err, err_size, "%s is missing a name", item_desc);
+        return false;
+    }
+
+    if (!validate_features_images(json_object_get_object(object, "features"), item_desc, err, err_size))
+    {
+        return false;
+    }
+
+    // options may be a range spec instead of an array of strings
+    JSON_Object *range_object = json_object_get_object(object, "options");
+    struct ListRange range;
+    if (range_object != NULL)
+    {
+        char reason[128];
+        const char *format = json_object_get_string(range_object, "format");
+        if (json_value_get_type(json_object_get_value(range_object, "min")) != JSONNumber ||
+            json_value_get_type(json_object_get_value(range_object, "max")) != JSONNumber)
+        {
+            snprintf(reason, sizeof(reason), "min and max are required numbers");
+        }
+        else if (json_object_has_value(range_object, "step") && json_value_get_type(json_object_get_value(range_object, "step")) != JSONNumber)
+        {
+            snprintf(reason, sizeof(reason), "step must be a number");
+        }
+        else if (json_object_has_value(range_object, "format") && format == NULL)
+        {
+            snprintf(reason, sizeof(reason), "format must be a string");
+        }
+        else
+        {
+            double step = json_object_has_value(range_object, "step") ? json_object_get_number(range_object, "step") : 1;
+            if (ListRange_Init(&range, json_object_get_number(range_object, "min"), json_object_get_number(range_object, "max"), step, format, reason, sizeof(reason)))
             {
-                strncpy(state->items[i].features.background_image, default_background_image, sizeof(state->items[i].features.background_image) - 1);
-                if (access(default_background_image, F_OK) != -1)
-                {
-                    state->items[i].features.background_image_exists = true;
-                }
+                reason[0] = '\0';
             }
-            if (default_background_color != NULL)
+        }
+        if (reason[0] != '\0')
+        {
+            snprintf(err, err_size, "%s has an invalid options range: %s", item_desc, reason);
+            return false;
+        }
+    }
+
+    // the range is stored before anything else is allocated, so failing to
+    // store it leaves nothing behind
+    struct ListRange *item_range = NULL;
+    if (range_object != NULL)
+    {
+        item_range = ListArena_Alloc(arena, sizeof(struct ListRange));
+        if (item_range == NULL)
+        {
+            snprintf(err, err_size, "%s has an options range that could not be stored", item_desc);
+            return false;
+        }
+    }
+
+    ListItem_InitDefaults(item, ListArena_Strdup(arena, name), confirm_text);
+
+    // read in the options from the json object
+    // if there are no options, set the options to an empty array
+    // if there are options, treat them as a list of strings, shared with every
+    // other item that has the same options
+    JSON_Array *options_array = json_object_get_array(object, "options");
+    size_t options_count = json_array_get_count(options_array);
+    item->options = ListOptionTables_Intern(option_tables, options_array, options_count, json_option_at);
+    if (range_object != NULL)
+    {
+        // a range is formatted on demand, so it is stored as is whatever its size
+        if (range.format != NULL)
+        {
+            range.format = ListArena_Strdup(arena, range.format);
+        }
+        *item_range = range;
+        item->range = item_range;
+        options_count = range.count;
+    }
+    item->option_count = options_count;
+    item->has_options = options_count > 0;
+
+    // read in the current option index from the json object
+    // if there is no current option index, set it to 0
+    // if there is a current option index, treat it as an integer
+    if (json_object_has_value(object, "selected"))
+    {
+        item->selected = json_object_get_number(object, "selected");
+        if (item->selected < 0)
+        {
+            char error_message[256];
+            snprintf(error_message, sizeof(error_message), "Item %s has a selected option index of %d, which is less than 0. Setting to 0.", item->name, item->selected);
+            log_error(error_message);
+            item->selected = 0;
+        }
+        if (item->selected >= options_count)
+        {
+            char error_message[256];
+            snprintf(error_message, sizeof(error_message), "Item %s has a selected option index of %d, which is greater than the number of options %zu. Setting to last option.", item->name, item->selected, options_count);
+            log_error(error_message);
+            item->selected = options_count - 1;
+            if (item->selected < 0)
             {
-                strncpy(state->items[i].features.background_color, default_background_color, sizeof(state->items[i].features.background_color) - 1);
+                item->selected = 0;
             }
         }
+        item->has_selected = true;
+    }
+    item->initial_selected = item->selected;
+
+    if (json_object_has_value(object, "features"))
+    {
+        item->has_features = true;
+        ListItem_ReadFeatures(item, arena, json_object_get_object(object, "features"), default_background_image, default_background_color);
     }
     else
     {
-        for (size_t i = 0; i < item_count; i++)
+        ListItem_SetDefaultBackground(item, default_background_image, default_background_color);
+        item->features.has_background_image = default_background_image != NULL;
+        item->features.has_background_color = default_background_color != NULL;
+    }
+
+    // build the right-hand-side image variants for this item from
+    // features.images
+    ListItem_ReadImages(item, json_object_get_object(object, "features"), arena);
+    item->has_image = item->image_variant_count > 0;
+    return true;
+}
+
+// ListState_DropIndex frees the --filter-index trigram index, if any.
+static void ListState_DropIndex(struct ListState *state)
+{
+    if (state->filter_index != NULL)
+    {
+        ListTrigramIndex_Free(state->filter_index);
+        free(state->filter_index);
+        state->filter_index = NULL;
+    }
+}
+
+// ListState_StopFilter is defined with the filtering code below, but freeing
+// a list must stop the filter worker first, so it needs a forward declaration.
+static void ListState_StopFilter(struct ListState *state);
+
+// ListState_Free releases a list and every item in it. Per-item data lives in
+// the arena or the input buffer, so this is a handful of frees however long
+// the list is.
+static void ListState_Free(struct ListState *state)
+{
+    ListState_StopFilter(state);
+    for (size_t i = 0; i < state->item_count; i++)
+    {
+        if (state->items[i].image_surface != NULL)
         {
-            JSON_Object *item = json_array_get_object(items_array, i);
+            SDL_FreeSurface(state->items[i].image_surface);
+        }
+    }
+    ListArena_Free(&state->arena);
+    free(state->items);
+    free(state->rows);
+    free(state->visible);
+    ListFilterHistory_Clear(&state->filter_history);
+    ListState_DropIndex(state);
+    ListInput_Close(&state->input);
+    if (state->loader != NULL)
+    {
+        ListLoader_Free(state->loader);
+        free(state->loader);
+    }
+    ListOptionTables_Free(&state->load_option_tables);
+    free(state);
+}
+
+// ListState_AppendItem returns the slot for the next item at the end of
+// state->items, growing the array geometrically so loaders can build items in a
+// single pass without knowing the count up front. The caller fills the slot in
+// and bumps item_count once the item is complete.
+static struct ListItem *ListState_AppendItem(struct ListState *state)
+{
+    if (state->item_count == state->item_capacity)
+    {
+        state->item_capacity = state->item_capacity > 0 ? state->item_capacity * 2 : 64;
+        state->items = realloc(state->items, sizeof(struct ListItem) * state->item_capacity);
+    }
+    return &state->items[state->item_count];
+}
+
+// json_parse_span parses the JSON value in span with parson. The byte just past
+// the span is swapped for a NUL terminator for the duration of the call, so the
+// value is parsed straight out of the input buffer without copying it first.
+// The buffer must be writable and have a byte after the span (the input's own
+// NUL terminator at worst).
+static JSON_Value *json_parse_span(struct ListJSONSpan span)
+{
+    char *terminator = span.start + span.length;
+    char saved = *terminator;
+    *terminator = '\0';
+    JSON_Value *value = json_parse_string_with_comments(span.start);
+    *terminator = saved;
+    return value;
+}
+
+// the fewest items worth handing to each ListState_LoadItems worker thread;
+// smaller lists are built on the calling thread
+#define LIST_BUILD_MIN_ITEMS_PER_WORKER 2048
+
+// ListItemBuildWorker is one worker's share of building an items array: the
+// arena its items allocate from, the warnings they logged, and how far it got.
+struct ListItemBuildWorker
+{
+    struct ListArena arena;
+    struct ListOptionTables option_tables;
+    struct ListCacheWriter warnings;
+    // the number of items built from the start of the slice
+    size_t built;
+    // whether the slice stopped at a bad element, described by error_message
+    bool failed;
+    char error_message[256];
+    bool has_options;
+};
+
+// ListItemBuild is the work shared by every worker of a ListState_LoadItems.
+struct ListItemBuild
+{
+    struct ListState *state;
+    // the elements to build, in order, and the index of the first one
+    const struct ListJSONSpan *spans;
+    size_t first;
+    bool use_object_form;
+    const char *item_key;
+    const char *confirm_text;
+    const char *default_background_image;
+    const char *default_background_color;
+    struct ListItemBuildWorker *workers;
+    // whether warnings are collected for printing after the build
+    bool defer_warnings;
+};
+
+// ListItemBuild_Slice parses and builds items [begin, end) of a build into
+// their slots in state->items, stopping at the first bad element.
+static void ListItemBuild_Slice(void *context, size_t worker_index, size_t begin, size_t end)
+{
+    struct ListItemBuild *build = context;
+    struct ListItemBuildWorker *worker = &build->workers[worker_index];
+    log_deferred = build->defer_warnings ? &worker->warnings : NULL;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        size_t index = build->first + i;
+        JSON_Value *element = json_parse_span(build->spans[i]);
+        if (element == NULL)
+        {
+            snprintf(worker->error_message, sizeof(worker->error_message), "Failed to parse JSON file");
+            worker->failed = true;
+            break;
+        }
+
+        struct ListItem *item = &build->state->items[index];
+        bool built = ListItem_FromJSON(item, &worker->arena, &worker->option_tables, element, index, build->use_object_form, build->item_key, build->confirm_text, build->default_background_image, build->default_background_color, worker->error_message, sizeof(worker->error_message));
+        json_value_free(element);
+        if (!built)
+        {
+            worker->failed = true;
+            break;
+        }
 
-            const char *name = json_object_get_string(item, "name");
-            state->items[i].name = name ? strdup(name) : "";
+        worker->has_options = worker->has_options || item->has_options;
+        worker->built++;
+    }
+
+    log_deferred = NULL;
+}
 
-            // read in the options from the json object
-            // if there are no options, set the options to an empty array
-            // if there are options, treat them as a list of strings
-            JSON_Array *options_array = json_object_get_array(item, "options");
-            size_t options_count = json_array_get_count(options_array);
-            state->items[i].options = malloc(sizeof(char *) * options_count);
-            state->items[i].option_count = options_count;
-            for (size_t j = 0; j < options_count; j++)
+// ListState_LoadItems scans the elements of an items array, then parses,
+// validates and builds them into state->items. Large arrays are split into
+// contiguous slices built in parallel (see list_pool), each worker allocating
+// from its own arena. Warnings and errors come out exactly as a single pass
+// would print them: warnings in item order, and only the lowest failing
+// element's error. Returns false after logging the first error; items built
+// before it stay in state for the caller to free.
+static bool ListState_LoadItems(struct ListState *state, struct ListJSONCursor *items, bool use_object_form, const char *item_key, const char *confirm_text, const char *default_background_image, const char *default_background_color)
+{
+    // the scanner only walks the array's skeleton, so collecting the element
+    // spans up front is cheap next to parsing them
+    struct ListJSONSpan *spans = NULL;
+    size_t span_count = 0;
+    size_t span_capacity = 0;
+    struct ListJSONSpan span;
+    enum ListJSONStatus status;
+    while ((status = ListJSON_NextElement(items, &span)) == LIST_JSON_VALUE)
+    {
+        if (span_count == span_capacity)
+        {
+            size_t capacity = span_capacity > 0 ? span_capacity * 2 : 256;
+            struct ListJSONSpan *grown = realloc(spans, sizeof(struct ListJSONSpan) * capacity);
+            if (grown == NULL)
             {
-                const char *option = json_array_get_string(options_array, j);
-                state->items[i].options[j] = option ? strdup(option) : "";
+                free(spans);
+                log_error("Failed to allocate the list items");
+                return false;
             }
+            spans = grown;
+            span_capacity = capacity;
+        }
+        spans[span_count++] = span;
+    }
+
+    // make room for every slot, since workers fill them in place
+    if (state->item_capacity - state->item_count < span_count)
+    {
+        struct ListItem *grown = realloc(state->items, sizeof(struct ListItem) * (state->item_count + span_count));
+        if (grown == NULL)
+        {
+            free(spans);
+            log_error("Failed to allocate the list items");
+            return false;
+        }
+        state->items = grown;
+        state->item_capacity = state->item_count + span_count;
+    }
+
+    size_t worker_count = ListPool_WorkerCount(span_count, LIST_BUILD_MIN_ITEMS_PER_WORKER);
+    struct ListItemBuildWorker workers[LIST_POOL_MAX_WORKERS];
+    for (size_t w = 0; w < worker_count; w++)
+    {
+        ListArena_Init(&workers[w].arena);
+        ListOptionTables_Init(&workers[w].option_tables, &workers[w].arena);
+        ListCacheWriter_Init(&workers[w].warnings);
+        workers[w].built = 0;
+        workers[w].failed = false;
+        workers[w].error_message[0] = '\0';
+        workers[w].has_options = false;
+    }
+
+    struct ListItemBuild build = {
+        .state = state,
+        .spans = spans,
+        .first = state->item_count,
+        .use_object_form = use_object_form,
+        .item_key = item_key,
+        .confirm_text = confirm_text,
+        .default_background_image = default_background_image,
+        .default_background_color = default_background_color,
+        .workers = workers,
+        .defer_warnings = worker_count > 1,
+    };
+    ListPool_Run(span_count, worker_count, ListItemBuild_Slice, &build);
 
-            if (options_count > 0)
+    // merge the slices in order. The first failed slice holds the lowest
+    // failing element; items and warnings past it are dropped.
+    bool ok = true;
+    for (size_t w = 0; w < worker_count; w++)
+    {
+        if (ok)
+        {
+            // a warning the worker ran out of memory writing ends the replay
+            struct ListCacheReader reader = {workers[w].warnings.data, workers[w].warnings.data + workers[w].warnings.size, false};
+            while (reader.p < reader.end && !reader.failed)
             {
-                state->has_options = true;
-                state->items[i].has_options = true;
+                const char *warning = ListCacheReader_GetString(&reader);
+                if (warning != NULL)
+                    log_error(warning);
             }
-            else
+
+            state->item_count = build.first + ListPool_SliceBegin(span_count, worker_count, w) + workers[w].built;
+            state->has_options = state->has_options || workers[w].has_options;
+            if (workers[w].failed)
             {
-                state->items[i].has_options = false;
+                log_error(workers[w].error_message);
+                ok = false;
             }
+        }
+        ListOptionTables_Free(&workers[w].option_tables);
+        ListArena_Adopt(&state->arena, &workers[w].arena);
+        ListCacheWriter_Free(&workers[w].warnings);
+    }
+    free(spans);
+
+    if (ok && status == LIST_JSON_ERROR)
+    {
+        log_error("Failed to parse JSON file");
+        return false;
+    }
+
+    return ok;
+}
+
+// json_key_seen reports whether key is already in seen, adding it when it is
+// not. parson rejects objects with duplicate keys, so the loader does too. A
+// key there is no memory to remember also counts as seen, so the caller
+// rejects the document rather than miss a duplicate.
+static bool json_key_seen(char ***seen, size_t *seen_count, const char *key)
+{
+    for (size_t k = 0; k < *seen_count; k++)
+    {
+        if (strcmp((*seen)[k], key) == 0)
+            return true;
+    }
+    char **keys = realloc(*seen, sizeof(char *) * (*seen_count + 1));
+    if (keys == NULL)
+        return true;
+    *seen = keys;
+    char *copy = strdup(key);
+    if (copy == NULL)
+        return true;
+    (*seen)[(*seen_count)++] = copy;
+    return false;
+}
+
+// json_keys_free releases the keys collected by json_key_seen.
+static void json_keys_free(char **seen, size_t seen_count)
+{
+    for (size_t k = 0; k < seen_count; k++)
+    {
+        free(seen[k]);
+    }
+    free(seen);
+}
+
+// json_span_valid reports whether span holds valid JSON.
+static bool json_span_valid(struct ListJSONSpan span)
+{
+    JSON_Value *value = json_parse_span(span);
+    json_value_free(value);
+    return value != NULL;
+}
+
+// json_find_path follows segments first onwards of path into the value in
+// span and sets *found to the items array at its end. Every value passed over
+// on the way is validated, as the root loop validates the root's other
+// members. Returns 1 when the array was found, 0 when the path leads nowhere
+// (or to something other than an array) and -1 when the JSON is malformed.
+static int json_find_path(struct ListJSONSpan span, const struct ListKeyPath *path, int first, struct ListJSONSpan *found)
+{
+    if (first == path->count && span.start[0] == '[')
+    {
+        *found = span;
+        return 1;
+    }
+
+    struct ListJSONCursor cursor;
+    const struct ListKeyPathSegment *segment = &path->segments[first < path->count ? first : 0];
+    if (first == path->count || !ListJSON_Enter(&cursor, span.start, span.start + span.length) ||
+        (cursor.close == '}') != (segment->key != NULL))
+    {
+        return json_span_valid(span) ? 0 : -1;
+    }
+
+    char **seen_keys = NULL;
+    size_t seen_count = 0;
+    int result = 0;
+    int index = 0;
+    struct ListJSONSpan key_span, value_span;
+    enum ListJSONStatus status = LIST_JSON_END;
+    while (result >= 0)
+    {
+        status = segment->key != NULL ? ListJSON_NextMember(&cursor, &key_span, &value_span) : ListJSON_NextElement(&cursor, &value_span);
+        if (status != LIST_JSON_VALUE)
+            break;
 
-            // read in the current option index from the json object
-            // if there is no current option index, set it to 0
-            // if there is a current option index, treat it as an integer
-            if (json_object_has_value(item, "selected"))
+        bool on_path;
+        if (segment->key != NULL)
+        {
+            JSON_Value *key_value = json_parse_span(key_span);
+            const char *key = json_value_get_string(key_value);
+            if (key == NULL || json_key_seen(&seen_keys, &seen_count, key))
             {
-                state->items[i].selected = json_object_get_number(item, "selected");
-                if (state->items[i].selected < 0)
-                {
-                    char error_message[256];
-                    snprintf(error_message, sizeof(error_message), "Item %s has a selected option index of %d, which is less than 0. Setting to 0.", state->items[i].name, state->items[i].selected);
-                    log_error(error_message);
-                    state->items[i].selected = 0;
-                }
-                if (state->items[i].selected >= options_count)
-                {
-                    char error_message[256];
-                    snprintf(error_message, sizeof(error_message), "Item %s has a selected option index of %d, which is greater than the number of options %zu. Setting to last option.", state->items[i].name, state->items[i].selected, options_count);
-                    log_error(error_message);
-                    state->items[i].selected = options_count - 1;
-                    if (state->items[i].selected < 0)
-                    {
-                        state->items[i].selected = 0;
-                    }
-                }
-                state->items[i].has_selected = true;
+                json_value_free(key_value);
+                result = -1;
+                break;
             }
-            else
+            on_path = strcmp(key, segment->key) == 0;
+            json_value_free(key_value);
+        }
+        else
+        {
+            on_path = index++ == segment->index;
+        }
+
+        if (on_path)
+        {
+            result = json_find_path(value_span, path, first + 1, found);
+        }
+        else if (!json_span_valid(value_span))
+        {
+            result = -1;
+        }
+    }
+    json_keys_free(seen_keys, seen_count);
+
+    if (status == LIST_JSON_ERROR)
+        return -1;
+    return result;
+}
+
+// ListState_LoadJSON builds the list from the JSON document in contents, which
+// must be writable and NUL-terminated. Rather than parsing the whole document
+// into a parson tree and walking it twice, it scans the root and the items array
+// with list_json and hands parson one element at a time, so every item is
+// validated and built in a single pass and peak memory is the input plus one
+// item's tree per worker. Root members other than the items array are parsed
+// on their own so malformed JSON anywhere in the document is still rejected.
+// Returns false after logging an error.
+static bool ListState_LoadJSON(struct ListState *state, char *contents, const char *item_key, const char *confirm_text, const char *default_background_image, const char *default_background_color, struct AppState *app_state)
+{
+    char *end = contents + strlen(contents);
+    char *p = ListJSON_SkipSpace(ListJSON_SkipBOM(contents, end), end);
+
+    // decide array form vs object form from the root JSON type, not from whether
+    // --item-key was supplied. a root object is the object form (items live under
+    // item_key, "items" by default); a root array is the array-of-strings form and
+    // ignores item_key. any other root is valid JSON with no items.
+    struct ListJSONCursor root;
+    if (!ListJSON_Enter(&root, p, end))
+    {
+        char *value_end = ListJSON_SkipValue(p, end);
+        JSON_Value *value = value_end != NULL ? json_parse_span((struct ListJSONSpan){p, value_end - p}) : NULL;
+        if (value == NULL)
+        {
+            log_error("Failed to parse JSON file");
+            return false;
+        }
+        json_value_free(value);
+        return true;
+    }
+
+    if (root.close == ']')
+    {
+        return ListState_LoadItems(state, &root, false, item_key, confirm_text, default_background_image, default_background_color);
+    }
+
+    // item_key is a path such as "data.menus[2].items"; its first key is
+    // looked for among the root's members and the rest is followed from there
+    struct ListKeyPath path;
+    if (!ListKeyPath_Parse(&path, item_key))
+    {
+        log_error("Invalid item key provided");
+        return false;
+    }
+
+    // parson rejects duplicate keys, so remember the ones already seen
+    char **seen_keys = NULL;
+    size_t seen_count = 0;
+    bool ok = true;
+
+    struct ListJSONSpan key_span, value_span;
+    enum ListJSONStatus status = LIST_JSON_END;
+    while (ok && (status = ListJSON_NextMember(&root, &key_span, &value_span)) == LIST_JSON_VALUE)
+    {
+        JSON_Value *key_value = json_parse_span(key_span);
+        const char *key = json_value_get_string(key_value);
+        if (key == NULL || json_key_seen(&seen_keys, &seen_count, key))
+        {
+            json_value_free(key_value);
+            log_error("Failed to parse JSON file");
+            ok = false;
+            break;
+        }
+
+        bool on_path = strcmp(key, path.segments[0].key) == 0;
+        struct ListJSONSpan items_span = value_span;
+        bool is_items = on_path && path.count == 1 && value_span.start[0] == '[';
+        if (on_path && path.count > 1)
+        {
+            int found = json_find_path(value_span, &path, 1, &items_span);
+            if (found < 0)
             {
-                state->items[i].selected = 0;
-                state->items[i].has_selected = false;
+                log_error("Failed to parse JSON file");
+                ok = false;
             }
+            is_items = found > 0;
+        }
+        // a value the path was followed into has been validated on the way
+        bool checked = is_items || (on_path && path.count > 1);
+        bool is_setting = strcmp(key, "alphabetic_scroll") == 0 || strcmp(key, "scroll_method") == 0 || strcmp(key, "selected") == 0;
+
+        if (is_items)
+        {
+            struct ListJSONCursor items;
+            ListJSON_Enter(&items, items_span.start, items_span.start + items_span.length);
+            ok = ListState_LoadItems(state, &items, true, item_key, confirm_text, default_background_image, default_background_color);
+        }
 
-            state->items[i].initial_selected = state->items[i].selected;
-            ListItem_InitImage(&state->items[i]);
-
-            state->items[i].features = (struct ListItemFeature){
-                .background_color = "",
-                .background_image = "",
-                .background_image_exists = false,
-                .can_disable = false,
-                .confirm_text = "",
-                .disabled = false,
-                .draw_arrows = false,
-                .hide_action = false,
-                .hide_cancel = false,
-                .hide_confirm = false,
-                .show_confirm = false,
-                .is_header = false,
-                .unselectable = false,
-                .display_on_filter = false,
-                .alignment = "",
-                .has_background_color = false,
-                .has_background_image = false,
-                .has_can_disable = false,
-                .has_confirm_text = false,
-                .has_disabled = false,
-                .has_draw_arrows = false,
-                .has_hide_action = false,
-                .has_hide_cancel = false,
-                .has_hide_confirm = false,
-                .has_show_confirm = false,
-                .has_is_header = false,
-                .has_unselectable = false,
-                .has_display_on_filter = false,
-                .has_alignment = false,
-            };
-            strncpy(state->items[i].features.alignment, "left", sizeof(state->items[i].features.alignment) - 1);
-            strncpy(state->items[i].features.confirm_text, confirm_text, sizeof(state->items[i].features.confirm_text) - 1);
-            state->items[i].has_features = false;
-            if (json_object_has_value(item, "features"))
+        if (ok && (!checked || is_setting))
+        {
+            JSON_Value *value = json_parse_span(value_span);
+            if (value == NULL)
+            {
+                log_error("Failed to parse JSON file");
+                ok = false;
+            }
+            else if (strcmp(key, "alphabetic_scroll") == 0)
             {
-                state->items[i].has_features = true;
-                JSON_Object *features = json_object_get_object(item, "features");
-
-                // read in the background_image from the json object
-                // if there is no background_image, set it to ""
-                // if there is a background_image, treat it as a string
-                const char *background_image = json_object_get_string(features, "background_image");
-                if (background_image != NULL)
+                // alphabetic_scroll in the root JSON object turns on alphabetic scrolling
+                if (json_value_get_boolean(value) == 1)
                 {
-                    strncpy(state->items[i].features.background_image, background_image, sizeof(state->items[i].features.background_image) - 1);
-                    if (access(background_image, F_OK) != -1)
-                    {
-                        state->items[i].features.background_image_exists = true;
-                    }
-                    state->items[i].features.has_background_image = true;
+                    app_state->alphabetic_scroll = true;
+                    state->root_alphabetic_scroll = true;
                 }
-                else
+            }
+            else if (strcmp(key, "scroll_method") == 0)
+            {
+                // scroll_method in the root JSON object takes precedence over the
+                // --scroll-method flag. An unrecognized value is not a hard error:
+                // ScrollMethod_Parse maps it to SCROLL_NONE at render time.
+                const char *scroll_method = json_value_get_string(value);
+                if (scroll_method != NULL)
                 {
-                    if (default_background_image != NULL)
-                    {
-                        strncpy(state->items[i].features.background_image, default_background_image, sizeof(state->items[i].features.background_image) - 1);
-                        if (access(default_background_image, F_OK) != -1)
-                        {
-                            state->items[i].features.background_image_exists = true;
-                        }
-                        state->items[i].features.has_background_image = true;
-                    }
-                    else
-                    {
-                        state->items[i].features.has_background_image = false;
-                    }
+                    strncpy(app_state->scroll_method, scroll_method, sizeof(app_state->scroll_method) - 1);
+                    app_state->scroll_method[sizeof(app_state->scroll_method) - 1] = '\0';
+                    state->root_scroll_method = ListArena_Strdup(&state->arena, scroll_method);
                 }
+            }
+            else if (strcmp(key, "selected") == 0)
+            {
+                // the requested initial selection
+                state->selected = (int)json_value_get_number(value);
+            }
+            json_value_free(value);
+        }
+        json_value_free(key_value);
+    }
 
-                // read in the background_color from the json object
-                // if there is no background_color, set it to ""
-                // if there is a background_color, treat it as a string
-                const char *background_color = json_object_get_string(features, "background_color");
-                if (background_color != NULL)
-                {
-                    strncpy(state->items[i].features.background_color, background_color, sizeof(state->items[i].features.background_color) - 1);
-                    state->items[i].features.has_background_color = true;
-                }
-                else
-                {
-                    if (default_background_color != NULL)
-                    {
-                        strncpy(state->items[i].features.background_color, default_background_color, sizeof(state->items[i].features.background_color) - 1);
-                        state->items[i].features.has_background_color = true;
-                    }
-                    else
-                    {
-                        state->items[i].features.has_background_color = false;
-                    }
-                }
+    if (ok && status == LIST_JSON_ERROR)
+    {
+        log_error("Failed to parse JSON file");
+        ok = false;
+    }
+
+    json_keys_free(seen_keys, seen_count);
+    return ok;
+}
+
+// ListState_CacheSettingsHash hashes the options that are baked into a built
+// list, so a cache built with different ones is not reused.
+static uint64_t ListState_CacheSettingsHash(const char *item_key, const char *confirm_text, const char *default_background_image, const char *default_background_color)
+{
+    uint64_t hash = LIST_CACHE_HASH_SEED;
+    hash = ListCache_HashString(item_key, hash);
+    hash = ListCache_HashString(confirm_text, hash);
+    hash = ListCache_HashString(default_background_image, hash);
+    return ListCache_HashString(default_background_color, hash);
+}
+
+// LIST_CACHE_NO_OPTIONS is the option table index cached for an item without
+// options, and LIST_CACHE_RANGE_OPTIONS the one for an item with a range,
+// which is stored with the item
+#define LIST_CACHE_NO_OPTIONS UINT32_MAX
+#define LIST_CACHE_RANGE_OPTIONS (UINT32_MAX - 1)
+
+// ListState_WriteCacheOptions writes each distinct option array once, as a
+// count followed by the arrays. Items share interned arrays by pointer, so
+// arrays are told apart by address. Returns a malloc'd array holding each
+// item's table index (LIST_CACHE_NO_OPTIONS without options,
+// LIST_CACHE_RANGE_OPTIONS for a range), or NULL when memory is exhausted.
+static uint32_t *ListState_WriteCacheOptions(const struct ListState *state, struct ListCacheWriter *writer)
+{
+    uint32_t *item_tables = malloc(sizeof(uint32_t) * (state->item_count > 0 ? state->item_count : 1));
+    // the first item to use each table, in index order
+    size_t *table_items = malloc(sizeof(size_t) * (state->item_count > 0 ? state->item_count : 1));
+    // open-addressed from table address to index
+    size_t slot_count = 64;
+    while (slot_count < state->item_count * 2)
+        slot_count *= 2;
+    uint32_t *slots = malloc(sizeof(uint32_t) * slot_count);
+    if (item_tables == NULL || table_items == NULL || slots == NULL)
+    {
+        free(item_tables);
+        free(table_items);
+        free(slots);
+        return NULL;
+    }
+    memset(slots, 0xff, sizeof(uint32_t) * slot_count);
+
+    uint32_t table_count = 0;
+    for (size_t i = 0; i < state->item_count; i++)
+    {
+        const char **options = state->items[i].options;
+        item_tables[i] = state->items[i].range != NULL ? LIST_CACHE_RANGE_OPTIONS : LIST_CACHE_NO_OPTIONS;
+        if (state->items[i].option_count == 0 || options == NULL)
+            continue;
+
+        size_t slot = ((uintptr_t)options >> 4) & (slot_count - 1);
+        while (slots[slot] != LIST_CACHE_NO_OPTIONS && state->items[table_items[slots[slot]]].options != options)
+            slot = (slot + 1) & (slot_count - 1);
+        if (slots[slot] == LIST_CACHE_NO_OPTIONS)
+        {
+            slots[slot] = table_count;
+            table_items[table_count++] = i;
+        }
+        item_tables[i] = slots[slot];
+    }
+
+    ListCacheWriter_PutU32(writer, table_count);
+    for (uint32_t t = 0; t < table_count; t++)
+    {
+        const struct ListItem *item = &state->items[table_items[t]];
+        ListCacheWriter_PutU32(writer, (uint32_t)item->option_count);
+        for (int k = 0; k < item->option_count; k++)
+        {
+            ListCacheWriter_PutString(writer, item->options[k]);
+        }
+    }
+
+    free(table_items);
+    free(slots);
+    return item_tables;
+}
+
+// ListState_WriteCache stores a freshly loaded list in the cache file at path:
+// the root settings, each distinct option array, every item in source order
+// (referring to its options by index), then the warnings logged
+// while loading it (count strings recorded in warnings). Image variants are
+// stored unresolved, so the cache does not depend on the screen resolution.
+static bool ListState_WriteCache(const struct ListState *state, const char *path, const struct ListCacheKey *key, const struct ListCacheWriter *warnings, uint32_t count)
+{
+    struct ListCacheWriter writer;
+    ListCacheWriter_Init(&writer);
+    ListCacheWriter_PutU32(&writer, (uint32_t)state->selected);
+    ListCacheWriter_PutU8(&writer, state->root_alphabetic_scroll);
+    ListCacheWriter_PutString(&writer, state->root_scroll_method);
+
+    uint32_t *option_tables = ListState_WriteCacheOptions(state, &writer);
+    if (option_tables == NULL)
+    {
+        ListCacheWriter_Free(&writer);
+        return false;
+    }
+
+    ListCacheWriter_PutU32(&writer, (uint32_t)state->item_count);
+
+    for (size_t i = 0; i < state->item_count; i++)
+    {
+        const struct ListItem *item = &state->items[i];
+        ListCacheWriter_PutString(&writer, item->name);
+        ListCacheWriter_PutU8(&writer, (uint8_t)(item->has_features | item->has_options << 1 | item->has_selected << 2 | item->has_image << 3));
+        ListCacheWriter_PutU32(&writer, (uint32_t)item->selected);
+        ListCacheWriter_PutU32(&writer, (uint32_t)item->initial_selected);
+        ListCacheWriter_PutU32(&writer, option_tables[i]);
+        if (item->range != NULL)
+        {
+            ListCacheWriter_PutU32(&writer, (uint32_t)item->range->min);
+            ListCacheWriter_PutU32(&writer, (uint32_t)item->range->max);
+            ListCacheWriter_PutU32(&writer, (uint32_t)item->range->step);
+            ListCacheWriter_PutString(&writer, item->range->format);
+        }
+
+        ListCacheWriter_PutString(&writer, item->features.background_color);
+        ListCacheWriter_PutString(&writer, item->features.background_image);
+        ListCacheWriter_PutString(&writer, item->features.confirm_text);
+        ListCacheWriter_PutU8(&writer, (uint8_t)item->features.alignment);
+        ListCacheWriter_PutU32(&writer, ListItemFeature_PackFlags(&item->features));
+
+        ListCacheWriter_PutU32(&writer, (uint32_t)item->image_variant_count);
+        for (int k = 0; k < item->image_variant_count; k++)
+        {
+            ListCacheWriter_PutString(&writer, item->image_variants[k].resolution);
+            ListCacheWriter_PutString(&writer, item->image_variants[k].path);
+        }
+    }
+    free(option_tables);
+
+    struct ListCacheReader recorded = {warnings->data, warnings->data + warnings->size, warnings->failed};
+    ListCacheWriter_PutU32(&writer, count);
+    for (uint32_t k = 0; k < count; k++)
+    {
+        ListCacheWriter_PutString(&writer, ListCacheReader_GetString(&recorded));
+    }
+    if (recorded.failed)
+    {
+        ListCacheWriter_Free(&writer);
+        return false;
+    }
+
+    bool ok = ListCacheWriter_Commit(&writer, path, key);
+    ListCacheWriter_Free(&writer);
+    return ok;
+}
+
+// cached_string returns shared when value has the same contents (mirroring
+// shared_string at load time), and otherwise value itself, which points into
+// the mapped cache.
+static const char *cached_string(const char *value, const char *shared)
+{
+    if (value != NULL && shared != NULL && strcmp(value, shared) == 0)
+    {
+        return shared;
+    }
+    return value;
+}
+
+// ListState_ReadCache rebuilds the list from a cache payload written by
+// ListState_WriteCache and logs the warnings the original load logged. Strings
+// point into the mapped cache file, which the caller keeps in state->input.
+// Returns false on a malformed payload, leaving any partially built items for
+// the caller to discard.
+static bool ListState_ReadCache(struct ListState *state, struct ListCacheReader *reader, const char *confirm_text, const char *default_background_image, const char *default_background_color, struct AppState *app_state)
+{
+    int selected = (int)ListCacheReader_GetU32(reader);
+    bool root_alphabetic_scroll = ListCacheReader_GetU8(reader) != 0;
+    const char *root_scroll_method = ListCacheReader_GetString(reader);
+
+    // the distinct option arrays, which items refer to by index
+    uint32_t table_count = ListCacheReader_GetCount(reader);
+    const char ***option_tables = ListArena_Alloc(&state->arena, sizeof(const char **) * table_count);
+    int *option_table_counts = ListArena_Alloc(&state->arena, sizeof(int) * table_count);
+    if (option_tables == NULL || option_table_counts == NULL)
+        return false;
+    for (uint32_t t = 0; t < table_count; t++)
+    {
+        uint32_t option_count = ListCacheReader_GetCount(reader);
+        option_tables[t] = ListArena_Alloc(&state->arena, sizeof(const char *) * option_count);
+        if (option_count == 0 || option_tables[t] == NULL)
+            return false;
+        for (uint32_t k = 0; k < option_count; k++)
+        {
+            option_tables[t][k] = ListCacheReader_GetString(reader);
+            if (option_tables[t][k] == NULL)
+                return false;
+        }
+        option_table_counts[t] = (int)option_count;
+    }
+
+    uint32_t item_count = ListCacheReader_GetCount(reader);
+    if (reader->failed)
+        return false;
+
+    state->items = malloc(sizeof(struct ListItem) * (item_count > 0 ? item_count : 1));
+    if (state->items == NULL)
+        return false;
+    state->item_capacity = item_count;
+
+    for (uint32_t i = 0; i < item_count; i++)
+    {
+        struct ListItem *item = &state->items[i];
+        const char *name = ListCacheReader_GetString(reader);
+        uint8_t flags = ListCacheReader_GetU8(reader);
+        if (name == NULL)
+            return false;
+
+        ListItem_InitDefaults(item, (char *)name, confirm_text);
+        item->has_features = (flags & 1) != 0;
+        item->has_options = (flags & 2) != 0;
+        item->has_selected = (flags & 4) != 0;
+        item->has_image = (flags & 8) != 0;
+        item->selected = (int)ListCacheReader_GetU32(reader);
+        item->initial_selected = (int)ListCacheReader_GetU32(reader);
+
+        uint32_t option_table = ListCacheReader_GetU32(reader);
+        if (option_table == LIST_CACHE_RANGE_OPTIONS)
+        {
+            int min = (int)ListCacheReader_GetU32(reader);
+            int max = (int)ListCacheReader_GetU32(reader);
+            int step = (int)ListCacheReader_GetU32(reader);
+            const char *format = ListCacheReader_GetString(reader);
+            char reason[128];
+            struct ListRange *range = ListArena_Alloc(&state->arena, sizeof(struct ListRange));
+            if (range == NULL || !ListRange_Init(range, min, max, step, format, reason, sizeof(reason)))
+                return false;
+            item->range = range;
+            item->option_count = range->count;
+        }
+        else if (option_table != LIST_CACHE_NO_OPTIONS)
+        {
+            if (option_table >= table_count)
+                return false;
+            item->options = option_tables[option_table];
+            item->option_count = option_table_counts[option_table];
+        }
+
+        item->features.background_color = cached_string(ListCacheReader_GetString(reader), default_background_color);
+        item->features.background_image = cached_string(ListCacheReader_GetString(reader), default_background_image);
+        item->features.confirm_text = cached_string(ListCacheReader_GetString(reader), confirm_text);
+        uint8_t alignment = ListCacheReader_GetU8(reader);
+        ListItemFeature_UnpackFlags(&item->features, ListCacheReader_GetU32(reader));
+        if (item->features.background_color == NULL || item->features.background_image == NULL || item->features.confirm_text == NULL || alignment > ALIGNMENT_RIGHT)
+            return false;
+        item->features.alignment = (enum ListItemAlignment)alignment;
+
+        uint32_t variant_count = ListCacheReader_GetCount(reader);
+        if (variant_count > 0)
+        {
+            item->image_variants = ListArena_Alloc(&state->arena, sizeof(struct ImageVariant) * variant_count);
+            if (item->image_variants == NULL)
+                return false;
+            for (uint32_t k = 0; k < variant_count; k++)
+            {
+                item->image_variants[k].resolution = ListCacheReader_GetString(reader);
+                item->image_variants[k].path = ListCacheReader_GetString(reader);
+                if (item->image_variants[k].resolution == NULL || item->image_variants[k].path == NULL)
+                    return false;
+            }
+        }
+        item->image_variant_count = (int)variant_count;
+
+        if (reader->failed)
+            return false;
+        if (item->has_options)
+        {
+            state->has_options = true;
+        }
+        state->item_count++;
+    }
+
+    // the warnings are checked in full before any is printed, so a malformed
+    // cache that falls back to parsing never logs them twice
+    uint32_t warning_count = ListCacheReader_GetCount(reader);
+    struct ListCacheReader warnings = *reader;
+    for (uint32_t k = 0; k < warning_count; k++)
+    {
+        if (ListCacheReader_GetString(reader) == NULL)
+            return false;
+    }
+    if (reader->failed || reader->p != reader->end)
+        return false;
+
+    for (uint32_t k = 0; k < warning_count; k++)
+    {
+        log_error(ListCacheReader_GetString(&warnings));
+    }
+
+    // apply the root settings exactly as ListState_LoadJSON does
+    state->selected = selected;
+    if (root_alphabetic_scroll)
+    {
+        app_state->alphabetic_scroll = true;
+        state->root_alphabetic_scroll = true;
+    }
+    if (root_scroll_method != NULL)
+    {
+        strncpy(app_state->scroll_method, root_scroll_method, sizeof(app_state->scroll_method) - 1);
+        app_state->scroll_method[sizeof(app_state->scroll_method) - 1] = '\0';
+        state->root_scroll_method = root_scroll_method;
+    }
+    return true;
+}
+
+// ListState_LoadCache loads the list from the cache file at path when it
+// matches key. On a miss or a malformed cache the state is left empty, ready
+// for a normal load.
+static bool ListState_LoadCache(struct ListState *state, const char *path, const struct ListCacheKey *key, const char *confirm_text, const char *default_background_image, const char *default_background_color, struct AppState *app_state)
+{
+    struct ListCacheReader reader;
+    if (!ListCache_Open(&state->input, path, key, &reader))
+        return false;
+
+    if (ListState_ReadCache(state, &reader, confirm_text, default_background_image, default_background_color, app_state))
+        return true;
+
+    ListArena_Free(&state->arena);
+    free(state->items);
+    state->items = NULL;
+    state->item_count = 0;
+    state->item_capacity = 0;
+    state->has_options = false;
+    ListInput_Close(&state->input);
+    return false;
+}
+
+// ListState_IndexRow fills in the row for item i, folding the item's search
+// key the first time it is indexed.
+static void ListState_IndexRow(struct ListState *state, size_t i)
+{
+    struct ListItem *item = &state->items[i];
+    if (item->search_key == NULL)
+    {
+        size_t length = strlen(item->name);
+        char *key = NULL;
+        if (!ListFilter_IsFolded(item->name, length))
+        {
+            key = ListArena_Alloc(&state->arena, length + 1);
+        }
+        if (key != NULL)
+        {
+            ListFilter_Fold(key, item->name, length);
+            key[length] = '\0';
+            item->search_key = key;
+        }
+        else
+        {
+            item->search_key = item->name;
+        }
+        item->search_key_length = (uint32_t)length;
+    }
+
+    unsigned char flags = 0;
+    if (item->features.is_header || item->features.unselectable)
+        flags |= LIST_ROW_SKIP;
+    if (item->features.is_header)
+        flags |= LIST_ROW_HEADER;
+    if (item->features.display_on_filter)
+        flags |= LIST_ROW_PINNED;
+    state->rows[i].key = item->search_key;
+    state->rows[i].key_length = item->search_key_length;
+    state->rows[i].flags = flags;
+}
+
+// ListState_IndexRows (re)builds the dense row array from the items. It runs
+// once the items are loaded and again whenever they are reordered, which also
+// drops a trigram index built over the old order.
+static void ListState_IndexRows(struct ListState *state)
+{
+    ListState_DropIndex(state);
+    free(state->rows);
+    size_t n = state->item_count > 0 ? state->item_count : 1;
+    state->rows = malloc(sizeof(struct ListRow) * n);
+    for (size_t i = 0; i < state->item_count; i++)
+    {
+        ListState_IndexRow(state, i);
+    }
+}
+
+// ListState_RowSkipped reports whether selection must skip the item at display
+// position k (a header or unselectable item).
+static bool ListState_RowSkipped(const struct ListState *state, int k)
+{
+    return (state->rows[state->visible[k]].flags & LIST_ROW_SKIP) != 0;
+}
+
+// ListState_New creates a new ListState from a JSON file
+// ListState_InitVisibleIdentity allocates the filtered-view index and sets it to
+// the identity mapping (every item visible, in source order) so an unfiltered
+// list behaves exactly as it did before filtering existed.
+static void ListState_InitVisibleIdentity(struct ListState *state)
+{
+    size_t n = state->item_count > 0 ? state->item_count : 1;
+    state->visible = malloc(sizeof(int) * n);
+    state->visible_count = (int)state->item_count;
+    for (size_t i = 0; i < state->item_count; i++)
+    {
+        state->visible[i] = (int)i;
+    }
+}
+
+// ListItem_FromTextLine builds a text-format item from line. The name and any
+// tab-separated key=value feature columns are split in place by ListColumns_Parse,
+// so the item points straight into the line's buffer, which the list keeps for
+// its lifetime. A line without valid columns becomes a plain item named by the
+// whole line.
+static void ListItem_FromTextLine(struct ListItem *item, struct ListArena *arena, char *line, const char *confirm_text, const char *default_background_image, const char *default_background_color)
+{
+    struct ListColumnsLine parsed;
+    ListColumns_Parse(line, &parsed);
+    ListItem_InitDefaults(item, parsed.name, confirm_text);
+    ListItem_SetDefaultBackground(item, default_background_image, default_background_color);
+    if (parsed.count == 0)
+    {
+        return;
+    }
+
+    item->has_features = true;
+    item->features.has_background_image = default_background_image != NULL;
+    item->features.has_background_color = default_background_color != NULL;
+    for (size_t i = 0; i < parsed.count; i++)
+    {
+        char *value = parsed.columns[i].value;
+        bool enabled = strcmp(value, "true") == 0;
+        switch (parsed.columns[i].key)
+        {
+        case LIST_COLUMN_ALIGNMENT:
+            item->features.alignment = strcmp(value, "center") == 0  ? ALIGNMENT_CENTER
+                                       : strcmp(value, "right") == 0 ? ALIGNMENT_RIGHT
+                                                                     : ALIGNMENT_LEFT;
+            item->features.has_alignment = true;
+            break;
+        case LIST_COLUMN_BACKGROUND_COLOR:
+            item->features.background_color = value;
+            item->features.has_background_color = true;
+            break;
+        case LIST_COLUMN_BACKGROUND_IMAGE:
+            item->features.background_image = value;
+            item->features.has_background_image = true;
+            break;
+        case LIST_COLUMN_CAN_DISABLE:
+            item->features.can_disable = enabled;
+            item->features.has_can_disable = true;
+            break;
+        case LIST_COLUMN_CONFIRM_TEXT:
+            item->features.confirm_text = value;
+            item->features.has_confirm_text = true;
+            break;
+        case LIST_COLUMN_DISABLED:
+            item->features.disabled = enabled;
+            item->features.has_disabled = true;
+            break;
+        case LIST_COLUMN_DISPLAY_ON_FILTER:
+            item->features.display_on_filter = enabled;
+            item->features.has_display_on_filter = true;
+            break;
+        case LIST_COLUMN_DRAW_ARROWS:
+            item->features.draw_arrows = enabled;
+            item->features.has_draw_arrows = true;
+            break;
+        case LIST_COLUMN_HIDE_ACTION:
+            item->features.hide_action = enabled;
+            item->features.has_hide_action = true;
+            break;
+        case LIST_COLUMN_HIDE_CANCEL:
+            item->features.hide_cancel = enabled;
+            item->features.has_hide_cancel = true;
+            break;
+        case LIST_COLUMN_HIDE_CONFIRM:
+            item->features.hide_confirm = enabled;
+            item->features.has_hide_confirm = true;
+            break;
+        case LIST_COLUMN_IMAGE:
+            // the path is used in place as the item's only (default) variant
+            if (item->image_variants == NULL)
+            {
+                item->image_variants = ListArena_Alloc(arena, sizeof(struct ImageVariant));
+            }
+            if (item->image_variants != NULL)
+            {
+                item->image_variants[0] = (struct ImageVariant){"default", value};
+                item->image_variant_count = 1;
+                item->has_image = true;
+            }
+            break;
+        case LIST_COLUMN_IS_HEADER:
+            item->features.is_header = enabled;
+            item->features.has_is_header = true;
+            break;
+        case LIST_COLUMN_SHOW_CONFIRM:
+            item->features.show_confirm = enabled;
+            item->features.has_show_confirm = true;
+            break;
+        case LIST_COLUMN_UNSELECTABLE:
+            item->features.unselectable = enabled;
+            item->features.has_unselectable = true;
+            break;
+        }
+    }
+
+    // headers are not selectable, as in ListItem_ReadFeatures; this comes after
+    // the columns so an unselectable=false column cannot undo it
+    if (item->features.is_header)
+    {
+        item->features.unselectable = true;
+    }
+}
+
+// ListState_AppendJSONLine parses one line of a jsonl list and appends the
+// item it holds. Blank lines are skipped. A malformed line is reported with
+// its line number and skipped, so one bad line does not lose the rest of the
+// list.
+static void ListState_AppendJSONLine(struct ListState *state, char *line, size_t line_number)
+{
+    char *p;
+    for (p = line; *p != '\0' && isspace(*p); p++)
+        ;
+    if (*p == '\0')
+    {
+        return;
+    }
+
+    char error_message[512];
+    JSON_Value *element = json_parse_string_with_comments(line);
+    if (element == NULL)
+    {
+        snprintf(error_message, sizeof(error_message), "Line %zu is not valid JSON", line_number);
+        log_error(error_message);
+        return;
+    }
+
+    struct ListItem *item = ListState_AppendItem(state);
+    if (ListItem_FromJSON(item, &state->arena, &state->load_option_tables, element, line_number, true, NULL, state->load_confirm_text, state->load_background_image, state->load_background_color, error_message, sizeof(error_message)))
+    {
+        state->has_options = state->has_options || item->has_options;
+        state->item_count++;
+    }
+    else
+    {
+        log_error(error_message);
+    }
+    json_value_free(element);
+}
+
+// ListState_LoadSource builds the list from the entries of --source-dir,
+// sorted by name the way --alphabetic-scroll sorts. With --source-image-dir,
+// each item gets <image dir>/<stem>.png as its default image and
+// <image dir>/<WxH>/<stem>.png for every resolution subdirectory. None of
+// those paths are checked here; image_effective_path checks them once the
+// item is drawn.
+static bool ListState_LoadSource(struct ListState *state, struct AppState *app_state)
+{
+    struct ListSource source;
+    if (!ListSource_Read(&source, &state->arena, app_state->source_dir, app_state->source_extensions, false))
+    {
+        ListSource_Free(&source);
+        log_error("Failed to read source directory");
+        return false;
+    }
+
+    // the resolution subdirectories are read once for the whole list. An
+    // unreadable image directory just means no image ever exists.
+    struct ListSource resolutions = {0};
+    const char *image_dir = app_state->source_image_dir;
+    if (image_dir[0] != '\0')
+    {
+        ListSource_Read(&resolutions, &state->arena, image_dir, NULL, true);
+        size_t kept = 0;
+        for (size_t r = 0; r < resolutions.count; r++)
+        {
+            if (ListSource_IsResolution(resolutions.names[r]))
+            {
+                resolutions.names[kept++] = resolutions.names[r];
+            }
+        }
+        resolutions.count = kept;
+    }
+
+    for (size_t i = 0; i < source.count; i++)
+    {
+        struct ListItem *item = ListState_AppendItem(state);
+        ListItem_InitDefaults(item, (char *)source.names[i], state->load_confirm_text);
+        ListItem_SetDefaultBackground(item, state->load_background_image, state->load_background_color);
+        state->item_count++;
+        if (image_dir[0] == '\0')
+            continue;
+
+        item->image_variants = ListArena_Alloc(&state->arena, sizeof(struct ImageVariant) * (resolutions.count + 1));
+        if (item->image_variants == NULL)
+            continue;
+
+        char path[PATH_MAX];
+        int stem = (int)ListSource_StemLength(item->name);
+        snprintf(path, sizeof(path), "%s/%.*s.png", image_dir, stem, item->name);
+        item->image_variants[0] = (struct ImageVariant){"default", ListArena_Strdup(&state->arena, path)};
+        for (size_t r = 0; r < resolutions.count; r++)
+        {
+            snprintf(path, sizeof(path), "%s/%s/%.*s.png", image_dir, resolutions.names[r], stem, item->name);
+            item->image_variants[r + 1] = (struct ImageVariant){resolutions.names[r], ListArena_Strdup(&state->arena, path)};
+        }
+        item->image_variant_count = (int)resolutions.count + 1;
+        item->has_image = true;
+    }
+    ListSource_Free(&resolutions);
+    ListSource_Free(&source);
+
+    qsort(state->items, state->item_count, sizeof(struct ListItem), compare_items_alphabetic);
+    return true;
+}
+
+struct ListState *ListState_New(const char *filename, const char *format, const char *item_key, const char *confirm_text, const char *default_background_image, const char *default_background_color, struct AppState *app_state)
+{
+    struct ListState *state = malloc(sizeof(struct ListState));
+    state->items = NULL;
+    state->item_count = 0;
+    state->item_capacity = 0;
+    state->has_options = false;
+    state->input = (struct ListInput){0};
+    ListArena_Init(&state->arena);
+    state->root_alphabetic_scroll = false;
+    state->root_scroll_method = NULL;
+    state->loader = NULL;
+    state->loading = false;
+    state->load_jsonl = strcmp(format, "jsonl") == 0;
+    state->load_line = 0;
+    state->load_held = NULL;
+    state->load_held_count = 0;
+    state->load_held_done = false;
+    ListOptionTables_Init(&state->load_option_tables, &state->arena);
+    state->load_confirm_text = confirm_text;
+    state->load_background_image = default_background_image;
+    state->load_background_color = default_background_color;
+    state->selected = -1;
+    state->image_resolution[0] = '\0';
+    state->first_visible = 0;
+    state->last_visible = 0;
+    state->rows = NULL;
+    state->visible = NULL;
+    state->visible_count = 0;
+    ListFilter_Prepare(&state->filter_query, NULL);
+    state->filter_mode = ListFilter_ParseMode(app_state->filter_mode);
+    ListFilterHistory_Init(&state->filter_history);
+    state->filter_index = NULL;
+    state->filter_worker.running = false;
+    state->filter_job.id = 0;
+    state->filter_job.visible = NULL;
+
+    if (app_state->source_dir[0] != '\0')
+    {
+        if (!ListState_LoadSource(state, app_state))
+        {
+            ListState_Free(state);
+            return NULL;
+        }
+
+        ListState_IndexRows(state);
+        ListState_InitVisibleIdentity(state);
+        return state;
+    }
+
+    if ((strcmp(format, "text") == 0 || state->load_jsonl) && app_state->progressive_load)
+    {
+        // read on a background thread; ListState_PollLoader adds the items as
+        // they arrive
+        int fd = strcmp(filename, "-") == 0 ? STDIN_FILENO : open(filename, O_RDONLY);
+        state->loader = malloc(sizeof(struct ListLoader));
+        if (fd < 0 || state->loader == NULL || !ListLoader_Start(state->loader, fd, fd != STDIN_FILENO, state->load_jsonl))
+        {
+            log_error("Failed to read file or stdin");
+            if (fd > STDIN_FILENO)
+                close(fd);
+            free(state->loader);
+            free(state);
+            return NULL;
+        }
+        state->loading = true;
+
+        ListState_IndexRows(state);
+        ListState_InitVisibleIdentity(state);
+        return state;
+    }
+
+    if (strcmp(format, "text") == 0)
+    {
+        bool opened;
+        if (strcmp(filename, "-") == 0)
+        {
+            opened = ListInput_OpenFd(&state->input, STDIN_FILENO, false);
+        }
+        else
+        {
+            opened = ListInput_OpenFile(&state->input, filename);
+        }
+
+        if (!opened)
+        {
+            log_error("Failed to read file or stdin");
+            free(state);
+            return NULL;
+        }
+
+        // Add non-empty lines to items array in a single pass. Each line is
+        // terminated in place and the item name (and any feature column
+        // values) point straight into the input buffer, which the list keeps
+        // for its lifetime.
+        char *cursor = state->input.data;
+        char *end = state->input.data + state->input.size;
+        char *line;
+        while ((line = ListInput_NextLine(&cursor, end)) != NULL)
+        {
+            // Check if line has non-whitespace content
+            char *p;
+            for (p = line; *p != '\0' && isspace(*p); p++)
+                ;
+            if (*p == '\0')
+            {
+                continue;
+            }
+
+            struct ListItem *item = ListState_AppendItem(state);
+            ListItem_FromTextLine(item, &state->arena, line, confirm_text, default_background_image, default_background_color);
+            state->item_count++;
+        }
+
+        ListState_IndexRows(state);
+        ListState_InitVisibleIdentity(state);
+        return state;
+    }
+
+    if (state->load_jsonl)
+    {
+        struct ListInput input;
+        bool opened;
+        if (strcmp(filename, "-") == 0)
+        {
+            opened = ListInput_OpenFd(&input, STDIN_FILENO, false);
+        }
+        else
+        {
+            opened = ListInput_OpenFile(&input, filename);
+        }
+
+        if (!opened)
+        {
+            log_error("Failed to read file or stdin");
+            ListState_Free(state);
+            return NULL;
+        }
+
+        // each line is an item of its own, parsed in place. Items copy what
+        // they keep into the arena, so the input is released afterwards.
+        char *cursor = input.data;
+        char *end = input.data + input.size;
+        char *line;
+        while ((line = ListInput_NextLine(&cursor, end)) != NULL)
+        {
+            ListState_AppendJSONLine(state, line, ++state->load_line);
+        }
+        ListInput_Close(&input);
+
+        ListState_IndexRows(state);
+        ListState_InitVisibleIdentity(state);
+        return state;
+    }
+
+    struct ListInput input;
+    if (strcmp(filename, "-") == 0)
+    {
+        if (!ListInput_OpenFd(&input, STDIN_FILENO, false))
+        {
+            log_error("Failed to read stdin");
+            free(state);
+            return NULL;
+        }
+    }
+    else
+    {
+        if (!ListInput_OpenFile(&input, filename))
+        {
+            log_error("Failed to parse JSON file");
+            free(state);
+            return NULL;
+        }
+    }
 
-                // read in the can_disable from the json object
-                // if there is no can_disable, set it to false
-                // if there is a can_disable, treat it as a boolean
-                if (json_object_get_boolean(features, "can_disable") == 1)
-                {
-                    state->items[i].features.can_disable = true;
-                    state->items[i].features.has_can_disable = true;
-                }
-                else if (json_object_get_boolean(features, "can_disable") == 0)
-                {
-                    state->items[i].features.can_disable = false;
-                    state->items[i].features.has_can_disable = true;
-                }
-                else
-                {
-                    state->items[i].features.can_disable = false;
-                    state->items[i].features.has_can_disable = false;
-                }
+    // with --cache-dir, an unchanged list is rebuilt from its cache instead
+    // of being parsed. The source is still read so its contents can be hashed.
+    char cache_path[PATH_MAX];
+    struct ListCacheKey cache_key;
+    struct stat source_stat;
+    bool use_cache = app_state->cache_dir[0] != '\0' && strcmp(filename, "-") != 0 &&
+                     stat(filename, &source_stat) == 0 &&
+                     ListCache_Path(cache_path, sizeof(cache_path), app_state->cache_dir, filename);
+    if (use_cache)
+    {
+        ListCache_KeyFromSource(&cache_key, &source_stat, input.data, input.size);
+        cache_key.settings_hash = ListState_CacheSettingsHash(item_key, confirm_text, default_background_image, default_background_color);
+        if (ListState_LoadCache(state, cache_path, &cache_key, confirm_text, default_background_image, default_background_color, app_state))
+        {
+            ListInput_Close(&input);
+            ListState_IndexRows(state);
+            ListState_InitVisibleIdentity(state);
+            return state;
+        }
+    }
 
-                // read in the disabled from the json object
-                // if there is no disabled, set it to false
-                // if there is an disabled, treat it as a boolean
-                if (json_object_get_boolean(features, "disabled") == 1)
-                {
-                    state->items[i].features.disabled = true;
-                    state->items[i].features.has_disabled = true;
-                }
-                else if (json_object_get_boolean(features, "disabled") == 0)
-                {
-                    state->items[i].features.disabled = false;
-                    state->items[i].features.has_disabled = true;
-                    if (!state->items[i].features.can_disable)
-                    {
-                        char error_message[256];
-                        snprintf(error_message, sizeof(error_message), "Item %s has no can_disable, but is disabled", state->items[i].name);
-                        log_error(error_message);
-                    }
-                }
-                else
-                {
-                    state->items[i].features.disabled = false;
-                    state->items[i].features.has_disabled = false;
-                }
+    struct ListCacheWriter warnings;
+    ListCacheWriter_Init(&warnings);
+    if (use_cache)
+    {
+        log_capture = &warnings;
+        log_capture_count = 0;
+    }
+    bool loaded = ListState_LoadJSON(state, input.data, item_key, confirm_text, default_background_image, default_background_color, app_state);
+    log_capture = NULL;
+    ListInput_Close(&input);
+    if (!loaded)
+    {
+        ListCacheWriter_Free(&warnings);
+        ListState_Free(state);
+        return NULL;
+    }
 
-                // read in the draw_arrows from the json object
-                // if there is no draw_arrows, set it to false
-                // if there is a draw_arrows, treat it as a boolean
-                if (json_object_get_boolean(features, "draw_arrows") == 1)
-                {
-                    state->items[i].features.draw_arrows = true;
-                    state->items[i].features.has_draw_arrows = true;
-                }
-                else if (json_object_get_boolean(features, "draw_arrows") == 0)
-                {
-                    state->items[i].features.draw_arrows = false;
-                    state->items[i].features.has_draw_arrows = true;
-                }
-                else
-                {
-                    state->items[i].features.draw_arrows = false;
-                    state->items[i].features.has_draw_arrows = false;
-                }
+    bool cached = !use_cache || ListState_WriteCache(state, cache_path, &cache_key, &warnings, log_capture_count);
+    ListCacheWriter_Free(&warnings);
+    if (!cached)
+    {
+        char error_message[PATH_MAX + 64];
+        snprintf(error_message, sizeof(error_message), "Failed to write list cache %s", cache_path);
+        log_error(error_message);
+    }
 
-                // read in the hide_action from the json object
-                // if there is no hide_action, set it to false
-                // if there is a hide_action, treat it as a boolean
-                if (json_object_get_boolean(features, "hide_action") == 1)
-                {
-                    state->items[i].features.hide_action = true;
-                    state->items[i].features.has_hide_action = true;
-                }
-                else if (json_object_get_boolean(features, "hide_action") == 0)
-                {
-                    state->items[i].features.hide_action = false;
-                    state->items[i].features.has_hide_action = true;
-                }
-                else
-                {
-                    state->items[i].features.hide_action = false;
-                    state->items[i].features.has_hide_action = false;
-                }
+    ListState_IndexRows(state);
+    ListState_InitVisibleIdentity(state);
+    return state;
+}
 
-                // read in the hide_cancel from the json object
-                // if there is no hide_cancel, set it to false
-                // if there is a hide_cancel, treat it as a boolean
-                if (json_object_get_boolean(features, "hide_cancel") == 1)
-                {
-                    state->items[i].features.hide_cancel = true;
-                    state->items[i].features.has_hide_cancel = true;
-                }
-                else if (json_object_get_boolean(features, "hide_cancel") == 0)
-                {
-                    state->items[i].features.hide_cancel = false;
-                    state->items[i].features.has_hide_cancel = true;
-                }
-                else
-                {
-                    state->items[i].features.hide_cancel = false;
-                    state->items[i].features.has_hide_cancel = false;
-                }
+// ListState_InitView validates selection and computes the initial visible window.
+// It operates on display positions (indices into visible[]); with no active
+// filter visible[] is the identity, so this behaves exactly as before.
+void ListState_InitView(struct ListState *state, int max_row_count)
+{
+    // validate selection: must point to a selectable, currently-visible item
+    int first_valid = -1;
+    bool selection_is_valid = false;
+    for (int k = 0; k < state->visible_count; k++)
+    {
+        if (!ListState_RowSkipped(state, k))
+        {
+            if (first_valid < 0)
+            {
+                first_valid = k;
+            }
+            if (k == state->selected)
+            {
+                selection_is_valid = true;
+            }
+        }
+    }
 
-                // read in the hide_confirm from the json object
-                // if there is no hide_confirm, set it to false
-                // if there is a hide_confirm, treat it as a boolean
-                if (json_object_get_boolean(features, "hide_confirm") == 1)
-                {
-                    state->items[i].features.hide_confirm = true;
-                    state->items[i].features.has_hide_confirm = true;
-                }
-                else if (json_object_get_boolean(features, "hide_confirm") == 0)
-                {
-                    state->items[i].features.hide_confirm = false;
-                    state->items[i].features.has_hide_confirm = true;
-                }
-                else
-                {
-                    state->items[i].features.hide_confirm = false;
-                    state->items[i].features.has_hide_confirm = false;
-                }
+    if (!selection_is_valid)
+    {
+        state->selected = (first_valid >= 0) ? first_valid : -1;
+    }
 
-                // read in the show_confirm from the json object
-                // if there is no show_confirm, set it to false
-                // if there is a show_confirm, treat it as a boolean
-                if (json_object_get_boolean(features, "show_confirm") == 1)
-                {
-                    state->items[i].features.show_confirm = true;
-                    state->items[i].features.has_show_confirm = true;
-                }
-                else if (json_object_get_boolean(features, "show_confirm") == 0)
-                {
-                    state->items[i].features.show_confirm = false;
-                    state->items[i].features.has_show_confirm = true;
-                }
-                else
-                {
-                    state->items[i].features.show_confirm = false;
-                    state->items[i].features.has_show_confirm = false;
-                }
+    // compute the visible window over the display positions
+    int count = state->visible_count;
+    if (count <= max_row_count)
+    {
+        state->first_visible = 0;
+        state->last_visible = count;
+    }
+    else
+    {
+        // try to center the selection (selected is >= 0 here since count > 0
+        // and, when nothing selectable matched, first_valid handling above left
+        // selected at -1 only when count is small enough for the branch above)
+        int anchor = state->selected >= 0 ? state->selected : 0;
+        state->first_visible = anchor - max_row_count / 2;
+        if (state->first_visible < 0)
+        {
+            state->first_visible = 0;
+        }
 
-                // read in the unselectable from the json object
-                // if there is no unselectable, set it to false
-                // if there is a unselectable, treat it as a boolean
-                if (json_object_get_boolean(features, "unselectable") == 1)
-                {
-                    state->items[i].features.unselectable = true;
-                    state->items[i].features.has_unselectable = true;
-                }
-                else if (json_object_get_boolean(features, "unselectable") == 0)
-                {
-                    state->items[i].features.unselectable = false;
-                    state->items[i].features.has_unselectable = true;
-                }
-                else
-                {
-                    state->items[i].features.unselectable = false;
-                    state->items[i].features.has_unselectable = false;
-                }
+        state->last_visible = state->first_visible + max_row_count;
+        if (state->last_visible > count)
+        {
+            state->last_visible = count;
+            state->first_visible = state->last_visible - max_row_count;
+        }
+    }
+}
 
-                // read in the is_header from the json object
-                // if there is no is_header, set it to false
-                // if there is a is_header, treat it as a boolean
-                // headers are not selectable, so this has to go last such that we can set the unselectable flag
-                if (json_object_get_boolean(features, "is_header") == 1)
-                {
-                    state->items[i].features.is_header = true;
-                    state->items[i].features.has_is_header = true;
-                    state->items[i].features.unselectable = true;
-                }
-                else if (json_object_get_boolean(features, "is_header") == 0)
-                {
-                    state->items[i].features.is_header = false;
-                    state->items[i].features.has_is_header = true;
-                }
-                else
-                {
-                    state->items[i].features.is_header = false;
-                    state->items[i].features.has_is_header = false;
-                }
+// ListFilterRank pairs an item with its fuzzy match score while the filtered
+// view is ranked.
+struct ListFilterRank
+{
+    int score;
+    int index;
+};
 
-                // read in the display_on_filter from the json object
-                // if there is no display_on_filter, set it to false
-                // if there is a display_on_filter, treat it as a boolean
-                if (json_object_get_boolean(features, "display_on_filter") == 1)
-                {
-                    state->items[i].features.display_on_filter = true;
-                    state->items[i].features.has_display_on_filter = true;
-                }
-                else if (json_object_get_boolean(features, "display_on_filter") == 0)
-                {
-                    state->items[i].features.display_on_filter = false;
-                    state->items[i].features.has_display_on_filter = true;
-                }
-                else
-                {
-                    state->items[i].features.display_on_filter = false;
-                    state->items[i].features.has_display_on_filter = false;
-                }
+// compare_ranks orders ranks best score first, then in list order.
+static int compare_ranks(const void *a, const void *b)
+{
+    const struct ListFilterRank *x = a;
+    const struct ListFilterRank *y = b;
+    if (x->score != y->score)
+        return x->score > y->score ? -1 : 1;
+    return x->index - y->index;
+}
 
-                // read in the alignment from the json object
-                // if there is no alignment, set it to 'left'
-                // if there is a alignment, it should be 'left', 'center', or 'right'
-                const char *alignment = json_object_get_string(features, "alignment");
-                if (alignment != NULL)
-                {
-                    if (strcmp(alignment, "left") == 0 || strcmp(alignment, "center") == 0 || strcmp(alignment, "right") == 0)
-                    {
-                        strncpy(state->items[i].features.alignment, alignment, sizeof(state->items[i].features.alignment) - 1);
-                        state->items[i].features.has_alignment = true;
-                    }
-                    else
-                    {
-                        char error_message[256];
-                        snprintf(error_message, sizeof(error_message), "Item %s has invalid alignment %s. Must be 'left', 'center', or 'right'. Using default (left).", state->items[i].name, alignment);
-                        log_error(error_message);
-                        strncpy(state->items[i].features.alignment, "left", sizeof(state->items[i].features.alignment) - 1);
-                        state->items[i].features.has_alignment = false;
-                    }
-                }
-                else
-                {
-                    strncpy(state->items[i].features.alignment, "left", sizeof(state->items[i].features.alignment) - 1);
-                    state->items[i].features.has_alignment = false;
-                }
+// ListState_Ranked reports whether the active query orders the filtered view
+// by score rather than list order.
+static bool ListState_Ranked(const struct ListState *state)
+{
+    return state->filter_mode == LIST_FILTER_FUZZY && state->filter_query.length > 0;
+}
 
-                // read in the alignment from the json object
-                // if there is no alignment, set it to 'left'
-                // if there is a alignment, it should be 'left', 'center', or 'right'
-                const char *confirm_text = json_object_get_string(features, "confirm_text");
-                if (confirm_text != NULL)
-                {
-                    if (strlen(confirm_text) > 0)
-                    {
-                        strncpy(state->items[i].features.confirm_text, confirm_text, sizeof(state->items[i].features.confirm_text) - 1);
-                        state->items[i].features.has_confirm_text = true;
-                    }
-                }
-            }
-            else
+// how many items a filter pass on the filter worker matches between checks
+// that it has not been superseded
+#define LIST_FILTER_CANCEL_STRIDE 1024
+
+// filter_cancelled reports whether the filter pass running as job should stop
+// before matching its k-th item. Passes run on the UI thread (worker NULL)
+// always finish.
+static bool filter_cancelled(struct ListWorker *worker, unsigned long job, size_t k)
+{
+    return worker != NULL && k % LIST_FILTER_CANCEL_STRIDE == 0 && ListWorker_Cancelled(worker, job);
+}
+
+// ListState_Rank returns the items that fuzzily match query among the
+// from_count source indices at from and the items from index first on, best
+// match first, as a malloc'd array of *count source indices. Pinned rows come
+// before every match and headers are left out, as with substring matching.
+// Returns NULL when memory runs out or the pass is cancelled.
+static int *ListState_Rank(const struct ListState *state, const struct ListFilterQuery *query,
+                           const int *from, int from_count, size_t first, int *count,
+                           struct ListWorker *worker, unsigned long job)
+{
+    size_t total = from_count + (first < state->item_count ? state->item_count - first : 0);
+    struct ListFilterRank *ranks = malloc(sizeof(struct ListFilterRank) * (total > 0 ? total : 1));
+    if (ranks == NULL)
+        return NULL;
+
+    size_t ranked = 0;
+    for (size_t k = 0; k < total; k++)
+    {
+        if (filter_cancelled(worker, job, k))
+        {
+            free(ranks);
+            return NULL;
+        }
+        int i = k < (size_t)from_count ? from[k] : (int)(first + (k - from_count));
+        const struct ListRow *row = &state->rows[i];
+        int score = INT_MAX;
+        if ((row->flags & LIST_ROW_PINNED) == 0)
+        {
+            if ((row->flags & LIST_ROW_HEADER) != 0 ||
+                !ListFilter_FuzzyMatch(state->items[i].name, row->key, row->key_length, query, &score, NULL))
             {
-                if (default_background_image != NULL)
-                {
-                    strncpy(state->items[i].features.background_image, default_background_image, sizeof(state->items[i].features.background_image) - 1);
-                    if (access(default_background_image, F_OK) != -1)
-                    {
-                        state->items[i].features.background_image_exists = true;
-                    }
-                    state->items[i].features.has_background_image = true;
-                }
-                else
-                {
-                    state->items[i].features.has_background_image = false;
-                }
+                continue;
+            }
+        }
+        ranks[ranked++] = (struct ListFilterRank){score, i};
+    }
+    qsort(ranks, ranked, sizeof(struct ListFilterRank), compare_ranks);
 
-                if (default_background_color != NULL)
-                {
-                    strncpy(state->items[i].features.background_color, default_background_color, sizeof(state->items[i].features.background_color) - 1);
-                    state->items[i].features.has_background_color = true;
-                }
-                else
-                {
-                    state->items[i].features.has_background_color = false;
-                }
+    int *visible = malloc(sizeof(int) * (ranked > 0 ? ranked : 1));
+    if (visible != NULL)
+    {
+        for (size_t k = 0; k < ranked; k++)
+        {
+            visible[k] = ranks[k].index;
+        }
+        *count = (int)ranked;
+    }
+    free(ranks);
+    return visible;
+}
+
+// ListState_Scan returns the items that match query among the from_count
+// source indices at from and the items from index first on, in that order, as
+// a malloc'd array of *count source indices. Returns NULL when memory runs
+// out or the pass is cancelled.
+static int *ListState_Scan(const struct ListState *state, const struct ListFilterQuery *query,
+                           const int *from, int from_count, size_t first, int *count,
+                           struct ListWorker *worker, unsigned long job)
+{
+    size_t total = from_count + (first < state->item_count ? state->item_count - first : 0);
+    int *visible = malloc(sizeof(int) * (total > 0 ? total : 1));
+    if (visible == NULL)
+        return NULL;
+
+    *count = 0;
+    for (size_t k = 0; k < total; k++)
+    {
+        if (filter_cancelled(worker, job, k))
+        {
+            free(visible);
+            return NULL;
+        }
+        int i = k < (size_t)from_count ? from[k] : (int)(first + (k - from_count));
+        const struct ListRow *row = &state->rows[i];
+        if (ListFilter_KeyVisible((row->flags & LIST_ROW_HEADER) != 0,
+                                  (row->flags & LIST_ROW_PINNED) != 0,
+                                  row->key, row->key_length, query))
+        {
+            visible[(*count)++] = i;
+        }
+    }
+    return visible;
+}
+
+// ListState_FilterFrom appends the items from index first on that match the
+// active filter query to the filtered view. A fuzzy query ranks them in with
+// the items already there. When memory runs out the view is left as it was.
+static void ListState_FilterFrom(struct ListState *state, size_t first)
+{
+    if (first >= state->item_count)
+        return;
+    if (ListState_Ranked(state))
+    {
+        int count = 0;
+        int *ranked = ListState_Rank(state, &state->filter_query, state->visible, state->visible_count, first, &count, NULL, 0);
+        if (ranked != NULL)
+        {
+            free(state->visible);
+            state->visible = ranked;
+            state->visible_count = count;
+        }
+        return;
+    }
+
+    int *visible = realloc(state->visible, sizeof(int) * (state->visible_count + (state->item_count - first)));
+    if (visible == NULL)
+        return;
+    state->visible = visible;
+    for (size_t i = first; i < state->item_count; i++)
+    {
+        const struct ListRow *row = &state->rows[i];
+        if (ListFilter_KeyVisible((row->flags & LIST_ROW_HEADER) != 0,
+                                  (row->flags & LIST_ROW_PINNED) != 0,
+                                  row->key, row->key_length, &state->filter_query))
+        {
+            state->visible[state->visible_count++] = (int)i;
+        }
+    }
+}
+
+// ListState_IndexKey hands ListTrigramIndex_Build the search key of row i.
+// Headers are never visible while filtering, so they are left out, and
+// pinned rows are candidates for every query.
+static const char *ListState_IndexKey(void *context, size_t i, size_t *length, bool *always)
+{
+    const struct ListRow *row = &((const struct ListState *)context)->rows[i];
+    *always = (row->flags & LIST_ROW_PINNED) != 0;
+    *length = (row->flags & LIST_ROW_HEADER) != 0 ? 0 : row->key_length;
+    return row->key;
+}
+
+// ListState_BuildIndex builds the --filter-index trigram index over the rows
+// loaded so far. Returns false when memory runs out, leaving the list to be
+// filtered by scanning.
+static bool ListState_BuildIndex(struct ListState *state)
+{
+    ListState_DropIndex(state);
+    struct ListTrigramIndex *index = malloc(sizeof(struct ListTrigramIndex));
+    if (index == NULL)
+        return false;
+    if (!ListTrigramIndex_Build(index, state->item_count, ListState_IndexKey, state))
+    {
+        ListTrigramIndex_Free(index);
+        free(index);
+        return false;
+    }
+    state->filter_index = index;
+    return true;
+}
+
+// ListState_MatchIndexed returns the filtered view for query as a malloc'd
+// array of *count source indices, found by verifying the trigram index's
+// candidates and scanning the items a --progressive-load loader added after
+// the index was built. Returns NULL when there is no index, the query is too
+// short for it, it would not check fewer than limit items, or the pass is
+// cancelled.
+static int *ListState_MatchIndexed(const struct ListState *state, const struct ListFilterQuery *query, size_t limit, int *count,
+                                   struct ListWorker *worker, unsigned long job)
+{
+    const struct ListTrigramIndex *index = state->filter_index;
+    size_t estimate = ListTrigramIndex_Estimate(index, query->text, query->length);
+    if (estimate == SIZE_MAX)
+        return NULL;
+    size_t unindexed = state->item_count - index->item_count;
+    if (estimate + unindexed >= limit)
+        return NULL;
+
+    uint32_t *candidates = malloc(sizeof(uint32_t) * (estimate > 0 ? estimate : 1));
+    size_t candidate_count = SIZE_MAX;
+    if (candidates != NULL)
+        candidate_count = ListTrigramIndex_Candidates(index, query->text, query->length, candidates);
+    int *visible = NULL;
+    if (candidate_count != SIZE_MAX)
+    {
+        // the candidates are ascending source indices, like the unindexed tail
+        int *from = (int *)candidates;
+        for (size_t c = 0; c < candidate_count; c++)
+        {
+            from[c] = (int)candidates[c];
+        }
+        visible = ListState_Scan(state, query, from, (int)candidate_count, index->item_count, count, worker, job);
+    }
+    free(candidates);
+    return visible;
+}
+
+// ListState_Match returns the items that match query among the from_count
+// source indices at from and the items from index first on, as a malloc'd
+// array of *count source indices in display order: through the trigram index
+// when there is one and it leaves fewer items to check, otherwise by checking
+// each of them. It only reads the list, so it can run on the filter worker
+// (which passes itself as worker and the pass as job, so a superseded pass
+// stops early). Returns NULL when memory runs out or the pass is cancelled.
+static int *ListState_Match(const struct ListState *state, const struct ListFilterQuery *query,
+                            const int *from, int from_count, size_t first, int *count,
+                            struct ListWorker *worker, unsigned long job)
+{
+    if (state->filter_mode == LIST_FILTER_FUZZY && query->length > 0)
+        return ListState_Rank(state, query, from, from_count, first, count, worker, job);
+
+    if (state->filter_index != NULL)
+    {
+        size_t total = from_count + (first < state->item_count ? state->item_count - first : 0);
+        int *visible = ListState_MatchIndexed(state, query, total, count, worker, job);
+        if (visible != NULL || (worker != NULL && ListWorker_Cancelled(worker, job)))
+            return visible;
+    }
+    return ListState_Scan(state, query, from, from_count, first, count, worker, job);
+}
+
+// ListState_Reselect selects the item with source index source when it is
+// still visible (otherwise the first selectable visible item, or -1 when
+// nothing matches), and reframes the visible window.
+static void ListState_Reselect(struct ListState *state, int source, int max_row_count)
+{
+    state->selected = -1;
+    if (source >= 0)
+    {
+        for (int k = 0; k < state->visible_count; k++)
+        {
+            if (state->visible[k] == source)
+            {
+                state->selected = k;
+                break;
             }
-
-            // build the right-hand-side image variants for this item from
-            // features.images
-            ListItem_ReadImages(&state->items[i], json_object_get_object(item, "features"));
-            state->items[i].has_image = state->items[i].image_variant_count > 0;
         }
     }
 
-    state->item_count = item_count;
+    // validate the selection and reframe the window
+    ListState_InitView(state, max_row_count);
+}
+
+// ListState_SelectedSource returns the source index of the selected item, or
+// -1 when nothing is selected or the selection should not survive query (a
+// fuzzy query moves it to the best match, since the item selected before may
+// have dropped far down).
+static int ListState_SelectedSource(const struct ListState *state, const struct ListFilterQuery *query)
+{
+    if (state->selected < 0 || state->selected >= state->visible_count)
+        return -1;
+    if (state->filter_mode == LIST_FILTER_FUZZY && query->length > 0)
+        return -1;
+    return state->visible[state->selected];
+}
 
-    // read the requested initial selection from JSON (if any)
-    if (use_object_form)
+// ListState_ShowFilter makes visible, the count items matching query, the
+// filtered view. When it narrows the view shown until now, that view is kept
+// in filter_history; otherwise it is freed.
+static void ListState_ShowFilter(struct ListState *state, const struct ListFilterQuery *query,
+                                 int *visible, int count, bool narrows, int max_row_count)
+{
+    int source = ListState_SelectedSource(state, query);
+    if (!narrows || !ListFilterHistory_Push(&state->filter_history, &state->filter_query, state->visible, state->visible_count, state->item_count))
     {
-        JSON_Object *root_obj = json_value_get_object(root_value);
-        if (root_obj && json_object_has_value(root_obj, "selected"))
-        {
-            state->selected = (int)json_object_get_number(root_obj, "selected");
-        }
+        free(state->visible);
     }
+    state->visible = visible;
+    state->visible_count = count;
+    state->filter_query = *query;
+    ListState_Reselect(state, source, max_row_count);
+}
 
-    ListState_InitVisibleIdentity(state);
+// the fewest items worth filtering on the filter worker; smaller lists are
+// filtered on the UI thread, which is quicker than handing them over
+#define LIST_FILTER_WORKER_MIN_ITEMS 16384
 
-    json_value_free(root_value);
-    return state;
+// ListState_RunFilterJob is the filter worker's job: it matches
+// state->filter_job. A pass that runs out of memory still completes, with no
+// view to show.
+static bool ListState_RunFilterJob(void *context, struct ListWorker *worker, unsigned long job)
+{
+    struct ListState *state = context;
+    struct ListFilterJob *pass = &state->filter_job;
+    pass->visible = ListState_Match(state, &pass->query, pass->from, pass->from_count, pass->first,
+                                    &pass->visible_count, worker, job);
+    return pass->visible != NULL || !ListWorker_Cancelled(worker, job);
 }
 
-// ListState_InitView validates selection and computes the initial visible window.
-// It operates on display positions (indices into visible[]); with no active
-// filter visible[] is the identity, so this behaves exactly as before.
-void ListState_InitView(struct ListState *state, int max_row_count)
+// ListState_CancelFilter abandons the filter pass in flight, if any, waiting
+// for the worker to let go of the list. The view shown stays as it is.
+static void ListState_CancelFilter(struct ListState *state)
 {
-    // validate selection: must point to a selectable, currently-visible item
-    int first_valid = -1;
-    bool selection_is_valid = false;
-    for (int k = 0; k < state->visible_count; k++)
+    struct ListFilterJob *pass = &state->filter_job;
+    if (pass->id == 0)
+        return;
+
+    ListWorker_Cancel(&state->filter_worker);
+    ListWorker_Wait(&state->filter_worker);
+    if (ListWorker_Finished(&state->filter_worker, pass->id))
     {
-        struct ListItem *item = &state->items[state->visible[k]];
-        bool valid_for_selection = !item->features.is_header &&
-            !item->features.unselectable;
+        free(pass->visible);
+    }
+    pass->visible = NULL;
+    pass->id = 0;
+}
 
-        if (valid_for_selection)
-        {
-            if (first_valid < 0)
-            {
-                first_valid = k;
-            }
-            if (k == state->selected)
-            {
-                selection_is_valid = true;
-            }
-        }
+// ListState_PollFilter shows the result of the filter pass in flight once the
+// worker has finished it. Returns true when the view changed.
+bool ListState_PollFilter(struct ListState *state, int max_row_count)
+{
+    struct ListFilterJob *pass = &state->filter_job;
+    if (pass->id == 0 || !ListWorker_Finished(&state->filter_worker, pass->id))
+        return false;
+
+    pass->id = 0;
+    if (pass->visible == NULL)
+        return false;
+    ListState_ShowFilter(state, &pass->query, pass->visible, pass->visible_count, pass->narrows, max_row_count);
+    pass->visible = NULL;
+    return true;
+}
+
+// ListState_FinishFilter waits for the filter pass in flight, if any, and
+// shows its result, for when the view must match the filter text (such as
+// the keyboard closing).
+void ListState_FinishFilter(struct ListState *state, int max_row_count)
+{
+    if (state->filter_job.id == 0)
+        return;
+    ListWorker_Wait(&state->filter_worker);
+    ListState_PollFilter(state, max_row_count);
+}
+
+// ListState_StopFilter cancels any filter pass and stops the filter worker.
+static void ListState_StopFilter(struct ListState *state)
+{
+    ListState_CancelFilter(state);
+    ListWorker_Stop(&state->filter_worker);
+}
+
+// ListState_ApplyFilter rebuilds the filtered view for the given filter text,
+// preserving the current selection when it stays visible (otherwise moving to
+// the first selectable visible item, or -1 when nothing matches), and reframes
+// the visible window.
+//
+// Typing only ever narrows the view, so a query that extends the active one is
+// matched against the items still visible rather than the whole list, and the
+// view it narrowed from is kept in filter_history. Deleting back to a query
+// whose view was kept swaps that view back in without matching anything,
+// apart from items a --progressive-load loader has added since. With a
+// --filter-index, a query whose rarest trigram leaves fewer items to check
+// than either of those is matched against the index's candidates instead.
+//
+// With --filter-mode fuzzy the same views are kept, but each one is ordered
+// best match first (see ListState_Rank) and the selection moves to the best
+// match.
+//
+// On a list of LIST_FILTER_WORKER_MIN_ITEMS or more, matching runs on the
+// filter worker so the keyboard stays responsive: the view shown until now
+// stays up until ListState_PollFilter finds the new one ready, and each
+// keystroke cancels the pass still running for the one before.
+void ListState_ApplyFilter(struct ListState *state, const char *filter, int max_row_count)
+{
+    ListState_CancelFilter(state);
+
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, filter);
+
+    struct ListFilterLevel level;
+    if (ListFilterHistory_Take(&state->filter_history, &query, &level))
+    {
+        int source = ListState_SelectedSource(state, &query);
+        free(state->visible);
+        state->visible = level.visible;
+        state->visible_count = level.visible_count;
+        state->filter_query = query;
+        ListState_FilterFrom(state, level.item_count);
+        ListState_Reselect(state, source, max_row_count);
+        return;
     }
 
-    if (!selection_is_valid)
+    // a narrowing query only needs the items still visible; any other query
+    // is matched against the whole list
+    bool narrows = ListFilter_Narrows(&state->filter_query, &query);
+    const int *from = narrows ? state->visible : NULL;
+    int from_count = narrows ? state->visible_count : 0;
+    size_t first = narrows ? state->item_count : 0;
+
+    if (state->item_count >= LIST_FILTER_WORKER_MIN_ITEMS &&
+        (state->filter_worker.running || ListWorker_Start(&state->filter_worker, ListState_RunFilterJob, state)))
+    {
+        struct ListFilterJob *pass = &state->filter_job;
+        pass->query = query;
+        pass->from = from;
+        pass->from_count = from_count;
+        pass->first = first;
+        pass->narrows = narrows;
+        pass->visible = NULL;
+        pass->visible_count = 0;
+        pass->id = ListWorker_Submit(&state->filter_worker);
+        return;
+    }
+
+    int count = 0;
+    int *visible = ListState_Match(state, &query, from, from_count, first, &count, NULL, 0);
+    if (visible != NULL)
     {
-        state->selected = (first_valid >= 0) ? first_valid : -1;
+        ListState_ShowFilter(state, &query, visible, count, narrows, max_row_count);
     }
+}
 
-    // compute the visible window over the display positions
-    int count = state->visible_count;
-    if (count <= max_row_count)
+// ListState_ReserveRows grows the items and the row index, which is kept as
+// long as the item array, to hold at least count items. Returns false when
+// memory runs out; the items and rows already there are kept either way.
+static bool ListState_ReserveRows(struct ListState *state, size_t count)
+{
+    if (count > state->item_capacity)
     {
-        state->first_visible = 0;
-        state->last_visible = count;
+        size_t capacity = state->item_capacity > 0 ? state->item_capacity * 2 : 64;
+        if (capacity < count)
+            capacity = count;
+        struct ListItem *items = realloc(state->items, sizeof(struct ListItem) * capacity);
+        if (items == NULL)
+            return false;
+        state->items = items;
+        state->item_capacity = capacity;
     }
-    else
+
+    struct ListRow *rows = realloc(state->rows, sizeof(struct ListRow) * state->item_capacity);
+    if (rows == NULL)
+        return false;
+    state->rows = rows;
+    return true;
+}
+
+// ListState_PollLoader appends the items the --progressive-load loader has read
+// since the last poll. New items extend the row index and, when they match the
+// active filter, the filtered view. Returns true when items were added. The
+// items stay queued while a filter pass is in flight, since the filter worker
+// is reading the list, and when there is no memory to add them.
+bool ListState_PollLoader(struct ListState *state)
+{
+    if (!state->loading || state->filter_job.id != 0)
+        return false;
+
+    // a batch held back by an earlier poll goes first; the loader does not
+    // reuse its array until the next ListLoader_Poll
+    const char **names = state->load_held;
+    size_t count = state->load_held_count;
+    bool done = state->load_held_done;
+    if (count == 0)
     {
-        // try to center the selection (selected is >= 0 here since count > 0
-        // and, when nothing selectable matched, first_valid handling above left
-        // selected at -1 only when count is small enough for the branch above)
-        int anchor = state->selected >= 0 ? state->selected : 0;
-        state->first_visible = anchor - max_row_count / 2;
-        if (state->first_visible < 0)
+        count = ListLoader_Poll(state->loader, &names, &done);
+    }
+
+    // make room for the whole batch in the items and the row index before
+    // adding any of it (a jsonl line adds one item at most), holding the batch
+    // back when there is no memory for it
+    if (count > 0 && !ListState_ReserveRows(state, state->item_count + count))
+    {
+        state->load_held = names;
+        state->load_held_count = count;
+        state->load_held_done = done;
+        return false;
+    }
+    state->load_held_count = 0;
+
+    if (done)
+    {
+        state->loading = false;
+        if (state->loader->failed)
         {
-            state->first_visible = 0;
+            log_error("Failed to read file or stdin");
         }
+    }
+    if (count == 0)
+        return false;
 
-        state->last_visible = state->first_visible + max_row_count;
-        if (state->last_visible > count)
+    size_t first_new = state->item_count;
+    for (size_t k = 0; k < count; k++)
+    {
+        if (state->load_jsonl)
         {
-            state->last_visible = count;
-            state->first_visible = state->last_visible - max_row_count;
+            ListState_AppendJSONLine(state, (char *)names[k], ++state->load_line);
+            continue;
         }
+
+        struct ListItem *item = ListState_AppendItem(state);
+        ListItem_FromTextLine(item, &state->arena, (char *)names[k], state->load_confirm_text, state->load_background_image, state->load_background_color);
+        state->item_count++;
+        state->load_line++;
     }
+    if (state->item_count == first_new)
+        return false;
+
+    for (size_t i = first_new; i < state->item_count; i++)
+    {
+        ListState_IndexRow(state, i);
+    }
+    ListState_FilterFrom(state, first_new);
+    return true;
 }
 
-// ListState_ApplyFilter rebuilds the filtered view for the given filter text,
-// preserving the current selection when it stays visible (otherwise moving to
-// the first selectable visible item, or -1 when nothing matches), and reframes
-// the visible window.
-void ListState_ApplyFilter(struct ListState *state, const char *filter, int max_row_count)
+// ListState_ExtendView updates the view after ListState_PollLoader added items
+// to a list that is already on screen: the visible window grows until it is
+// full, and a selection is made once there is something to select. An
+// existing selection never moves.
+void ListState_ExtendView(struct ListState *state, int max_row_count)
 {
-    // remember the currently-selected source item so we can keep it selected
-    int prev_source = -1;
-    if (state->selected >= 0 && state->selected < state->visible_count)
+    if (state->selected < 0)
     {
-        prev_source = state->visible[state->selected];
+        ListState_InitView(state, max_row_count);
+        return;
     }
 
-    // rebuild the set of visible source indices
-    state->visible_count = 0;
-    for (size_t i = 0; i < state->item_count; i++)
+    if (state->last_visible - state->first_visible < max_row_count)
     {
-        struct ListItem *item = &state->items[i];
-        if (ListFilter_ItemVisible(item->features.is_header,
-                                   item->features.display_on_filter,
-                                   item->name, filter))
+        state->last_visible = state->first_visible + max_row_count;
+        if (state->last_visible > state->visible_count)
         {
-            state->visible[state->visible_count++] = (int)i;
+            state->last_visible = state->visible_count;
         }
     }
+}
 
-    // map the previous selection to its new display position, if still visible
-    state->selected = -1;
-    if (prev_source >= 0)
+// ListState_FinishLoading blocks until the --progressive-load loader has read
+// the whole list, for features that need every item up front. No filter pass
+// may be in flight, or the loader's items would stay queued.
+void ListState_FinishLoading(struct ListState *state)
+{
+    while (state->loading)
     {
-        for (int k = 0; k < state->visible_count; k++)
-        {
-            if (state->visible[k] == prev_source)
-            {
-                state->selected = k;
-                break;
-            }
-        }
+        ListLoader_Wait(state->loader, SIZE_MAX, -1);
+        ListState_PollLoader(state);
     }
-
-    // validate the selection and reframe the window
-    ListState_InitView(state, max_row_count);
 }
 
-// ListState_ResolveImages selects each item's right-hand image path for the
-// active screen resolution. It must run after display init so FIXED_WIDTH and
+// ListState_ResolveImages sets the resolution key that items' right-hand image
+// variants are selected by. It must run after display init so FIXED_WIDTH and
 // FIXED_HEIGHT reflect the real device. The resolution key is the
 // --screen-resolution override when set, otherwise the device's native
-// WIDTHxHEIGHT.
+// WIDTHxHEIGHT. Each item picks its variant when it is first drawn (see
+// ListItem_ResolvedPath), so items that are never shown cost nothing.
 void ListState_ResolveImages(struct ListState *state, struct AppState *app_state)
 {
-    char resolution[32];
     if (app_state->screen_resolution[0] != '\0')
     {
-        strncpy(resolution, app_state->screen_resolution, sizeof(resolution) - 1);
-        resolution[sizeof(resolution) - 1] = '\0';
+        strncpy(state->image_resolution, app_state->screen_resolution, sizeof(state->image_resolution) - 1);
+        state->image_resolution[sizeof(state->image_resolution) - 1] = '\0';
     }
     else
     {
-        snprintf(resolution, sizeof(resolution), "%dx%d", FIXED_WIDTH, FIXED_HEIGHT);
+        snprintf(state->image_resolution, sizeof(state->image_resolution), "%dx%d", FIXED_WIDTH, FIXED_HEIGHT);
     }
+}
 
-    for (size_t i = 0; i < state->item_count; i++)
+// ListItem_ResolvedPath returns the image variant path selected for the
+// active resolution, selecting it the first time the item is asked.
+static const char *ListItem_ResolvedPath(struct ListState *state, struct ListItem *item)
+{
+    if (item->resolved_path == NULL)
     {
-        struct ListItem *item = &state->items[i];
-        item->resolved_path[0] = '\0';
-        if (!item->has_image)
-            continue;
-
-        int idx = ImageVariant_SelectIndex(item->image_variants, item->image_variant_count, resolution);
+        item->resolved_path = "";
+        int idx = ImageVariant_SelectIndex(item->image_variants, item->image_variant_count, state->image_resolution);
         if (idx >= 0)
         {
-            strncpy(item->resolved_path, item->image_variants[idx].path, sizeof(item->resolved_path) - 1);
-            item->resolved_path[sizeof(item->resolved_path) - 1] = '\0';
+            item->resolved_path = item->image_variants[idx].path;
         }
     }
+    return item->resolved_path;
+}
+
+// ListItem_BackgroundImageExists reports whether an item's background image is
+// on disk. A missing image is checked again on every call, so one that appears
+// later is picked up; once found it is remembered.
+static bool ListItem_BackgroundImageExists(struct ListItem *item)
+{
+    if (!item->features.background_image_exists && item->features.background_image[0] != '\0' &&
+        access(item->features.background_image, F_OK) != -1)
+    {
+        item->features.background_image_exists = true;
+    }
+    return item->features.background_image_exists;
 }
 
 // alphabetic_jump_target builds an SDL-free navigation view of the list and
@@ -1662,7 +3481,7 @@ static int alphabetic_jump_target(struct ListState *state, bool forward)
 
 // image_effective_path is defined alongside the other drawing helpers below but
 // is also polled here in handle_input, so it needs a forward declaration.
-void image_effective_path(struct ListItem *item, const char *fallback_image, char *out, size_t out_size);
+const char *image_effective_path(struct ListState *list_state, struct ListItem *item, const char *fallback_image);
 
 // filter_button_mask is defined with the other argument parsing below, but the
 // keyboard input handlers here need it, so it needs a forward declaration.
@@ -1746,11 +3565,38 @@ static void filter_text_append(struct AppState *state, const char *s)
 }
 
 // apply_filter_text rebuilds the filtered view from the current filter text.
+// On a big list the new view shows up a few frames later (see
+// ListState_PollFilter).
 static void apply_filter_text(struct AppState *state)
 {
     ListState_ApplyFilter(state->list_state, state->filter_text, state->max_row_count);
 }
 
+// build_filter_index builds the --filter-index trigram index over the list
+// and, with --timings, reports how long that took and how much memory the
+// index uses.
+static void build_filter_index(struct AppState *state)
+{
+    double start = ListTiming_Now();
+    if (!ListState_BuildIndex(state->list_state))
+    {
+        log_error("Failed to build the filter index");
+        return;
+    }
+
+    if (state->timings[0] != '\0')
+    {
+        char line[256];
+        snprintf(line, sizeof(line), "{\"filter_index_ms\":%.3f,\"filter_index_items\":%zu,\"filter_index_bytes\":%zu}",
+                 ListTiming_Now() - start, state->list_state->filter_index->item_count,
+                 ListTrigramIndex_Bytes(state->list_state->filter_index));
+        if (!ListTiming_WriteLine(line, state->timings))
+        {
+            log_error("Failed to write timings");
+        }
+    }
+}
+
 // open_filter_keyboard shows the keyboard, shrinking the list row budget to the
 // space above it (saving the full budget so it can be restored on close).
 static void open_filter_keyboard(struct AppState *state)
@@ -1770,6 +3616,11 @@ static void open_filter_keyboard(struct AppState *state)
         rows = 1;
     }
 
+    if (state->filter_index && state->list_state->filter_index == NULL)
+    {
+        build_filter_index(state);
+    }
+
     state->saved_max_row_count = state->max_row_count;
     state->max_row_count = rows;
     state->filter_keyboard_active = true;
@@ -1779,10 +3630,13 @@ static void open_filter_keyboard(struct AppState *state)
 }
 
 // close_filter_keyboard hides the keyboard and restores the full row budget.
+// It waits for the filter pass in flight, if any, so the list the user goes
+// on to navigate matches the filter text.
 static void close_filter_keyboard(struct AppState *state)
 {
     state->filter_keyboard_active = false;
     state->max_row_count = state->saved_max_row_count;
+    ListState_FinishFilter(state->list_state, state->max_row_count);
     ListState_InitView(state->list_state, state->max_row_count);
     state->redraw = 1;
 }
@@ -1877,18 +3731,31 @@ static void handle_filter_keyboard_input(struct AppState *state)
     }
 }
 
+// ListItem_RangeStride returns how many values a press or repeat of button
+// moves through a range item. A fresh press moves one value; each repeat while
+// the button stays held counts towards stepping faster.
+static int ListItem_RangeStride(struct AppState *state, const struct ListItem *item, int button)
+{
+    if (PAD_justPressed(button))
+    {
+        state->option_repeats = 0;
+        return 1;
+    }
+    state->option_repeats++;
+    return ListRange_Stride(state->option_repeats, item->option_count);
+}
+
 // handle_input interprets input events and mutates app state
 void handle_input(struct AppState *state)
 {
     // do not redraw by default
     state->redraw = 0;
 
-    if (state->list_state->selected >= 0 &&
-        !state->list_state->items[state->list_state->visible[state->list_state->selected]].features.background_image_exists && state->list_state->items[state->list_state->visible[state->list_state->selected]].features.background_image[0] != '\0')
+    if (state->list_state->selected >= 0)
     {
-        if (access(state->list_state->items[state->list_state->visible[state->list_state->selected]].features.background_image, F_OK) != -1)
+        struct ListItem *selected_item = &state->list_state->items[state->list_state->visible[state->list_state->selected]];
+        if (!selected_item->features.background_image_exists && ListItem_BackgroundImageExists(selected_item))
         {
-            state->list_state->items[state->list_state->visible[state->list_state->selected]].features.background_image_exists = true;
             state->redraw = 1;
         }
     }
@@ -1902,8 +3769,7 @@ void handle_input(struct AppState *state)
         if (!item->has_image)
             continue;
 
-        char effective[1024];
-        image_effective_path(item, state->fallback_image, effective, sizeof(effective));
+        const char *effective = image_effective_path(state->list_state, item, state->fallback_image);
         if (strcmp(effective, item->image_active_path) != 0)
         {
             state->redraw = 1;
@@ -2087,19 +3953,16 @@ void handle_input(struct AppState *state)
         else
         {
             state->list_state->selected -= 1;
-            while (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.is_header || state->list_state->items[state->list_state->visible[state->list_state->selected]].features.unselectable)
+            while (state->list_state->selected >= 0 &&
+                   ListState_RowSkipped(state->list_state, state->list_state->selected))
             {
                 state->list_state->selected -= 1;
-                if (state->list_state->selected < 0)
-                {
-                    break;
-                }
             }
 
             if (state->list_state->selected < 0)
             {
                 state->list_state->selected = state->list_state->visible_count - 1;
-                while (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.is_header || state->list_state->items[state->list_state->visible[state->list_state->selected]].features.unselectable)
+                while (ListState_RowSkipped(state->list_state, state->list_state->selected))
                 {
                     state->list_state->selected -= 1;
                 }
@@ -2125,19 +3988,16 @@ void handle_input(struct AppState *state)
         else
         {
             state->list_state->selected += 1;
-            while (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.is_header || state->list_state->items[state->list_state->visible[state->list_state->selected]].features.unselectable)
+            while (state->list_state->selected < state->list_state->visible_count &&
+                   ListState_RowSkipped(state->list_state, state->list_state->selected))
             {
                 state->list_state->selected += 1;
-                if (state->list_state->selected >= state->list_state->visible_count)
-                {
-                    break;
-                }
             }
 
             if (state->list_state->selected >= state->list_state->visible_count)
             {
                 state->list_state->selected = 0;
-                while (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.is_header || state->list_state->items[state->list_state->visible[state->list_state->selected]].features.unselectable)
+                while (ListState_RowSkipped(state->list_state, state->list_state->selected))
                 {
                     state->list_state->selected += 1;
                 }
@@ -2158,12 +4018,17 @@ void handle_input(struct AppState *state)
         // if the state has options, cycle through the options
         if (state->list_state->has_options)
         {
-            if (!state->list_state->items[state->list_state->visible[state->list_state->selected]].features.disabled)
+            struct ListItem *item = &state->list_state->items[state->list_state->visible[state->list_state->selected]];
+            if (!item->features.disabled && item->range != NULL)
+            {
+                item->selected = ListRange_Step(item->selected, item->option_count, -ListItem_RangeStride(state, item, BTN_LEFT));
+            }
+            else if (!item->features.disabled)
             {
-                state->list_state->items[state->list_state->visible[state->list_state->selected]].selected -= 1;
-                if (state->list_state->items[state->list_state->visible[state->list_state->selected]].selected < 0)
+                item->selected -= 1;
+                if (item->selected < 0)
                 {
-                    state->list_state->items[state->list_state->visible[state->list_state->selected]].selected = state->list_state->items[state->list_state->visible[state->list_state->selected]].option_count - 1;
+                    item->selected = item->option_count - 1;
                 }
             }
         }
@@ -2175,7 +4040,7 @@ void handle_input(struct AppState *state)
                 state->list_state->selected = 0;
             }
 
-            while (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.is_header || state->list_state->items[state->list_state->visible[state->list_state->selected]].features.unselectable)
+            while (ListState_RowSkipped(state->list_state, state->list_state->selected))
             {
                 state->list_state->selected -= 1;
                 if (state->list_state->selected < 0)
@@ -2187,7 +4052,7 @@ void handle_input(struct AppState *state)
 
             if (state->list_state->selected == 0)
             {
-                while (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.is_header || state->list_state->items[state->list_state->visible[state->list_state->selected]].features.unselectable)
+                while (ListState_RowSkipped(state->list_state, state->list_state->selected))
                 {
                     state->list_state->selected += 1;
                     if (state->list_state->selected >= state->list_state->visible_count)
@@ -2221,12 +4086,17 @@ void handle_input(struct AppState *state)
         // if the state has options, cycle through the options
         if (state->list_state->has_options)
         {
-            if (!state->list_state->items[state->list_state->visible[state->list_state->selected]].features.disabled)
+            struct ListItem *item = &state->list_state->items[state->list_state->visible[state->list_state->selected]];
+            if (!item->features.disabled && item->range != NULL)
+            {
+                item->selected = ListRange_Step(item->selected, item->option_count, ListItem_RangeStride(state, item, BTN_RIGHT));
+            }
+            else if (!item->features.disabled)
             {
-                state->list_state->items[state->list_state->visible[state->list_state->selected]].selected += 1;
-                if (state->list_state->items[state->list_state->visible[state->list_state->selected]].selected >= state->list_state->items[state->list_state->visible[state->list_state->selected]].option_count)
+                item->selected += 1;
+                if (item->selected >= item->option_count)
                 {
-                    state->list_state->items[state->list_state->visible[state->list_state->selected]].selected = 0;
+                    item->selected = 0;
                 }
             }
         }
@@ -2238,7 +4108,7 @@ void handle_input(struct AppState *state)
                 state->list_state->selected = state->list_state->visible_count - 1;
             }
             while (state->list_state->selected < (int)state->list_state->visible_count &&
-                   (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.is_header || state->list_state->items[state->list_state->visible[state->list_state->selected]].features.unselectable))
+                   ListState_RowSkipped(state->list_state, state->list_state->selected))
             {
                 state->list_state->selected += 1;
             }
@@ -2386,25 +4256,25 @@ SDL_Surface *scale_surface(SDL_Surface *surface,
 // image_effective_path computes the path an item should currently display: its
 // resolved per-resolution path when that file exists, otherwise the global
 // fallback image when that exists, otherwise empty. Items without an image spec
-// always resolve to empty.
-void image_effective_path(struct ListItem *item, const char *fallback_image, char *out, size_t out_size)
+// always resolve to empty. The result points at one of those strings rather
+// than a copy, so it stays valid for the run.
+const char *image_effective_path(struct ListState *list_state, struct ListItem *item, const char *fallback_image)
 {
-    out[0] = '\0';
     if (!item->has_image)
-        return;
+        return "";
 
-    if (item->resolved_path[0] != '\0' && access(item->resolved_path, F_OK) != -1)
+    const char *resolved_path = ListItem_ResolvedPath(list_state, item);
+    if (resolved_path[0] != '\0' && access(resolved_path, F_OK) != -1)
     {
-        strncpy(out, item->resolved_path, out_size - 1);
-        out[out_size - 1] = '\0';
-        return;
+        return resolved_path;
     }
 
     if (fallback_image != NULL && fallback_image[0] != '\0' && access(fallback_image, F_OK) != -1)
     {
-        strncpy(out, fallback_image, out_size - 1);
-        out[out_size - 1] = '\0';
+        return fallback_image;
     }
+
+    return "";
 }
 
 // ensure_item_image (re)loads and caches an item's scaled right-hand image when
@@ -2422,8 +4292,7 @@ void ensure_item_image(struct ListItem *item, const char *effective, int max_w,
         item->image_surface = NULL;
     }
 
-    strncpy(item->image_active_path, effective, sizeof(item->image_active_path) - 1);
-    item->image_active_path[sizeof(item->image_active_path) - 1] = '\0';
+    item->image_active_path = effective;
 
     if (effective[0] == '\0')
         return;
@@ -2498,7 +4367,7 @@ bool draw_background(SDL_Surface *screen, struct AppState *state)
     }
 
     bool should_draw_background_image = false;
-    if (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.background_image_exists && access(state->list_state->items[state->list_state->visible[state->list_state->selected]].features.background_image, F_OK) != -1)
+    if (ListItem_BackgroundImageExists(&state->list_state->items[state->list_state->visible[state->list_state->selected]]) && access(state->list_state->items[state->list_state->visible[state->list_state->selected]].features.background_image, F_OK) != -1)
     {
         should_draw_background_image = true;
     }
@@ -2559,29 +4428,19 @@ bool draw_background(SDL_Surface *screen, struct AppState *state)
     return should_draw_background_image;
 }
 
-// draw_match_highlight paints an accent rectangle behind the matched portion of
-// text_str and re-renders that substring in black over it, so the filter match
-// stands out on both selected and unselected rows. It is a no-op when there is
-// no active filter or the (already-truncated) text does not contain the match.
-static void draw_match_highlight(SDL_Surface *screen, TTF_Font *font,
-                                 const char *text_str, const char *filter,
-                                 int base_x, int base_y)
+// draw_highlight_run paints an accent rectangle behind the length bytes of
+// text_str at byte offset start and re-renders them in black over it.
+static void draw_highlight_run(SDL_Surface *screen, TTF_Font *font, const char *text_str,
+                               size_t start, size_t length, int base_x, int base_y)
 {
-    if (font == NULL || filter == NULL || filter[0] == '\0' || text_str == NULL)
-        return;
-
-    size_t ms = 0, ml = 0;
-    if (!ListFilter_Match(text_str, filter, &ms, &ml) || ml == 0)
-        return;
-
     char prefix[256];
     char match[256];
-    if (ms >= sizeof(prefix) || ml >= sizeof(match))
+    if (start >= sizeof(prefix) || length >= sizeof(match))
         return;
-    memcpy(prefix, text_str, ms);
-    prefix[ms] = '\0';
-    memcpy(match, text_str + ms, ml);
-    match[ml] = '\0';
+    memcpy(prefix, text_str, start);
+    prefix[start] = '\0';
+    memcpy(match, text_str + start, length);
+    match[length] = '\0';
 
     int prefix_w = 0, match_w = 0, match_h = 0;
     TTF_SizeUTF8(font, prefix, &prefix_w, NULL);
@@ -2601,6 +4460,47 @@ static void draw_match_highlight(SDL_Surface *screen, TTF_Font *font,
     }
 }
 
+// draw_match_highlight paints an accent rectangle behind the matched portion of
+// text_str and re-renders that substring in black over it, so the filter match
+// stands out on both selected and unselected rows. With --filter-mode fuzzy
+// each run of matched characters is highlighted on its own. It is a no-op when
+// there is no active filter or the (already-truncated) text does not contain
+// the match.
+static void draw_match_highlight(SDL_Surface *screen, TTF_Font *font,
+                                 const char *text_str, const char *filter,
+                                 enum ListFilterMode mode, int base_x, int base_y)
+{
+    if (font == NULL || filter == NULL || filter[0] == '\0' || text_str == NULL)
+        return;
+
+    if (mode == LIST_FILTER_FUZZY)
+    {
+        size_t positions[LIST_FILTER_QUERY_MAX];
+        size_t count = ListFilter_FuzzyHighlight(text_str, filter, positions);
+        size_t k = 0;
+        while (k < count)
+        {
+            // extend the run while the next character starts where this one ends
+            size_t run_start = positions[k];
+            size_t run_end = run_start;
+            do
+            {
+                run_end = positions[k] + 1;
+                while (((unsigned char)text_str[run_end] & 0xC0) == 0x80)
+                    run_end++;
+                k++;
+            } while (k < count && positions[k] == run_end);
+            draw_highlight_run(screen, font, text_str, run_start, run_end - run_start, base_x, base_y);
+        }
+        return;
+    }
+
+    size_t ms = 0, ml = 0;
+    if (!ListFilter_Match(text_str, filter, &ms, &ml) || ml == 0)
+        return;
+    draw_highlight_run(screen, font, text_str, ms, ml, base_x, base_y);
+}
+
 // draw_filter_keyboard renders the on-screen filter keyboard: an input field
 // showing the current filter text, then the key grid for the active layout with
 // the focused key inverted. Ported from the sibling minui-keyboard tool.
@@ -2738,11 +4638,11 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
         }
         else if (state->list_state->items[state->list_state->visible[state->list_state->selected]].features.hide_cancel)
         {
-            GFX_blitButtonGroup((char *[]){state->confirm_button, state->list_state->items[state->list_state->visible[state->list_state->selected]].features.confirm_text, NULL}, 1, screen, 1);
+            GFX_blitButtonGroup((char *[]){state->confirm_button, (char *)state->list_state->items[state->list_state->visible[state->list_state->selected]].features.confirm_text, NULL}, 1, screen, 1);
         }
         else
         {
-            GFX_blitButtonGroup((char *[]){state->cancel_button, state->cancel_text, state->confirm_button, state->list_state->items[state->list_state->visible[state->list_state->selected]].features.confirm_text, NULL}, 1, screen, 1);
+            GFX_blitButtonGroup((char *[]){state->cancel_button, state->cancel_text, state->confirm_button, (char *)state->list_state->items[state->list_state->visible[state->list_state->selected]].features.confirm_text, NULL}, 1, screen, 1);
         }
     }
 
@@ -2849,14 +4749,15 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
         // item.name
         char display_text[256];
         char display_selected_text[256];
-        char *alignment = state->list_state->items[i].features.alignment;
+        enum ListItemAlignment alignment = state->list_state->items[i].features.alignment;
         bool is_hex_color = false;
         strncpy(display_selected_text, "", sizeof(display_selected_text));
         if (state->list_state->items[i].option_count > 0)
         {
-            char *selected = state->list_state->items[i].options[state->list_state->items[i].selected];
+            char option_text[128];
+            const char *selected = ListItem_Option(&state->list_state->items[i], state->list_state->items[i].selected, option_text, sizeof(option_text));
             is_hex_color = detect_hex_color(selected);
-            if (strcmp(alignment, "left") == 0)
+            if (alignment == ALIGNMENT_LEFT)
             {
                 snprintf(display_text, sizeof(display_text), "%s", state->list_state->items[i].name);
                 if (state->list_state->items[i].features.draw_arrows)
@@ -2908,8 +4809,7 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
         int image_col_space = 0;
         {
             struct ListItem *image_item = &state->list_state->items[i];
-            char image_effective[1024];
-            image_effective_path(image_item, state->fallback_image, image_effective, sizeof(image_effective));
+            const char *image_effective = image_effective_path(state->list_state, image_item, state->fallback_image);
             ensure_item_image(image_item, image_effective, screen->w / IMAGE_MAX_WIDTH_DIVISOR, SCALE1(PILL_SIZE - 4));
             if (image_item->image_surface != NULL)
             {
@@ -2988,11 +4888,11 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
 
             // Calculate pill position based on alignment
             int pill_x_pos;
-            if (strcmp(alignment, "center") == 0)
+            if (alignment == ALIGNMENT_CENTER)
             {
                 pill_x_pos = (screen->w - image_col_space - pill_width) / 2;
             }
-            else if (strcmp(alignment, "right") == 0)
+            else if (alignment == ALIGNMENT_RIGHT)
             {
                 pill_x_pos = screen->w - pill_width - SCALE1(PADDING) - image_col_space;
             }
@@ -3004,7 +4904,7 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
             // Adjust for the pill position in the top row without title
             if (in_top_row_no_title)
             {
-                if (strcmp(alignment, "center") == 0)
+                if (alignment == ALIGNMENT_CENTER)
                 {
                     int interference = pill_width - (available_width - ow - SCALE1(PADDING)); // extra ow and padding account for centered text, i.e. available width is offset by ow and padding on both sides of screen
                     if (interference > 0)
@@ -3012,7 +4912,7 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
                         pill_x_pos -= interference / 2;
                     }
                 }
-                else if (strcmp(alignment, "right") == 0)
+                else if (alignment == ALIGNMENT_RIGHT)
                 {
                     pill_x_pos -= (ow + SCALE1(PADDING));
                 }
@@ -3047,12 +4947,12 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
         // Calculate text position based on alignment
         int text_x_pos;
         int shadow_x_pos;
-        if (strcmp(alignment, "center") == 0)
+        if (alignment == ALIGNMENT_CENTER)
         {
             text_x_pos = (screen->w - text->w - color_box_space - image_col_space) / 2;
             shadow_x_pos = text_x_pos - 2;
         }
-        else if (strcmp(alignment, "right") == 0)
+        else if (alignment == ALIGNMENT_RIGHT)
         {
             text_x_pos = screen->w - text->w - SCALE1(PADDING + BUTTON_PADDING) - color_box_space - image_col_space;
             shadow_x_pos = screen->w - text->w - SCALE1(2 + PADDING + BUTTON_PADDING) - color_box_space - image_col_space;
@@ -3066,7 +4966,7 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
         // Adjust for the pill position in the top row without title
         if (in_top_row_no_title)
         {
-            if (strcmp(alignment, "center") == 0)
+            if (alignment == ALIGNMENT_CENTER)
             {
                 int interference = pill_width - (available_width - ow - SCALE1(PADDING)); // extra ow and padding account for centered text, i.e. available width is offset by ow and padding on both sides of screen
                 if (interference > 0)
@@ -3074,7 +4974,7 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
                     text_x_pos -= interference / 2;
                 }
             }
-            else if (strcmp(alignment, "right") == 0)
+            else if (alignment == ALIGNMENT_RIGHT)
             {
                 text_x_pos -= (ow + SCALE1(PADDING));
             }
@@ -3133,11 +5033,13 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
             SDL_BlitSurface(text, NULL, screen, &pos);
 
             // highlight the matched portion of the name while filtering (the
-            // marquee path above renders the full string and is left unhighlighted)
-            if (state->allow_filter && state->filter_text[0] != '\0' && !is_hex_color)
+            // marquee path above renders the full string and is left
+            // unhighlighted). This follows the query the view was filtered
+            // with, which lags the filter text while the filter worker runs.
+            if (state->allow_filter && state->list_state->filter_query.length > 0 && !is_hex_color)
             {
                 draw_match_highlight(screen, state->fonts.large, truncated_display_text,
-                                     state->filter_text, text_x_pos, text_y_pos);
+                                     state->list_state->filter_query.text, state->list_state->filter_mode, text_x_pos, text_y_pos);
             }
         }
 
@@ -3166,7 +5068,8 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
         if (is_hex_color)
         {
             // get the hex color from the options array
-            char *hex_color = state->list_state->items[i].options[state->list_state->items[i].selected];
+            char option_text[128];
+            const char *hex_color = ListItem_Option(&state->list_state->items[i], state->list_state->items[i].selected, option_text, sizeof(option_text));
             SDL_Color current_color = hex_to_sdl_color(hex_color);
             uint32_t color = SDL_MapRGBA(screen->format, current_color.r, current_color.g, current_color.b, 255);
 
@@ -3228,7 +5131,7 @@ void draw_screen(SDL_Surface *screen, struct AppState *state, int ow, bool shoul
         {
             SDL_FreeSurface(offscreen->image_surface);
             offscreen->image_surface = NULL;
-            offscreen->image_active_path[0] = '\0';
+            offscreen->image_active_path = "";
         }
     }
 
@@ -3407,11 +5310,14 @@ void restore_output(int saved_fds)
 // the InitSettings() function is an example of this (some implementations print to stdout)
 void swallow_stdout_from_function(void (*func)(void))
 {
+    // func must not log_error itself, since the lock is held meanwhile
+    pthread_mutex_lock(&log_lock);
     int saved_fds = suppress_output();
 
     func();
 
     restore_output(saved_fds);
+    pthread_mutex_unlock(&log_lock);
 }
 
 static volatile sig_atomic_t signal_exit_code = 0;
@@ -3468,7 +5374,7 @@ static int filter_button_mask(const char *name)
 // - --hide-hardware-group (default: false)
 // - --title <title> (default: empty string)
 // - --title-alignment <alignment> (default: "left")
-// - --item-key <key> (default: "items")
+// - --item-key <path> (default: "items")
 // - --scroll-method <method> (default: "false")
 // - --write-location <location> (default: "-")
 // - --write-value <value> (default: "selected")
@@ -3477,6 +5383,16 @@ static int filter_button_mask(const char *name)
 // - --display-filter-keyboard <true|false> (default: false)
 // - --filter-input <text> (default: empty string)
 // - --filter-text-file <path> (default: empty string)
+// - --filter-index <true|false> (default: false)
+// - --filter-mode <mode> (default: "substring")
+// - --cache-dir <path> (default: empty string)
+// - --progressive-load <true|false> (default: false)
+// - --source-dir <path> (default: empty string)
+// - --source-extensions <list> (default: empty string)
+// - --source-image-dir <path> (default: empty string)
+// - --serve <socket> (default: empty string)
+// - --client <socket> (default: empty string)
+// - --timings <path> (default: empty string)
 bool parse_arguments(struct AppState *state, int argc, char *argv[])
 {
     // long-only options use val codes above the ASCII range so they need no
@@ -3490,6 +5406,16 @@ bool parse_arguments(struct AppState *state, int argc, char *argv[])
         OPT_DISPLAY_FILTER_KEYBOARD,
         OPT_FILTER_INPUT,
         OPT_FILTER_TEXT_FILE,
+        OPT_CACHE_DIR,
+        OPT_PROGRESSIVE_LOAD,
+        OPT_SOURCE_DIR,
+        OPT_SOURCE_EXTENSIONS,
+        OPT_SOURCE_IMAGE_DIR,
+        OPT_SERVE,
+        OPT_CLIENT,
+        OPT_TIMINGS,
+        OPT_FILTER_INDEX,
+        OPT_FILTER_MODE,
     };
     static struct option long_options[] = {
         {"action-button", required_argument, 0, 'a'},
@@ -3524,6 +5450,16 @@ bool parse_arguments(struct AppState *state, int argc, char *argv[])
         {"display-filter-keyboard", required_argument, 0, OPT_DISPLAY_FILTER_KEYBOARD},
         {"filter-input", required_argument, 0, OPT_FILTER_INPUT},
         {"filter-text-file", required_argument, 0, OPT_FILTER_TEXT_FILE},
+        {"filter-index", required_argument, 0, OPT_FILTER_INDEX},
+        {"filter-mode", required_argument, 0, OPT_FILTER_MODE},
+        {"cache-dir", required_argument, 0, OPT_CACHE_DIR},
+        {"progressive-load", required_argument, 0, OPT_PROGRESSIVE_LOAD},
+        {"source-dir", required_argument, 0, OPT_SOURCE_DIR},
+        {"source-extensions", required_argument, 0, OPT_SOURCE_EXTENSIONS},
+        {"source-image-dir", required_argument, 0, OPT_SOURCE_IMAGE_DIR},
+        {"serve", required_argument, 0, OPT_SERVE},
+        {"client", required_argument, 0, OPT_CLIENT},
+        {"timings", required_argument, 0, OPT_TIMINGS},
         {0, 0, 0, 0}};
 
     int opt;
@@ -3609,50 +5545,104 @@ bool parse_arguments(struct AppState *state, int argc, char *argv[])
         case 'S':
             state->alphabetic_scroll = true;
             break;
-        case OPT_SCREEN_RESOLUTION:
-            strncpy(state->screen_resolution, optarg, sizeof(state->screen_resolution) - 1);
+        case OPT_SCREEN_RESOLUTION:
+            strncpy(state->screen_resolution, optarg, sizeof(state->screen_resolution) - 1);
+            break;
+        case OPT_FALLBACK_IMAGE:
+            strncpy(state->fallback_image, optarg, sizeof(state->fallback_image) - 1);
+            break;
+        case OPT_ALLOW_FILTER:
+            if (strcmp(optarg, "true") == 0)
+            {
+                state->allow_filter = true;
+            }
+            else if (strcmp(optarg, "false") == 0)
+            {
+                state->allow_filter = false;
+            }
+            else
+            {
+                log_error("Invalid allow-filter value provided. Please provide 'true' or 'false'.");
+                return false;
+            }
+            break;
+        case OPT_FILTER_BUTTON:
+            strncpy(state->filter_button, optarg, sizeof(state->filter_button) - 1);
+            break;
+        case OPT_DISPLAY_FILTER_KEYBOARD:
+            if (strcmp(optarg, "true") == 0)
+            {
+                state->display_filter_keyboard = true;
+            }
+            else if (strcmp(optarg, "false") == 0)
+            {
+                state->display_filter_keyboard = false;
+            }
+            else
+            {
+                log_error("Invalid display-filter-keyboard value provided. Please provide 'true' or 'false'.");
+                return false;
+            }
+            break;
+        case OPT_FILTER_INPUT:
+            strncpy(state->filter_input, optarg, sizeof(state->filter_input) - 1);
             break;
-        case OPT_FALLBACK_IMAGE:
-            strncpy(state->fallback_image, optarg, sizeof(state->fallback_image) - 1);
+        case OPT_FILTER_TEXT_FILE:
+            strncpy(state->filter_text_file, optarg, sizeof(state->filter_text_file) - 1);
             break;
-        case OPT_ALLOW_FILTER:
+        case OPT_FILTER_INDEX:
             if (strcmp(optarg, "true") == 0)
             {
-                state->allow_filter = true;
+                state->filter_index = true;
             }
             else if (strcmp(optarg, "false") == 0)
             {
-                state->allow_filter = false;
+                state->filter_index = false;
             }
             else
             {
-                log_error("Invalid allow-filter value provided. Please provide 'true' or 'false'.");
+                log_error("Invalid filter-index value provided. Please provide 'true' or 'false'.");
                 return false;
             }
             break;
-        case OPT_FILTER_BUTTON:
-            strncpy(state->filter_button, optarg, sizeof(state->filter_button) - 1);
+        case OPT_FILTER_MODE:
+            strncpy(state->filter_mode, optarg, sizeof(state->filter_mode) - 1);
             break;
-        case OPT_DISPLAY_FILTER_KEYBOARD:
+        case OPT_CACHE_DIR:
+            strncpy(state->cache_dir, optarg, sizeof(state->cache_dir) - 1);
+            break;
+        case OPT_PROGRESSIVE_LOAD:
             if (strcmp(optarg, "true") == 0)
             {
-                state->display_filter_keyboard = true;
+                state->progressive_load = true;
             }
             else if (strcmp(optarg, "false") == 0)
             {
-                state->display_filter_keyboard = false;
+                state->progressive_load = false;
             }
             else
             {
-                log_error("Invalid display-filter-keyboard value provided. Please provide 'true' or 'false'.");
+                log_error("Invalid progressive-load value provided. Please provide 'true' or 'false'.");
                 return false;
             }
             break;
-        case OPT_FILTER_INPUT:
-            strncpy(state->filter_input, optarg, sizeof(state->filter_input) - 1);
+        case OPT_SOURCE_DIR:
+            strncpy(state->source_dir, optarg, sizeof(state->source_dir) - 1);
             break;
-        case OPT_FILTER_TEXT_FILE:
-            strncpy(state->filter_text_file, optarg, sizeof(state->filter_text_file) - 1);
+        case OPT_SOURCE_EXTENSIONS:
+            strncpy(state->source_extensions, optarg, sizeof(state->source_extensions) - 1);
+            break;
+        case OPT_SOURCE_IMAGE_DIR:
+            strncpy(state->source_image_dir, optarg, sizeof(state->source_image_dir) - 1);
+            break;
+        case OPT_SERVE:
+            strncpy(state->serve_socket, optarg, sizeof(state->serve_socket) - 1);
+            break;
+        case OPT_CLIENT:
+            strncpy(state->client_socket, optarg, sizeof(state->client_socket) - 1);
+            break;
+        case OPT_TIMINGS:
+            strncpy(state->timings, optarg, sizeof(state->timings) - 1);
             break;
         default:
             return false;
@@ -3673,6 +5663,13 @@ bool parse_arguments(struct AppState *state, int argc, char *argv[])
         return false;
     }
 
+    // validate filter mode
+    if (strcmp(state->filter_mode, "substring") != 0 && strcmp(state->filter_mode, "fuzzy") != 0)
+    {
+        log_error("Invalid filter mode provided. Please provide a value of 'substring' or 'fuzzy'.");
+        return false;
+    }
+
     // validate screen resolution format (WIDTHxHEIGHT), when provided
     if (state->screen_resolution[0] != '\0')
     {
@@ -3751,19 +5748,44 @@ bool parse_arguments(struct AppState *state, int argc, char *argv[])
         return false;
     }
 
-    if (strlen(state->file) == 0)
+    if (state->serve_socket[0] != '\0' && state->client_socket[0] != '\0')
+    {
+        log_error("Only one of --serve and --client can be provided");
+        return false;
+    }
+
+    // a server reads each list from the requests it is sent
+    if (state->serve_socket[0] != '\0')
+    {
+        return true;
+    }
+
+    if (strlen(state->file) == 0 && strlen(state->source_dir) == 0)
     {
         log_error("No input provided");
         return false;
     }
 
+    if (strlen(state->file) > 0 && strlen(state->source_dir) > 0)
+    {
+        log_error("Only one of --file and --source-dir can be provided");
+        return false;
+    }
+
+    struct ListKeyPath item_path;
+    if (!ListKeyPath_Parse(&item_path, state->item_key))
+    {
+        log_error("Invalid item key provided. Please provide a key path such as 'items' or 'data.menus[2].items'.");
+        return false;
+    }
+
     if (strlen(state->format) == 0)
     {
         log_error("No format provided");
         return false;
     }
-    // validate format, and only allow json or text
-    if (strcmp(state->format, "json") != 0 && strcmp(state->format, "text") != 0)
+    // validate format, and only allow json, jsonl or text
+    if (strcmp(state->format, "json") != 0 && strcmp(state->format, "jsonl") != 0 && strcmp(state->format, "text") != 0)
     {
         log_error("Invalid format provided");
         return false;
@@ -3827,6 +5849,62 @@ int write_to_file(const char *filename, const char *text)
     return ExitCodeSuccess;
 }
 
+// json_object_set_path stores value at the --item-key path under object, so
+// the items are written back where ListState_LoadJSON found them. Objects are
+// created for keys and arrays for indexes along the way, and arrays are padded
+// with nulls up to an index. As with parson's setters, the caller still owns
+// value on failure.
+static JSON_Status json_object_set_path(JSON_Object *object, const char *item_key, JSON_Value *value)
+{
+    struct ListKeyPath path;
+    if (!ListKeyPath_Parse(&path, item_key))
+        return JSONFailure;
+
+    JSON_Value *container = json_object_get_wrapping_value(object);
+    for (int i = 0; i < path.count; i++)
+    {
+        const struct ListKeyPathSegment *segment = &path.segments[i];
+        bool last = i == path.count - 1;
+        JSON_Value_Type type = !last && path.segments[i + 1].key == NULL ? JSONArray : JSONObject;
+        JSON_Value *existing = segment->key != NULL ? json_object_get_value(json_value_get_object(container), segment->key)
+                                                    : json_array_get_value(json_value_get_array(container), segment->index);
+        if (!last && json_value_get_type(existing) == type)
+        {
+            container = existing;
+            continue;
+        }
+
+        JSON_Value *child = last ? value : (type == JSONArray ? json_value_init_array() : json_value_init_object());
+        JSON_Status status;
+        if (segment->key != NULL)
+        {
+            status = json_object_set_value(json_value_get_object(container), segment->key, child);
+        }
+        else
+        {
+            JSON_Array *array = json_value_get_array(container);
+            status = JSONSuccess;
+            while (status == JSONSuccess && json_array_get_count(array) < (size_t)segment->index)
+            {
+                status = json_array_append_null(array);
+            }
+            if (status == JSONSuccess)
+            {
+                status = json_array_get_count(array) > (size_t)segment->index ? json_array_replace_value(array, segment->index, child)
+                                                                                : json_array_append_value(array, child);
+            }
+        }
+        if (status == JSONFailure)
+        {
+            if (!last)
+                json_value_free(child);
+            return JSONFailure;
+        }
+        container = child;
+    }
+    return JSONSuccess;
+}
+
 // write_output writes the final text to the write location
 int write_output(struct AppState *state)
 {
@@ -3854,6 +5932,12 @@ int write_output(struct AppState *state)
         return state->exit_code;
     }
 
+    // the state written back must hold the whole list, so read whatever a
+    // --progressive-load loader has not delivered yet (a filter pass still in
+    // flight is dropped first, since the loader waits for it)
+    ListState_CancelFilter(state->list_state);
+    ListState_FinishLoading(state->list_state);
+
     JSON_Value *root_value = json_value_init_object();
     JSON_Object *root_object = json_value_get_object(root_value);
     char *serialized_string = NULL;
@@ -3879,7 +5963,7 @@ int write_output(struct AppState *state)
 
         if (state->list_state->items[i].features.has_alignment)
         {
-            if (json_object_dotset_string(features, "alignment", state->list_state->items[i].features.alignment) == JSONFailure)
+            if (json_object_dotset_string(features, "alignment", ListItemAlignment_Name(state->list_state->items[i].features.alignment)) == JSONFailure)
             {
                 log_error("Failed to set alignment");
                 return ExitCodeSerializeError;
@@ -3993,17 +6077,37 @@ int write_output(struct AppState *state)
                 return ExitCodeSerializeError;
             }
 
-            JSON_Array *options = json_array(json_value_init_array());
-            for (int j = 0; j < state->list_state->items[i].option_count; j++)
+            JSON_Value *options_value;
+            const struct ListRange *range = state->list_state->items[i].range;
+            if (range != NULL)
             {
-                JSON_Value *option = json_value_init_string(state->list_state->items[i].options[j]);
-                if (json_array_append_value(options, option) == JSONFailure)
+                // a range is written back as the spec it was read from
+                options_value = json_value_init_object();
+                JSON_Object *range_object = json_value_get_object(options_value);
+                if (json_object_set_number(range_object, "min", range->min) == JSONFailure ||
+                    json_object_set_number(range_object, "max", range->max) == JSONFailure ||
+                    json_object_set_number(range_object, "step", range->step) == JSONFailure ||
+                    (range->format != NULL && json_object_set_string(range_object, "format", range->format) == JSONFailure))
                 {
-                    log_error("Failed to append option");
+                    log_error("Failed to set options range");
                     return ExitCodeSerializeError;
                 }
             }
-            if (json_object_dotset_value(obj, "options", json_array_get_wrapping_value(options)) == JSONFailure)
+            else
+            {
+                JSON_Array *options = json_array(json_value_init_array());
+                for (int j = 0; j < state->list_state->items[i].option_count; j++)
+                {
+                    JSON_Value *option = json_value_init_string(state->list_state->items[i].options[j]);
+                    if (json_array_append_value(options, option) == JSONFailure)
+                    {
+                        log_error("Failed to append option");
+                        return ExitCodeSerializeError;
+                    }
+                }
+                options_value = json_array_get_wrapping_value(options);
+            }
+            if (json_object_dotset_value(obj, "options", options_value) == JSONFailure)
             {
                 log_error("Failed to set options");
                 return ExitCodeSerializeError;
@@ -4030,7 +6134,7 @@ int write_output(struct AppState *state)
     }
 
     JSON_Value *items_value = json_array_get_wrapping_value(items);
-    if (json_object_dotset_value(root_object, state->item_key, items_value) == JSONFailure)
+    if (json_object_set_path(root_object, state->item_key, items_value) == JSONFailure)
     {
         log_error("Failed to set items");
         return ExitCodeSerializeError;
@@ -4060,10 +6164,9 @@ int write_output(struct AppState *state)
     return state->exit_code;
 }
 
-// main is the entry point for the app
-int main(int argc, char *argv[])
+// AppState_Init sets state to the defaults the command-line flags start from.
+static void AppState_Init(struct AppState *state)
 {
-    // Initialize app state
     char default_action_button[1024] = "";
     char default_action_text[1024] = "ACTION";
     char default_background_image[1024] = "";
@@ -4082,12 +6185,14 @@ int main(int argc, char *argv[])
     char default_scroll_method[1024] = "false";
     char default_write_location[1024] = "-";
     char default_filter_button[1024] = "SELECT";
-    struct AppState state = {
+    char default_filter_mode[1024] = "substring";
+    *state = (struct AppState){
         .exit_code = ExitCodeSuccess,
         .quitting = 0,
         .redraw = 1,
         .show_hardware_group = 1,
         .show_brightness_setting = 0,
+        .option_repeats = 0,
         .always_show_confirm = false,
         .disable_auto_sleep = false,
         .initial_selected = -1,
@@ -4103,97 +6208,200 @@ int main(int argc, char *argv[])
         .list_state = NULL};
 
     // assign the default values to the app state
-    strncpy(state.action_button, default_action_button, sizeof(state.action_button) - 1);
-    strncpy(state.action_text, default_action_text, sizeof(state.action_text) - 1);
-    strncpy(state.background_image, default_background_image, sizeof(state.background_image));
-    strncpy(state.background_color, default_background_color, sizeof(state.background_color));
-    strncpy(state.cancel_button, default_cancel_button, sizeof(state.cancel_button) - 1);
-    strncpy(state.cancel_text, default_cancel_text, sizeof(state.cancel_text) - 1);
-    strncpy(state.confirm_button, default_confirm_button, sizeof(state.confirm_button) - 1);
-    strncpy(state.confirm_text, default_confirm_text, sizeof(state.confirm_text) - 1);
-    strncpy(state.enable_button, default_enable_button, sizeof(state.enable_button) - 1);
-    strncpy(state.file, default_file, sizeof(state.file) - 1);
-    strncpy(state.format, default_format, sizeof(state.format) - 1);
-    strncpy(state.item_key, default_item_key, sizeof(state.item_key) - 1);
-    strncpy(state.write_value, default_write_value, sizeof(state.write_value) - 1);
-    strncpy(state.title, default_title, sizeof(state.title) - 1);
-    strncpy(state.title_alignment, default_title_alignment, sizeof(state.title_alignment) - 1);
-    strncpy(state.scroll_method, default_scroll_method, sizeof(state.scroll_method) - 1);
-    strncpy(state.write_location, default_write_location, sizeof(state.write_location) - 1);
-    strncpy(state.filter_button, default_filter_button, sizeof(state.filter_button) - 1);
+    strncpy(state->action_button, default_action_button, sizeof(state->action_button) - 1);
+    strncpy(state->action_text, default_action_text, sizeof(state->action_text) - 1);
+    strncpy(state->background_image, default_background_image, sizeof(state->background_image));
+    strncpy(state->background_color, default_background_color, sizeof(state->background_color));
+    strncpy(state->cancel_button, default_cancel_button, sizeof(state->cancel_button) - 1);
+    strncpy(state->cancel_text, default_cancel_text, sizeof(state->cancel_text) - 1);
+    strncpy(state->confirm_button, default_confirm_button, sizeof(state->confirm_button) - 1);
+    strncpy(state->confirm_text, default_confirm_text, sizeof(state->confirm_text) - 1);
+    strncpy(state->enable_button, default_enable_button, sizeof(state->enable_button) - 1);
+    strncpy(state->file, default_file, sizeof(state->file) - 1);
+    strncpy(state->format, default_format, sizeof(state->format) - 1);
+    strncpy(state->item_key, default_item_key, sizeof(state->item_key) - 1);
+    strncpy(state->write_value, default_write_value, sizeof(state->write_value) - 1);
+    strncpy(state->title, default_title, sizeof(state->title) - 1);
+    strncpy(state->title_alignment, default_title_alignment, sizeof(state->title_alignment) - 1);
+    strncpy(state->scroll_method, default_scroll_method, sizeof(state->scroll_method) - 1);
+    strncpy(state->write_location, default_write_location, sizeof(state->write_location) - 1);
+    strncpy(state->filter_button, default_filter_button, sizeof(state->filter_button) - 1);
+    strncpy(state->filter_mode, default_filter_mode, sizeof(state->filter_mode) - 1);
+
+    // startup is timed from here, whether or not --timings asks for a report
+    ListTiming_Init(&state->timing);
+}
 
-    // parse the arguments
-    if (!parse_arguments(&state, argc, argv))
+// load_list reads the list described by state into state->list_state,
+// applies --selected and, with --alphabetic-scroll, sorts it. It needs
+// neither the display nor the fonts, so run_list runs it on a thread of its
+// own while those come up. Leaves state->list_state NULL when the list cannot
+// be loaded.
+static void load_list(struct AppState *state)
+{
+    ListTiming_Begin(&state->timing, LIST_TIMING_LOAD);
+    state->list_state = ListState_New(state->file, state->format, state->item_key, state->confirm_text, state->background_image, state->background_color, state);
+    ListTiming_End(&state->timing, LIST_TIMING_LOAD);
+    if (state->list_state == NULL)
     {
-        return ExitCodeError;
+        return;
     }
 
-    state.list_state = ListState_New(state.file, state.format, state.item_key, state.confirm_text, state.background_image, state.background_color, &state);
-    if (state.list_state == NULL)
+    // CLI --selected overrides JSON selected
+    if (state->initial_selected >= 0)
     {
-        log_error("Failed to create list state");
-        return ExitCodeError;
+        state->list_state->selected = state->initial_selected;
     }
 
-    // CLI --selected overrides JSON selected
-    if (state.initial_selected >= 0)
+    // sorting needs every item, so a progressive load finishes here
+    if (state->alphabetic_scroll)
     {
-        state.list_state->selected = state.initial_selected;
+        ListTiming_Begin(&state->timing, LIST_TIMING_LOAD);
+        ListState_FinishLoading(state->list_state);
+        ListTiming_End(&state->timing, LIST_TIMING_LOAD);
     }
 
     // Sort items alphabetically if alphabetic_scroll is enabled
-    if (state.alphabetic_scroll && state.list_state->item_count > 0)
+    if (state->alphabetic_scroll && state->list_state->item_count > 0)
     {
         // remember the selected item's name so we can find it after sorting
         const char *selected_name = NULL;
-        if (state.list_state->selected >= 0 && state.list_state->selected < (int)state.list_state->item_count)
+        if (state->list_state->selected >= 0 && state->list_state->selected < (int)state->list_state->item_count)
         {
-            selected_name = state.list_state->items[state.list_state->selected].name;
+            selected_name = state->list_state->items[state->list_state->selected].name;
         }
 
-        qsort(state.list_state->items,
-              state.list_state->item_count,
+        ListTiming_Begin(&state->timing, LIST_TIMING_SORT);
+        qsort(state->list_state->items,
+              state->list_state->item_count,
               sizeof(struct ListItem),
               compare_items_alphabetic);
+        ListState_IndexRows(state->list_state);
+        ListTiming_End(&state->timing, LIST_TIMING_SORT);
 
         // restore selection to the same item by name
         if (selected_name != NULL)
         {
-            state.list_state->selected = -1;
-            for (size_t i = 0; i < state.list_state->item_count; i++)
+            state->list_state->selected = -1;
+            for (size_t i = 0; i < state->list_state->item_count; i++)
             {
-                if (strcmp(state.list_state->items[i].name, selected_name) == 0)
+                if (strcmp(state->list_state->items[i].name, selected_name) == 0)
                 {
-                    state.list_state->selected = (int)i;
+                    state->list_state->selected = (int)i;
                     break;
                 }
             }
         }
     }
+}
+
+static void *load_list_thread(void *arg)
+{
+    load_list(arg);
+    return NULL;
+}
+
+// run_list shows the list described by state, whose arguments have already
+// been parsed, and returns the exit code. Resident runs belong to a --serve
+// server, which has run init() already and keeps the display up afterwards;
+// the caller frees state->list_state once the run is over.
+static int run_list(struct AppState *state, bool resident)
+{
+    // the list loads on its own thread while this one brings up the display
+    // and opens the fonts, and the two meet before the list is laid out.
+    // Without a second thread the list is loaded first.
+    pthread_t loader;
+    bool loading = pthread_create(&loader, NULL, load_list_thread, state) == 0;
+    if (!loading)
+    {
+        load_list(state);
+    }
 
     // swallow all stdout from init calls
     // MinUI will sometimes randomly log to stdout
     // NOTE: must call init() before using MAIN_ROW_COUNT, as it depends
     // on runtime platform detection (e.g. is_brick on tg5040)
-    swallow_stdout_from_function(init);
-    atexit(destruct);
+    // a --serve server has already run it once for every list it shows
+    if (!resident)
+    {
+        ListTiming_Begin(&state->timing, LIST_TIMING_INIT);
+        swallow_stdout_from_function(init);
+        ListTiming_End(&state->timing, LIST_TIMING_INIT);
+        atexit(destruct);
+    }
+
+    // font errors are held until the list has loaded, so a list that cannot
+    // be shown reports only its own error, as it did before the fonts were
+    // opened alongside it
+    struct ListCacheWriter font_errors;
+    ListCacheWriter_Init(&font_errors);
+    log_deferred = &font_errors;
+    ListTiming_Begin(&state->timing, LIST_TIMING_FONTS);
+    bool fonts_opened = open_fonts(state);
+    ListTiming_End(&state->timing, LIST_TIMING_FONTS);
+    log_deferred = NULL;
+
+    if (loading)
+    {
+        pthread_join(loader, NULL);
+    }
+    if (state->list_state == NULL)
+    {
+        ListCacheWriter_Free(&font_errors);
+        log_error("Failed to create list state");
+        return ExitCodeError;
+    }
 
     // compute max_row_count after init, since MAIN_ROW_COUNT may depend on runtime state
-    state.max_row_count = MAIN_ROW_COUNT;
-    if (strlen(state.title) > 0)
+    state->max_row_count = MAIN_ROW_COUNT;
+    if (strlen(state->title) > 0)
     {
-        state.max_row_count -= 1;
+        state->max_row_count -= 1;
+    }
+
+    // with --progressive-load, wait only for the first screenful (and the
+    // --selected item); the rest of the list keeps loading while it is shown
+    if (state->list_state->loading)
+    {
+        ListTiming_Begin(&state->timing, LIST_TIMING_LOAD);
+        size_t wanted = (size_t)(state->max_row_count > 0 ? state->max_row_count : 1);
+        if (state->list_state->selected >= 0 && (size_t)state->list_state->selected + 1 > wanted)
+        {
+            wanted = (size_t)state->list_state->selected + 1;
+        }
+        while (state->list_state->loading && state->list_state->item_count < wanted)
+        {
+            // wait for as many more lines as items are missing; a jsonl line
+            // that turns out blank or malformed just means waiting again
+            ListLoader_Wait(state->list_state->loader, state->list_state->load_line + (wanted - state->list_state->item_count), -1);
+            ListState_PollLoader(state->list_state);
+        }
+
+        // the first screenful may be all headers or unselectable rows; keep
+        // reading a screenful at a time until something can be selected, so
+        // the check below only fails once the whole list is in
+        ListState_InitView(state->list_state, state->max_row_count);
+        while (state->list_state->loading && state->list_state->selected < 0)
+        {
+            ListLoader_Wait(state->list_state->loader, state->list_state->load_line + wanted, -1);
+            ListState_PollLoader(state->list_state);
+            ListState_InitView(state->list_state, state->max_row_count);
+        }
+        ListTiming_End(&state->timing, LIST_TIMING_LOAD);
     }
 
     // validate selection and compute initial visible window
-    ListState_InitView(state.list_state, state.max_row_count);
+    ListState_InitView(state->list_state, state->max_row_count);
 
     // resolve per-item images now that init() has run and FIXED_WIDTH/HEIGHT
     // reflect the real device resolution
-    ListState_ResolveImages(state.list_state, &state);
+    ListTiming_Begin(&state->timing, LIST_TIMING_IMAGES);
+    ListState_ResolveImages(state->list_state, state);
+    ListTiming_End(&state->timing, LIST_TIMING_IMAGES);
 
-    if (state.list_state->item_count == 0 || state.list_state->selected < 0)
+    if (state->list_state->item_count == 0 || state->list_state->selected < 0)
     {
+        ListCacheWriter_Free(&font_errors);
         log_error("No selectable items found");
         return ExitCodeError;
     }
@@ -4201,7 +6409,16 @@ int main(int argc, char *argv[])
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
-    if (!open_fonts(&state))
+    // an error that ran out of memory being written ends the replay
+    struct ListCacheReader reader = {font_errors.data, font_errors.data + font_errors.size, false};
+    while (reader.p < reader.end && !reader.failed)
+    {
+        const char *message = ListCacheReader_GetString(&reader);
+        if (message != NULL)
+            log_error(message);
+    }
+    ListCacheWriter_Free(&font_errors);
+    if (!fonts_opened)
     {
         log_error("Failed to open fonts");
         return ExitCodeError;
@@ -4211,16 +6428,17 @@ int main(int argc, char *argv[])
     // list, fonts, and screen are ready. This runs after the selectable-items
     // guard so an initial filter that matches nothing does not abort startup;
     // the main loop and draw path tolerate an empty (selected == -1) result.
-    if (state.allow_filter)
+    if (state->allow_filter)
     {
-        if (state.filter_input[0] != '\0')
+        if (state->filter_input[0] != '\0')
         {
-            strncpy(state.filter_text, state.filter_input, sizeof(state.filter_text) - 1);
-            ListState_ApplyFilter(state.list_state, state.filter_text, state.max_row_count);
+            strncpy(state->filter_text, state->filter_input, sizeof(state->filter_text) - 1);
+            ListState_ApplyFilter(state->list_state, state->filter_text, state->max_row_count);
+            ListState_FinishFilter(state->list_state, state->max_row_count);
         }
-        if (state.display_filter_keyboard)
+        if (state->display_filter_keyboard)
         {
-            open_filter_keyboard(&state);
+            open_filter_keyboard(state);
         }
     }
 
@@ -4228,15 +6446,15 @@ int main(int argc, char *argv[])
     int was_online = PLAT_isOnline();
 
     // draw the screen at least once
-    // handle_input sets state.redraw to 0 if no key is pressed
+    // handle_input sets state->redraw to 0 if no key is pressed
     int was_ever_drawn = 0;
 
-    if (state.disable_auto_sleep)
+    if (state->disable_auto_sleep)
     {
         PWR_disableAutosleep();
     }
 
-    while (!state.quitting && !signal_exit_code)
+    while (!state->quitting && !signal_exit_code)
     {
         // start the frame to ensure GFX_sync() works
         // on devices that don't support vsync
@@ -4247,9 +6465,9 @@ int main(int argc, char *argv[])
         // the second argument receives the active settings overlay
         // (0 = none, 1 = brightness, 2 = volume) so the volume/brightness
         // bar and hint can be drawn while the user changes those settings
-        PWR_update(&state.redraw, &state.show_brightness_setting, NULL, NULL);
+        PWR_update(&state->redraw, &state->show_brightness_setting, NULL, NULL);
         bool power_redraw = false;
-        if (state.redraw)
+        if (state->redraw)
         {
             power_redraw = true;
         }
@@ -4260,56 +6478,74 @@ int main(int argc, char *argv[])
         int is_online = PLAT_isOnline();
         if (was_online != is_online)
         {
-            state.redraw = 1;
+            state->redraw = 1;
         }
         was_online = is_online;
 
+        // show the filtered view once the filter worker has it ready
+        if (ListState_PollFilter(state->list_state, state->max_row_count))
+        {
+            state->redraw = 1;
+        }
+
+        // pick up items a --progressive-load loader has read since last frame
+        if (ListState_PollLoader(state->list_state))
+        {
+            ListState_ExtendView(state->list_state, state->max_row_count);
+            state->redraw = 1;
+        }
+
         // handle any input events
-        handle_input(&state);
+        handle_input(state);
 
         // force a redraw if the screen was never drawn
-        if (!was_ever_drawn && !state.redraw)
+        if (!was_ever_drawn && !state->redraw)
         {
-            state.redraw = 1;
+            state->redraw = 1;
             was_ever_drawn = 1;
         }
 
         // force a redraw if the power state changed
         if (power_redraw)
         {
-            state.redraw = 1;
+            state->redraw = 1;
         }
 
         // keep redrawing while a row is autoscrolling so the marquee animates.
         // this is self-sustaining: draw_screen re-arms scroll_active each frame
         // it draws a scrolling row, and clears it once nothing is scrolling.
-        if (state.scroll_active)
+        if (state->scroll_active)
         {
-            state.redraw = 1;
+            state->redraw = 1;
         }
 
         // redraw the screen if there has been a change
-        if (state.redraw)
+        if (state->redraw)
         {
+            if (state->timing.first_paint < 0)
+            {
+                ListTiming_Begin(&state->timing, LIST_TIMING_FIRST_FRAME);
+            }
+
             // clear the screen at the beginning of each loop
             GFX_clear(screen);
 
-            bool should_draw_background_image = draw_background(screen, &state);
+            bool should_draw_background_image = draw_background(screen, state);
 
             int ow = 0;
-            if (state.show_hardware_group)
+            if (state->show_hardware_group)
             {
                 // draw the hardware information in the top-right (battery/wifi,
                 // or the volume/brightness bar while a setting is being changed)
-                ow = GFX_blitHardwareGroup(screen, state.show_brightness_setting);
+                ow = GFX_blitHardwareGroup(screen, state->show_brightness_setting);
             }
 
             // decide what belongs in the bottom-left pill slot
-            switch (BottomLeftHint_For(state.show_hardware_group, state.show_brightness_setting, has_left_button_group(&state, state.list_state), GetHDMI()))
+            switch (BottomLeftHint_For(state->show_hardware_group, state->show_brightness_setting, has_left_button_group(state, state->list_state), GetHDMI()))
             {
             case BOTTOM_LEFT_SETTING_HINT:
                 // draw the volume/brightness setting hint
-                GFX_blitHardwareHints(screen, state.show_brightness_setting);
+                GFX_blitHardwareHints(screen, state->show_brightness_setting);
                 break;
             case BOTTOM_LEFT_SLEEP:
                 GFX_blitButtonGroup((char *[]){BTN_SLEEP == BTN_POWER ? "POWER" : "MENU", "SLEEP", NULL}, 0, screen, 0);
@@ -4319,10 +6555,21 @@ int main(int argc, char *argv[])
             }
 
             // your draw logic goes here
-            draw_screen(screen, &state, ow, should_draw_background_image);
+            draw_screen(screen, state, ow, should_draw_background_image);
 
             // Takes the screen buffer and displays it on the screen
             GFX_flip(screen);
+
+            // report the startup timings once the first frame is up
+            if (state->timing.first_paint < 0)
+            {
+                ListTiming_End(&state->timing, LIST_TIMING_FIRST_FRAME);
+                ListTiming_Paint(&state->timing);
+                if (state->timings[0] != '\0' && !ListTiming_Write(&state->timing, state->timings))
+                {
+                    log_error("Failed to write timings");
+                }
+            }
         }
         else
         {
@@ -4334,22 +6581,25 @@ int main(int argc, char *argv[])
 
     if (signal_exit_code)
     {
-        swallow_stdout_from_function(destruct);
+        if (!resident)
+        {
+            swallow_stdout_from_function(destruct);
+        }
         return signal_exit_code;
     }
 
-    int exit_code = write_output(&state);
+    int exit_code = write_output(state);
 
     // when filtering is enabled, emit the final filter value: to --filter-text-file
     // if set, and always as the last line of stderr. This runs regardless of the
     // exit code (signal-driven exits are handled above and skip this).
-    if (state.allow_filter)
+    if (state->allow_filter)
     {
-        if (state.filter_text_file[0] != '\0')
+        if (state->filter_text_file[0] != '\0')
         {
-            write_to_file(state.filter_text_file, state.filter_text);
+            write_to_file(state->filter_text_file, state->filter_text);
         }
-        fprintf(stderr, "%s\n", state.filter_text);
+        fprintf(stderr, "%s\n", state->filter_text);
     }
 
     if (exit_code != ExitCodeSuccess)
@@ -4357,8 +6607,233 @@ int main(int argc, char *argv[])
         return exit_code;
     }
 
-    swallow_stdout_from_function(destruct);
+    if (!resident)
+    {
+        swallow_stdout_from_function(destruct);
+    }
 
     // exit the program
-    return state.exit_code;
+    return state->exit_code;
+}
+
+// serve_request shows one list sent to a --serve server. The request's stdin,
+// stdout and stderr stand in for the server's own while it runs, and the
+// server's working directory is swapped for the client's, so the list is
+// read, logged and written exactly as the client would have done it.
+static int serve_request(struct ListServeRequest *request)
+{
+    fflush(stdout);
+    fflush(stderr);
+    int saved_fds[3];
+    for (int i = 0; i < 3; i++)
+    {
+        saved_fds[i] = dup(i);
+        set_cloexec(saved_fds[i]);
+        dup2(request->fds[i], i);
+    }
+
+    struct AppState state;
+    AppState_Init(&state);
+    int exit_code = ExitCodeError;
+    // getopt keeps its position between calls; 0 restarts it from scratch
+    optind = 0;
+    bool parsed = false;
+    if (chdir(request->cwd) != 0)
+    {
+        log_error("Failed to change to the client's working directory");
+    }
+    else
+    {
+        ListTiming_Begin(&state.timing, LIST_TIMING_ARGUMENTS);
+        parsed = parse_arguments(&state, request->argc, request->argv);
+        ListTiming_End(&state.timing, LIST_TIMING_ARGUMENTS);
+    }
+
+    if (parsed)
+    {
+        if (state.serve_socket[0] != '\0' || state.client_socket[0] != '\0')
+        {
+            log_error("--serve and --client cannot be sent to a server");
+        }
+        else
+        {
+            // a button still held from the previous list must not act on this one
+            PAD_reset();
+            exit_code = run_list(&state, true);
+            if (state.disable_auto_sleep)
+            {
+                PWR_enableAutosleep();
+            }
+        }
+    }
+
+    if (state.list_state != NULL)
+    {
+        ListState_Free(state.list_state);
+    }
+    // the default fonts stay open for the next list; fonts opened from
+    // --font-* paths are closed
+    if (state.fonts.large != NULL && state.fonts.large != font.large)
+    {
+        TTF_CloseFont(state.fonts.large);
+    }
+    if (state.fonts.medium != NULL && state.fonts.medium != font.medium)
+    {
+        TTF_CloseFont(state.fonts.medium);
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    for (int i = 0; i < 3; i++)
+    {
+        dup2(saved_fds[i], i);
+        close(saved_fds[i]);
+    }
+    return exit_code;
+}
+
+// serve runs a --serve server on socket_path. init() runs once, up front, and
+// the display, input, power management and default fonts stay up while the
+// lists that --client invocations send are shown one at a time, each
+// answered with its exit code. The server stops on SIGINT or SIGTERM.
+static int serve(const char *socket_path)
+{
+    int listen_fd = ListServe_Listen(socket_path);
+    if (listen_fd < 0)
+    {
+        log_error("Failed to listen on server socket");
+        return ExitCodeError;
+    }
+
+    char server_cwd[PATH_MAX];
+    if (getcwd(server_cwd, sizeof(server_cwd)) == NULL)
+    {
+        strcpy(server_cwd, "/");
+    }
+
+    swallow_stdout_from_function(init);
+    atexit(destruct);
+
+    // a client that goes away mid-list must not take the server with it
+    signal(SIGPIPE, SIG_IGN);
+
+    // installed without SA_RESTART, so a signal ends the wait for a request
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signal_handler;
+    sigemptyset(&action.sa_mask);
+
+    while (!signal_exit_code)
+    {
+        // run_list installs its own handlers, so these are set again each time
+        sigaction(SIGINT, &action, NULL);
+        sigaction(SIGTERM, &action, NULL);
+
+        int connection = accept(listen_fd, NULL, NULL);
+        if (connection < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            log_error("Failed to accept a client");
+            break;
+        }
+        set_cloexec(connection);
+
+        struct ListServeRequest request;
+        if (ListServe_ReceiveRequest(connection, &request))
+        {
+            int exit_code = serve_request(&request);
+            ListServe_SendExitCode(connection, exit_code);
+            ListServe_FreeRequest(&request);
+            if (chdir(server_cwd) != 0)
+            {
+                log_error("Failed to restore the server's working directory");
+            }
+        }
+        close(connection);
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+    swallow_stdout_from_function(destruct);
+    return signal_exit_code ? signal_exit_code : ExitCodeError;
+}
+
+// forward_to_server hands the list described by argv to the --serve server at
+// socket_path, along with this process's working directory, stdin, stdout and
+// stderr, and returns the exit code the server answers with. The --client
+// option itself is not forwarded. Returns -1 without sending anything when no
+// server is listening, so the caller can show the list itself.
+static int forward_to_server(const char *socket_path, int argc, char *argv[])
+{
+    int fd = ListServe_Connect(socket_path);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    char **forwarded = malloc(sizeof(char *) * (argc > 0 ? argc : 1));
+    int count = 0;
+    for (int i = 1; forwarded != NULL && i < argc; i++)
+    {
+        if (strcmp(argv[i], "--client") == 0)
+        {
+            i++;
+            continue;
+        }
+        if (strncmp(argv[i], "--client=", strlen("--client=")) == 0)
+        {
+            continue;
+        }
+        forwarded[count++] = argv[i];
+    }
+
+    char cwd[PATH_MAX];
+    int fds[3] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    bool sent = forwarded != NULL && getcwd(cwd, sizeof(cwd)) != NULL && ListServe_SendRequest(fd, count, forwarded, cwd, fds);
+    free(forwarded);
+
+    int exit_code;
+    if (!sent || !ListServe_ReceiveExitCode(fd, &exit_code))
+    {
+        log_error("Lost connection to the list server");
+        exit_code = ExitCodeError;
+    }
+    close(fd);
+    return exit_code;
+}
+
+// main is the entry point for the app
+int main(int argc, char *argv[])
+{
+    struct AppState state;
+    AppState_Init(&state);
+
+    // parse the arguments
+    ListTiming_Begin(&state.timing, LIST_TIMING_ARGUMENTS);
+    bool parsed = parse_arguments(&state, argc, argv);
+    ListTiming_End(&state.timing, LIST_TIMING_ARGUMENTS);
+    if (!parsed)
+    {
+        return ExitCodeError;
+    }
+
+    if (state.serve_socket[0] != '\0')
+    {
+        return serve(state.serve_socket);
+    }
+
+    // with no server listening, the list is shown from this process
+    if (state.client_socket[0] != '\0')
+    {
+        int exit_code = forward_to_server(state.client_socket, argc, argv);
+        if (exit_code >= 0)
+        {
+            return exit_code;
+        }
+    }
+
+    return run_list(&state, false);
 }
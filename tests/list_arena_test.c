@@ -0,0 +1,177 @@
+// Unit tests for the list arena allocator. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_arena.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+static void test_alloc_alignment(void)
+{
+    struct ListArena arena;
+    ListArena_Init(&arena);
+    CHECK_EQ(arena.reserved, 0, "init: nothing reserved");
+
+    char *a = ListArena_Alloc(&arena, 1);
+    void **b = ListArena_Alloc(&arena, sizeof(void *) * 3);
+    double *c = ListArena_Alloc(&arena, sizeof(double));
+    CHECK_EQ(a != NULL && b != NULL && c != NULL, true, "alloc: small allocations succeed");
+    CHECK_EQ((uintptr_t)b % sizeof(void *), 0, "alloc: pointer array aligned");
+    CHECK_EQ((uintptr_t)c % sizeof(double), 0, "alloc: double aligned");
+    CHECK_EQ(a != (char *)b && (char *)b != (char *)c, true, "alloc: distinct pointers");
+
+    void *zero_a = ListArena_Alloc(&arena, 0);
+    void *zero_b = ListArena_Alloc(&arena, 0);
+    CHECK_EQ(zero_a != NULL && zero_a != zero_b, true, "alloc: zero size is unique");
+
+    // writes to one allocation do not disturb its neighbours
+    memset(a, 'x', 1);
+    b[0] = b[1] = b[2] = NULL;
+    *c = 1.5;
+    CHECK_EQ(a[0], 'x', "alloc: neighbour intact");
+    CHECK_EQ(*c == 1.5, true, "alloc: value stored");
+
+    ListArena_Free(&arena);
+    CHECK_EQ(arena.head == NULL, true, "free: head cleared");
+    CHECK_EQ(arena.used, 0, "free: used cleared");
+}
+
+static void test_strdup(void)
+{
+    struct ListArena arena;
+    ListArena_Init(&arena);
+
+    const char *source = "Super Mario World";
+    char *copy = ListArena_Strdup(&arena, source);
+    CHECK_EQ(copy != source, true, "strdup: copies");
+    CHECK_EQ(strcmp(copy, source), 0, "strdup: same contents");
+
+    char *empty = ListArena_Strdup(&arena, "");
+    CHECK_EQ(empty != NULL && empty[0] == '\0', true, "strdup: empty string");
+
+    ListArena_Free(&arena);
+}
+
+static void test_many_blocks(void)
+{
+    struct ListArena arena;
+    ListArena_Init(&arena);
+
+    // enough names to spill across several blocks; every one must survive
+    char *names[20000];
+    for (int i = 0; i < 20000; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "item %d", i);
+        names[i] = ListArena_Strdup(&arena, name);
+    }
+
+    int intact = 0;
+    for (int i = 0; i < 20000; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "item %d", i);
+        if (names[i] != NULL && strcmp(names[i], name) == 0)
+            intact++;
+    }
+    CHECK_EQ(intact, 20000, "blocks: every string intact");
+    CHECK_EQ(arena.reserved > 64 * 1024, true, "blocks: spilled past one block");
+    CHECK_EQ(arena.used <= arena.reserved, true, "blocks: used within reserved");
+
+    ListArena_Free(&arena);
+    CHECK_EQ(arena.reserved, 0, "blocks: free releases everything");
+
+    // the arena is reusable after a free
+    CHECK_EQ(strcmp(ListArena_Strdup(&arena, "again"), "again"), 0, "blocks: reusable");
+    ListArena_Free(&arena);
+}
+
+static void test_large_allocation(void)
+{
+    struct ListArena arena;
+    ListArena_Init(&arena);
+
+    char *small_before = ListArena_Alloc(&arena, 16);
+    char *large = ListArena_Alloc(&arena, 200 * 1024);
+    char *small_after = ListArena_Alloc(&arena, 16);
+    CHECK_EQ(large != NULL, true, "large: allocated");
+    memset(large, 'L', 200 * 1024);
+    CHECK_EQ(large[200 * 1024 - 1], 'L', "large: whole range writable");
+
+    // the small allocation after a large one keeps using the current block
+    CHECK_EQ(small_after - small_before, 16, "large: head block still carved");
+
+    ListArena_Free(&arena);
+}
+
+static void test_adopt(void)
+{
+    struct ListArena arena;
+    struct ListArena worker;
+    ListArena_Init(&arena);
+    ListArena_Init(&worker);
+
+    // adopting into an empty arena takes the blocks as they are
+    char *first = ListArena_Strdup(&worker, "first");
+    ListArena_Adopt(&arena, &worker);
+    CHECK_EQ(worker.head == NULL && worker.used == 0 && worker.reserved == 0, true, "adopt: source left empty");
+    CHECK_EQ(strcmp(first, "first"), 0, "adopt: adopted string intact");
+
+    char *before = ListArena_Alloc(&arena, 16);
+    for (int i = 0; i < 10000; i++)
+        ListArena_Strdup(&worker, "spread over several worker blocks");
+    char *last = ListArena_Strdup(&worker, "last");
+    size_t used = arena.used + worker.used;
+    size_t reserved = arena.reserved + worker.reserved;
+    ListArena_Adopt(&arena, &worker);
+    CHECK_EQ(arena.used, used, "adopt: used summed");
+    CHECK_EQ(arena.reserved, reserved, "adopt: reserved summed");
+    CHECK_EQ(strcmp(last, "last"), 0, "adopt: later string intact");
+
+    // the arena keeps carving its own head block after adopting
+    char *after = ListArena_Alloc(&arena, 16);
+    CHECK_EQ(after - before, 16, "adopt: head block still carved");
+
+    // adopting an empty arena changes nothing
+    ListArena_Adopt(&arena, &worker);
+    CHECK_EQ(arena.used, used + 16, "adopt: empty source is a no-op");
+
+    ListArena_Free(&arena);
+    CHECK_EQ(arena.reserved, 0, "adopt: free releases adopted blocks");
+}
+
+int main(void)
+{
+    test_alloc_alignment();
+    test_strdup();
+    test_many_blocks();
+    test_large_allocation();
+    test_adopt();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
@@ -0,0 +1,195 @@
+// Unit tests for the list cache container. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+// Cache files are written under tmp/, which `make test` creates.
+
+#include "list_cache.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// sample_key returns a key as it would be built for a small source file.
+static struct ListCacheKey sample_key(void)
+{
+    struct stat st;
+    memset(&st, 0, sizeof(st));
+    st.st_size = 5;
+    struct ListCacheKey key;
+    ListCache_KeyFromSource(&key, &st, "[\"a\"]", 5);
+    key.settings_hash = ListCache_HashString("items", LIST_CACHE_HASH_SEED);
+    return key;
+}
+
+static void test_hash(void)
+{
+    uint64_t empty = ListCache_Hash("", 0, LIST_CACHE_HASH_SEED);
+    CHECK_EQ(empty == LIST_CACHE_HASH_SEED, true, "hash: empty input keeps the seed");
+    CHECK_EQ(ListCache_Hash("a", 1, LIST_CACHE_HASH_SEED) == 0xaf63dc4c8601ec8cULL, true, "hash: FNV-1a of 'a'");
+
+    uint64_t ab_c = ListCache_HashString("c", ListCache_HashString("ab", LIST_CACHE_HASH_SEED));
+    uint64_t a_bc = ListCache_HashString("bc", ListCache_HashString("a", LIST_CACHE_HASH_SEED));
+    CHECK_EQ(ab_c != a_bc, true, "hash: chained strings keep their boundaries");
+    CHECK_EQ(ListCache_HashString(NULL, LIST_CACHE_HASH_SEED) == ListCache_HashString("", LIST_CACHE_HASH_SEED), true, "hash: NULL is the empty string");
+}
+
+static void test_path(void)
+{
+    char path[4096];
+    CHECK_EQ(ListCache_Path(path, sizeof(path), "tmp", "tests/list_cache_test.c"), true, "path: resolved");
+    CHECK_EQ(strncmp(path, "tmp/", 4), 0, "path: inside the cache dir");
+    CHECK_EQ(strcmp(path + strlen(path) - 6, ".cache"), 0, "path: cache extension");
+    CHECK_EQ(strlen(path), 4 + 16 + 6, "path: fixed-width hash name");
+
+    char same[4096];
+    ListCache_Path(same, sizeof(same), "tmp", "./tests/../tests/list_cache_test.c");
+    CHECK_EQ(strcmp(path, same), 0, "path: canonicalized source");
+
+    CHECK_EQ(ListCache_Path(path, sizeof(path), "tmp", "tmp/does-not-exist.json"), false, "path: missing source");
+    CHECK_EQ(ListCache_Path(path, 8, "tmp", "tests/list_cache_test.c"), false, "path: too long");
+}
+
+static void test_round_trip(void)
+{
+    const char *path = "tmp/list_cache_round_trip.cache";
+    struct ListCacheKey key = sample_key();
+
+    struct ListCacheWriter writer;
+    ListCacheWriter_Init(&writer);
+    ListCacheWriter_PutU32(&writer, 3);
+    ListCacheWriter_PutU8(&writer, 0xab);
+    ListCacheWriter_PutString(&writer, "Super Mario World");
+    ListCacheWriter_PutString(&writer, NULL);
+    ListCacheWriter_PutString(&writer, "");
+    ListCacheWriter_PutU32(&writer, 0xffffffffu);
+    CHECK_EQ(ListCacheWriter_Commit(&writer, path, &key), true, "round trip: committed");
+    ListCacheWriter_Free(&writer);
+    CHECK_EQ(writer.data == NULL, true, "round trip: writer freed");
+
+    struct ListInput input;
+    struct ListCacheReader reader;
+    CHECK_EQ(ListCache_Open(&input, path, &key, &reader), true, "round trip: opened");
+    CHECK_EQ(ListCacheReader_GetU32(&reader), 3, "round trip: u32");
+    CHECK_EQ(ListCacheReader_GetU8(&reader), 0xab, "round trip: u8");
+    const char *name = ListCacheReader_GetString(&reader);
+    CHECK_EQ(strcmp(name, "Super Mario World"), 0, "round trip: string");
+    CHECK_EQ(name > input.data && name < input.data + input.size, true, "round trip: string used in place");
+    CHECK_EQ(ListCacheReader_GetString(&reader) == NULL, true, "round trip: absent string");
+    CHECK_EQ(reader.failed, false, "round trip: absent string is not a failure");
+    CHECK_EQ(strcmp(ListCacheReader_GetString(&reader), ""), 0, "round trip: empty string");
+    CHECK_EQ(ListCacheReader_GetU32(&reader) == 0xffffffffu, true, "round trip: max u32");
+    CHECK_EQ(reader.p == reader.end, true, "round trip: payload consumed");
+    CHECK_EQ(reader.failed, false, "round trip: no failure");
+
+    // reading past the end fails and stays failed
+    CHECK_EQ(ListCacheReader_GetU8(&reader), 0, "round trip: read past end is zero");
+    CHECK_EQ(reader.failed, true, "round trip: read past end fails");
+    ListInput_Close(&input);
+}
+
+static void test_stale(void)
+{
+    const char *path = "tmp/list_cache_stale.cache";
+    struct ListCacheKey key = sample_key();
+
+    struct ListCacheWriter writer;
+    ListCacheWriter_Init(&writer);
+    ListCacheWriter_PutString(&writer, "item");
+    ListCacheWriter_Commit(&writer, path, &key);
+    ListCacheWriter_Free(&writer);
+
+    struct ListInput input;
+    struct ListCacheReader reader;
+    struct ListCacheKey other = key;
+    other.content_hash++;
+    CHECK_EQ(ListCache_Open(&input, path, &other, &reader), false, "stale: content changed");
+    CHECK_EQ(input.data == NULL, true, "stale: input closed");
+
+    other = key;
+    other.source_mtime_nsec++;
+    CHECK_EQ(ListCache_Open(&input, path, &other, &reader), false, "stale: mtime changed");
+
+    other = key;
+    other.settings_hash++;
+    CHECK_EQ(ListCache_Open(&input, path, &other, &reader), false, "stale: settings changed");
+
+    CHECK_EQ(ListCache_Open(&input, "tmp/list_cache_missing.cache", &key, &reader), false, "stale: missing file");
+
+    // a truncated file no longer matches its recorded payload size
+    FILE *file = fopen(path, "r+b");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    if (truncate(path, size - 1) != 0)
+    {
+        perror(path);
+        exit(1);
+    }
+    CHECK_EQ(ListCache_Open(&input, path, &key, &reader), false, "stale: truncated file");
+
+    file = fopen(path, "wb");
+    fputs("not a cache file at all, just some text that is long enough to hold a header", file);
+    fclose(file);
+    CHECK_EQ(ListCache_Open(&input, path, &key, &reader), false, "stale: wrong magic");
+}
+
+static void test_malformed_payload(void)
+{
+    // a string whose recorded length runs past the payload
+    char bad_length[] = {5, 0, 0, 0, 'a', 'b', '\0'};
+    struct ListCacheReader reader = {bad_length, bad_length + sizeof(bad_length), false};
+    CHECK_EQ(ListCacheReader_GetString(&reader) == NULL, true, "malformed: long string rejected");
+    CHECK_EQ(reader.failed, true, "malformed: long string fails");
+
+    // a string that is not terminated where its length says
+    char bad_terminator[] = {2, 0, 0, 0, 'a', 'b', 'c'};
+    reader = (struct ListCacheReader){bad_terminator, bad_terminator + sizeof(bad_terminator), false};
+    CHECK_EQ(ListCacheReader_GetString(&reader) == NULL, true, "malformed: unterminated string rejected");
+    CHECK_EQ(reader.failed, true, "malformed: unterminated string fails");
+
+    // a count larger than the remaining payload
+    char bad_count[] = {100, 0, 0, 0, 1, 2, 3};
+    reader = (struct ListCacheReader){bad_count, bad_count + sizeof(bad_count), false};
+    CHECK_EQ(ListCacheReader_GetCount(&reader), 0, "malformed: oversized count is zero");
+    CHECK_EQ(reader.failed, true, "malformed: oversized count fails");
+
+    char good_count[] = {3, 0, 0, 0, 1, 2, 3};
+    reader = (struct ListCacheReader){good_count, good_count + sizeof(good_count), false};
+    CHECK_EQ(ListCacheReader_GetCount(&reader), 3, "malformed: plausible count accepted");
+    CHECK_EQ(reader.failed, false, "malformed: plausible count does not fail");
+}
+
+int main(void)
+{
+    test_hash();
+    test_path();
+    test_round_trip();
+    test_stale();
+    test_malformed_payload();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
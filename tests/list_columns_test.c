@@ -0,0 +1,115 @@
+// Unit tests for the feature columns of text-format lines. These have no
+// SDL/display dependencies, so they run headless with the host compiler via
+// `make test`.
+
+#include "list_columns.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+static void test_plain(void)
+{
+    struct ListColumnsLine parsed;
+    char line[] = "Just a name";
+    ListColumns_Parse(line, &parsed);
+    CHECK_EQ(parsed.name == line, true, "plain: name is the line");
+    CHECK_EQ(parsed.count, 0, "plain: no columns");
+    CHECK_EQ(strcmp(line, "Just a name"), 0, "plain: line untouched");
+}
+
+static void test_columns(void)
+{
+    struct ListColumnsLine parsed;
+    char line[] = "Wi-Fi\tdisabled=true\timage=/mnt/SDCARD/a=b.png\talignment=center";
+    ListColumns_Parse(line, &parsed);
+    CHECK_EQ(parsed.count, 3, "columns: count");
+    CHECK_EQ(strcmp(parsed.name, "Wi-Fi"), 0, "columns: name");
+    CHECK_EQ(parsed.columns[0].key, LIST_COLUMN_DISABLED, "columns: first key");
+    CHECK_EQ(strcmp(parsed.columns[0].value, "true"), 0, "columns: first value");
+    CHECK_EQ(parsed.columns[1].key, LIST_COLUMN_IMAGE, "columns: second key");
+    CHECK_EQ(strcmp(parsed.columns[1].value, "/mnt/SDCARD/a=b.png"), 0, "columns: value keeps later equals signs");
+    CHECK_EQ(parsed.columns[2].key, LIST_COLUMN_ALIGNMENT, "columns: third key");
+    CHECK_EQ(strcmp(parsed.columns[2].value, "center"), 0, "columns: third value");
+    CHECK_EQ(parsed.name == line, true, "columns: name points into the line");
+    CHECK_EQ(parsed.columns[0].value > line && parsed.columns[2].value < line + sizeof(line), true, "columns: values point into the line");
+
+    char crlf[] = "Header\tis_header=true\r";
+    ListColumns_Parse(crlf, &parsed);
+    CHECK_EQ(parsed.count, 1, "columns: crlf line");
+    CHECK_EQ(strcmp(parsed.columns[0].value, "true"), 0, "columns: carriage return dropped");
+
+    char empty_name[] = "\tunselectable=true";
+    ListColumns_Parse(empty_name, &parsed);
+    CHECK_EQ(parsed.count, 1, "columns: empty name allowed");
+    CHECK_EQ(parsed.name[0], '\0', "columns: empty name");
+}
+
+// check_verbatim asserts that text is not read as a feature line and is left
+// exactly as it was.
+static void check_verbatim(const char *text, const char *msg)
+{
+    struct ListColumnsLine parsed;
+    char line[256];
+    snprintf(line, sizeof(line), "%s", text);
+    ListColumns_Parse(line, &parsed);
+    CHECK_EQ(parsed.count == 0 && parsed.name == line && strcmp(line, text) == 0, true, msg);
+}
+
+static void test_verbatim(void)
+{
+    check_verbatim("Title\tSubtitle", "verbatim: column without equals");
+    check_verbatim("Name\tcolour=red", "verbatim: unknown key");
+    check_verbatim("Name\tdisabled=yes", "verbatim: boolean not true or false");
+    check_verbatim("Name\talignment=middle", "verbatim: unknown alignment");
+    check_verbatim("Name\timage=", "verbatim: empty string value");
+    check_verbatim("Name\tdisabled=true\tnotes", "verbatim: one bad column spoils the line");
+    check_verbatim("Name\t", "verbatim: trailing tab");
+    check_verbatim("Name\tdisabled=true\t\tis_header=true", "verbatim: empty column");
+
+    char many[512] = "Name";
+    for (int i = 0; i <= LIST_COLUMNS_MAX; i++)
+        strcat(many, "\tdisabled=true");
+    check_verbatim(many, "verbatim: too many columns");
+}
+
+static void test_key_kinds(void)
+{
+    CHECK_EQ(ListColumns_KeyIsBoolean(LIST_COLUMN_IS_HEADER), true, "kinds: is_header");
+    CHECK_EQ(ListColumns_KeyIsBoolean(LIST_COLUMN_DISPLAY_ON_FILTER), true, "kinds: display_on_filter");
+    CHECK_EQ(ListColumns_KeyIsBoolean(LIST_COLUMN_IMAGE), false, "kinds: image");
+    CHECK_EQ(ListColumns_KeyIsBoolean(LIST_COLUMN_CONFIRM_TEXT), false, "kinds: confirm_text");
+}
+
+int main(void)
+{
+    test_plain();
+    test_columns();
+    test_verbatim();
+    test_key_kinds();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
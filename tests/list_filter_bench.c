@@ -0,0 +1,199 @@
+// Host benchmark for the keyboard filter. It builds a catalog of names shaped
+// like a large ROM library and times one keystroke's worth of filtering, the
+// scan ListState_ApplyFilter runs over every item, for filters of growing
+// length: once folding each name on the fly with ListFilter_ItemVisible, once
+// against search keys folded when the list is loaded, as the app does, and
+// once verifying only the candidates of a --filter-index trigram index. It
+// also times --filter-mode fuzzy scoring every search key.
+// Run it with `make bench`, which builds it twice: once with the vectorized
+// scan and once with -DLIST_FILTER_NO_SIMD.
+
+#include "list_filter.h"
+#include "list_trigram.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// the number of names, matching a large ROM library
+#define BENCH_NAMES 100000
+// how many times each pass runs; the fastest run is reported
+#define BENCH_RUNS 5
+// one frame at 60 frames per second, in milliseconds
+#define BENCH_FRAME_MS 16.7
+
+struct Catalog
+{
+    char **names;
+    const char **keys;
+    size_t *lengths;
+    struct ListTrigramIndex index;
+    uint32_t *candidates;
+};
+
+static void catalog_generate(struct Catalog *catalog)
+{
+    const char *titles[] = {"Super Adventure", "Pokémon Émeraude", "Legend of the Hero", "Ninja Gaiden", "Dragon Quest", "Castlevania"};
+    const char *regions[] = {"USA", "Europe", "Japan", "World"};
+    catalog->names = malloc(sizeof(char *) * BENCH_NAMES);
+    catalog->keys = malloc(sizeof(char *) * BENCH_NAMES);
+    catalog->lengths = malloc(sizeof(size_t) * BENCH_NAMES);
+    if (catalog->names == NULL || catalog->keys == NULL || catalog->lengths == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    char name[256];
+    for (size_t i = 0; i < BENCH_NAMES; i++)
+    {
+        int length = snprintf(name, sizeof(name), "%s %zu - Part %zu (%s) [Rev %zu]", titles[i % 6], i, i % 7, regions[i % 4], i % 3);
+        catalog->names[i] = strdup(name);
+        char *key = malloc(length + 1);
+        if (catalog->names[i] == NULL || key == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+        ListFilter_Fold(key, name, length);
+        key[length] = '\0';
+        catalog->keys[i] = key;
+        catalog->lengths[i] = length;
+    }
+}
+
+static const char *catalog_key(void *context, size_t i, size_t *length, bool *always)
+{
+    const struct Catalog *catalog = context;
+    *length = catalog->lengths[i];
+    *always = false;
+    return catalog->keys[i];
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// pass_names filters by folding every name on each call.
+static size_t pass_names(const struct Catalog *catalog, const char *filter)
+{
+    size_t visible = 0;
+    for (size_t i = 0; i < BENCH_NAMES; i++)
+    {
+        if (ListFilter_ItemVisible(false, false, catalog->names[i], filter))
+            visible++;
+    }
+    return visible;
+}
+
+// pass_keys folds the filter once and matches it against the search keys.
+static size_t pass_keys(const struct Catalog *catalog, const char *filter)
+{
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, filter);
+    size_t visible = 0;
+    for (size_t i = 0; i < BENCH_NAMES; i++)
+    {
+        if (ListFilter_KeyVisible(false, false, catalog->keys[i], catalog->lengths[i], &query))
+            visible++;
+    }
+    return visible;
+}
+
+// pass_index verifies the candidates of the trigram index, falling back to
+// the search keys for filters shorter than a trigram.
+static size_t pass_index(const struct Catalog *catalog, const char *filter)
+{
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, filter);
+    if (ListTrigramIndex_Estimate(&catalog->index, query.text, query.length) == SIZE_MAX)
+        return pass_keys(catalog, filter);
+
+    size_t count = ListTrigramIndex_Candidates(&catalog->index, query.text, query.length, catalog->candidates);
+    size_t visible = 0;
+    for (size_t c = 0; c < count; c++)
+    {
+        uint32_t i = catalog->candidates[c];
+        if (ListFilter_KeyVisible(false, false, catalog->keys[i], catalog->lengths[i], &query))
+            visible++;
+    }
+    return visible;
+}
+
+// pass_fuzzy scores every search key as --filter-mode fuzzy does.
+static size_t pass_fuzzy(const struct Catalog *catalog, const char *filter)
+{
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, filter);
+    size_t visible = 0;
+    for (size_t i = 0; i < BENCH_NAMES; i++)
+    {
+        int score;
+        if (ListFilter_FuzzyMatch(catalog->names[i], catalog->keys[i], catalog->lengths[i], &query, &score, NULL))
+            visible++;
+    }
+    return visible;
+}
+
+static void run(const char *name, const struct Catalog *catalog, const char *filter, size_t (*pass)(const struct Catalog *, const char *), size_t *visible)
+{
+    double best = 0;
+    for (int i = 0; i < BENCH_RUNS; i++)
+    {
+        double start = now_ms();
+        *visible = pass(catalog, filter);
+        double elapsed = now_ms() - start;
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    printf("  %-13s %8.2f ms  %5.1f frames\n", name, best, best / BENCH_FRAME_MS);
+}
+
+int main(void)
+{
+#if defined(LIST_FILTER_NO_SIMD)
+    const char *scanner = "scalar";
+#else
+    const char *scanner = "vectorized where supported";
+#endif
+    printf("list_filter benchmark (%s scan, %d names)\n", scanner, BENCH_NAMES);
+
+    struct Catalog catalog;
+    catalog_generate(&catalog);
+    double start = now_ms();
+    catalog.candidates = malloc(sizeof(uint32_t) * BENCH_NAMES);
+    if (catalog.candidates == NULL || !ListTrigramIndex_Build(&catalog.index, BENCH_NAMES, catalog_key, &catalog))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    printf("trigram index: %.2f ms to build, %.1f MB\n", now_ms() - start, ListTrigramIndex_Bytes(&catalog.index) / (1024.0 * 1024.0));
+
+    const char *filters[] = {"e", "DRAG", "émeraude 4", "part 3 (japan)", "zzz"};
+    for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); f++)
+    {
+        size_t by_name;
+        size_t by_key;
+        size_t by_index;
+        printf("filter \"%s\"\n", filters[f]);
+        run("names", &catalog, filters[f], pass_names, &by_name);
+        run("search keys", &catalog, filters[f], pass_keys, &by_key);
+        run("trigram index", &catalog, filters[f], pass_index, &by_index);
+        if (by_name != by_key || by_key != by_index)
+        {
+            fprintf(stderr, "the passes disagree: %zu, %zu and %zu names visible\n", by_name, by_key, by_index);
+            return 1;
+        }
+        printf("  (%zu names visible)\n", by_key);
+
+        size_t by_fuzzy;
+        run("fuzzy", &catalog, filters[f], pass_fuzzy, &by_fuzzy);
+        printf("  (%zu names visible)\n", by_fuzzy);
+    }
+    return 0;
+}
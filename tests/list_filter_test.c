@@ -5,6 +5,8 @@
 #include "list_filter.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 static int checks = 0;
 static int failures = 0;
@@ -99,6 +101,280 @@ static void test_item_visible(void)
     CHECK_EQ(ListFilter_ItemVisible(false, true, "Add All", "add"), true, "visible: pinned item matching");
 }
 
+// fold returns text case-folded into a static buffer, for comparing with
+// strcmp.
+static const char *fold(const char *text)
+{
+    static char buf[128];
+    size_t length = strlen(text);
+    ListFilter_Fold(buf, text, length);
+    buf[length] = '\0';
+    return buf;
+}
+
+static void test_fold(void)
+{
+    CHECK_EQ(strcmp(fold("Super MARIO 64!"), "super mario 64!"), 0, "fold: ascii");
+    CHECK_EQ(strcmp(fold("POKÉMON Ñandú"), "pokémon ñandú"), 0, "fold: latin-1");
+    CHECK_EQ(strcmp(fold("ŁÓDŹ ŒUVRE Ÿ"), "łódź œuvre ÿ"), 0, "fold: latin extended-a");
+    CHECK_EQ(strcmp(fold("ΚΑΛΗΜΈΡΑ ΌΛΟΙ"), "καλημέρα όλοι"), 0, "fold: greek");
+    CHECK_EQ(strcmp(fold("ς"), "σ"), 0, "fold: final sigma");
+    CHECK_EQ(strcmp(fold("ПРИВЕТ ЁЖ Ґ"), "привет ёж ґ"), 0, "fold: cyrillic");
+    CHECK_EQ(strcmp(fold("ՀԱՅ"), "հայ"), 0, "fold: armenian");
+    CHECK_EQ(strcmp(fold("TIẾNG VIỆT"), "tiếng việt"), 0, "fold: vietnamese");
+    CHECK_EQ(strcmp(fold("ＡＢＣ"), "ａｂｃ"), 0, "fold: fullwidth");
+    // folds that would change the length in bytes are left alone
+    CHECK_EQ(strcmp(fold("İ ẞ ſ"), "İ ẞ ſ"), 0, "fold: length-changing folds skipped");
+    CHECK_EQ(strcmp(fold("× ß 日本 😀"), "× ß 日本 😀"), 0, "fold: uncased characters");
+    // malformed UTF-8 is copied as is
+    CHECK_EQ(strcmp(fold("A\xC3Z\xC3"), "a\xC3z\xC3"), 0, "fold: truncated sequence");
+    CHECK_EQ(strcmp(fold("\xC0\x81\xED\xA0\x80"), "\xC0\x81\xED\xA0\x80"), 0, "fold: overlong and surrogate");
+
+    CHECK_EQ(ListFilter_IsFolded("zelda 64", 8), true, "folded: lowercase");
+    CHECK_EQ(ListFilter_IsFolded("zelda 64 é", strlen("zelda 64 é")), true, "folded: lowercase accent");
+    CHECK_EQ(ListFilter_IsFolded("zeldA", 5), false, "folded: ascii capital");
+    CHECK_EQ(ListFilter_IsFolded("zeldÉ", strlen("zeldÉ")), false, "folded: accented capital");
+    CHECK_EQ(ListFilter_IsFolded("zeldA", 4), true, "folded: only length bytes");
+}
+
+static void test_match_unicode(void)
+{
+    CHECK_MATCH("Pokémon Émeraude", "ÉMERAUDE", true, 9, 9, "unicode: accented filter");
+    CHECK_MATCH("ΣΩΚΡΆΤΗΣ", "σωκράτης", true, 0, 16, "unicode: greek");
+    CHECK_MATCH("Ёжик в тумане", "ТУМАН", true, 12, 10, "unicode: cyrillic");
+    CHECK_MATCH("Pokemon", "Pokémon", false, 0, 0, "unicode: accents are significant");
+}
+
+static void test_match_key(void)
+{
+    struct ListFilterQuery query;
+    size_t start = 99;
+
+    ListFilter_Prepare(&query, NULL);
+    CHECK_EQ(query.length, 0, "key: NULL filter is empty");
+    CHECK_EQ(ListFilter_MatchKey("abc", 3, &query, &start), true, "key: empty query matches");
+    CHECK_EQ(start, 0, "key: empty query at 0");
+
+    ListFilter_Prepare(&query, "MaRio");
+    CHECK_EQ(strcmp(query.text, "mario"), 0, "key: query folded");
+    CHECK_EQ(ListFilter_MatchKey("super mario", 11, &query, &start), true, "key: match");
+    CHECK_EQ(start, 6, "key: match offset");
+    CHECK_EQ(ListFilter_MatchKey("super mario", 10, &query, &start), false, "key: only key_length bytes");
+    CHECK_EQ(start, 0, "key: no match offset");
+
+    // a long filter is cut short at a character boundary
+    char long_filter[LIST_FILTER_QUERY_MAX + 8];
+    memset(long_filter, 'a', LIST_FILTER_QUERY_MAX - 2);
+    strcpy(long_filter + LIST_FILTER_QUERY_MAX - 2, "éé");
+    ListFilter_Prepare(&query, long_filter);
+    CHECK_EQ(query.length, LIST_FILTER_QUERY_MAX - 2, "key: long filter cut");
+}
+
+// test_match_key_offsets moves the match across every offset of the 16-byte
+// blocks the vectorized scan reads, next to near misses that share its first
+// and last bytes, so a bad mask or tail shows up as a wrong offset.
+static void test_match_key_offsets(void)
+{
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, "axya");
+    char key[128];
+    int wrong_found = 0;
+    int wrong_missing = 0;
+    for (size_t length = 4; length < 64; length++)
+    {
+        for (size_t offset = 0; offset + 4 <= length; offset++)
+        {
+            // "azza" near misses everywhere else
+            for (size_t i = 0; i < length; i++)
+                key[i] = "azza"[i % 4];
+            memcpy(key + offset, "axya", 4);
+            size_t start;
+            if (!ListFilter_MatchKey(key, length, &query, &start) || start > offset)
+                wrong_found++;
+        }
+
+        memset(key, 'a', length);
+        key[length] = 'x';
+        key[length + 1] = 'y';
+        key[length + 2] = 'a';
+        if (ListFilter_MatchKey(key, length, &query, NULL))
+            wrong_missing++;
+    }
+    CHECK_EQ(wrong_found, 0, "offsets: match at every offset");
+    CHECK_EQ(wrong_missing, 0, "offsets: no match past the key");
+
+    ListFilter_Prepare(&query, "a");
+    size_t start;
+    CHECK_EQ(ListFilter_MatchKey("bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbba", 37, &query, &start), true, "offsets: single byte filter");
+    CHECK_EQ(start, 36, "offsets: single byte filter offset");
+}
+
+static void test_key_visible(void)
+{
+    struct ListFilterQuery empty;
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&empty, "");
+    ListFilter_Prepare(&query, "APP");
+
+    CHECK_EQ(ListFilter_KeyVisible(true, false, "fruits", 6, &empty), true, "key visible: empty query");
+    CHECK_EQ(ListFilter_KeyVisible(false, false, "apple", 5, &query), true, "key visible: match");
+    CHECK_EQ(ListFilter_KeyVisible(false, false, "pear", 4, &query), false, "key visible: no match");
+    CHECK_EQ(ListFilter_KeyVisible(true, false, "apples", 6, &query), false, "key visible: header hidden");
+    CHECK_EQ(ListFilter_KeyVisible(false, true, "add all", 7, &query), true, "key visible: pinned");
+}
+
+static void test_narrows(void)
+{
+    struct ListFilterQuery empty;
+    struct ListFilterQuery ma;
+    struct ListFilterQuery mar;
+    struct ListFilterQuery ar;
+    struct ListFilterQuery zel;
+    ListFilter_Prepare(&empty, "");
+    ListFilter_Prepare(&ma, "ma");
+    ListFilter_Prepare(&mar, "MAR");
+    ListFilter_Prepare(&ar, "ar");
+    ListFilter_Prepare(&zel, "zel");
+
+    CHECK_EQ(ListFilter_Narrows(&empty, &ma), true, "narrows: from empty");
+    CHECK_EQ(ListFilter_Narrows(&ma, &mar), true, "narrows: typed a character");
+    CHECK_EQ(ListFilter_Narrows(&ar, &mar), true, "narrows: contained, not a prefix");
+    CHECK_EQ(ListFilter_Narrows(&mar, &ma), false, "narrows: deleted a character");
+    CHECK_EQ(ListFilter_Narrows(&ma, &ma), false, "narrows: same query");
+    CHECK_EQ(ListFilter_Narrows(&ma, &zel), false, "narrows: unrelated");
+    CHECK_EQ(ListFilter_Narrows(&ma, &empty), false, "narrows: cleared");
+}
+
+// history_visible returns a heap array of count indices starting at first,
+// for pushing onto a history.
+static int *history_visible(int first, int count)
+{
+    int *visible = malloc(sizeof(int) * (count > 0 ? count : 1));
+    for (int i = 0; i < count; i++)
+        visible[i] = first + i;
+    return visible;
+}
+
+static void test_history(void)
+{
+    struct ListFilterHistory history;
+    struct ListFilterQuery queries[LIST_FILTER_HISTORY_MAX + 2];
+    char text[LIST_FILTER_HISTORY_MAX + 3] = "";
+    for (int i = 0; i < LIST_FILTER_HISTORY_MAX + 2; i++)
+    {
+        ListFilter_Prepare(&queries[i], text);
+        strcat(text, "a");
+    }
+
+    ListFilterHistory_Init(&history);
+    struct ListFilterLevel level;
+    CHECK_EQ(ListFilterHistory_Take(&history, &queries[0], &level), false, "history: empty");
+
+    // typing pushes the view each character narrowed from
+    for (int i = 0; i < 3; i++)
+        CHECK_EQ(ListFilterHistory_Push(&history, &queries[i], history_visible(i, 10 - i), 10 - i, 100 + i), true, "history: push");
+    CHECK_EQ(history.count, 3, "history: three levels");
+
+    // backspace takes the top level
+    CHECK_EQ(ListFilterHistory_Take(&history, &queries[2], &level), true, "history: take top");
+    CHECK_EQ(level.visible_count, 8, "history: top count");
+    CHECK_EQ(level.visible[0], 2, "history: top visible");
+    CHECK_EQ(level.item_count, 102, "history: top item count");
+    CHECK_EQ(level.query == NULL, true, "history: query released");
+    CHECK_EQ(history.count, 2, "history: top removed");
+    free(level.visible);
+
+    // a query with no level leaves the history alone
+    CHECK_EQ(ListFilterHistory_Take(&history, &queries[5], &level), false, "history: missing query");
+    CHECK_EQ(history.count, 2, "history: unchanged");
+
+    // clearing takes the oldest level and drops the ones above it
+    CHECK_EQ(ListFilterHistory_Take(&history, &queries[0], &level), true, "history: take bottom");
+    CHECK_EQ(level.visible_count, 10, "history: bottom count");
+    CHECK_EQ(history.count, 0, "history: emptied");
+    free(level.visible);
+
+    // a full history drops its oldest level
+    for (int i = 0; i < LIST_FILTER_HISTORY_MAX + 1; i++)
+        ListFilterHistory_Push(&history, &queries[i], history_visible(0, 1), 1, 0);
+    CHECK_EQ(history.count, LIST_FILTER_HISTORY_MAX, "history: capped");
+    CHECK_EQ(ListFilterHistory_Take(&history, &queries[0], &level), false, "history: oldest dropped");
+    CHECK_EQ(ListFilterHistory_Take(&history, &queries[1], &level), true, "history: next oldest kept");
+    free(level.visible);
+
+    ListFilterHistory_Push(&history, &queries[0], history_visible(0, 1), 1, 0);
+    ListFilterHistory_Clear(&history);
+    CHECK_EQ(history.count, 0, "history: cleared");
+}
+
+static void test_parse_mode(void)
+{
+    CHECK_EQ(ListFilter_ParseMode("fuzzy"), LIST_FILTER_FUZZY, "mode: fuzzy");
+    CHECK_EQ(ListFilter_ParseMode("substring"), LIST_FILTER_SUBSTRING, "mode: substring");
+    CHECK_EQ(ListFilter_ParseMode(""), LIST_FILTER_SUBSTRING, "mode: empty");
+    CHECK_EQ(ListFilter_ParseMode(NULL), LIST_FILTER_SUBSTRING, "mode: NULL");
+}
+
+// fuzzy_score folds name and returns its fuzzy score against filter, or -1
+// when it does not match.
+static int fuzzy_score(const char *name, const char *filter)
+{
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, filter);
+    char key[256];
+    size_t length = strlen(name);
+    ListFilter_Fold(key, name, length);
+    int score;
+    return ListFilter_FuzzyMatch(name, key, length, &query, &score, NULL) ? score : -1;
+}
+
+static void test_fuzzy_match(void)
+{
+    CHECK_EQ(fuzzy_score("Super Mario World", "smw") >= 0, true, "fuzzy: initials match");
+    CHECK_EQ(fuzzy_score("Super Mario World", "SMW") >= 0, true, "fuzzy: ignores case");
+    CHECK_EQ(fuzzy_score("Super Mario World", "mario") >= 0, true, "fuzzy: substring matches");
+    CHECK_EQ(fuzzy_score("Super Mario World", "wms"), -1, "fuzzy: order matters");
+    CHECK_EQ(fuzzy_score("Super Mario World", "smwx"), -1, "fuzzy: every character needed");
+    CHECK_EQ(fuzzy_score("", "a"), -1, "fuzzy: empty name");
+    CHECK_EQ(fuzzy_score("anything", ""), 0, "fuzzy: empty query scores 0");
+    CHECK_EQ(fuzzy_score("Pokémon Émeraude", "pém") >= 0, true, "fuzzy: multibyte character");
+    CHECK_EQ(fuzzy_score("Pok\xc3\xa9mon", "\xc3\xa9") >= 0, true, "fuzzy: whole character");
+    // é is C3 A9; the bytes of Ã (C3 83) and © (C2 A9) must not make one up
+    CHECK_EQ(fuzzy_score("\xc3\x83\xc2\xa9", "\xc3\xa9"), -1, "fuzzy: characters are not split");
+
+    // word starts, camelCase humps and runs beat scattered characters
+    CHECK_EQ(fuzzy_score("Super Mario World", "smw") > fuzzy_score("Sam's Meadow", "smw"), true, "fuzzy: word starts rank higher");
+    CHECK_EQ(fuzzy_score("MegaMan", "mm") > fuzzy_score("Mamma", "mm"), true, "fuzzy: camelCase hump");
+    CHECK_EQ(fuzzy_score("Metroid", "met") > fuzzy_score("Mega Turrican", "met"), true, "fuzzy: consecutive run");
+    CHECK_EQ(fuzzy_score("Tetris", "tet") > fuzzy_score("Street Tetris", "tet"), true, "fuzzy: first character");
+    CHECK_EQ(fuzzy_score("Zelda 2", "z2") > fuzzy_score("Zelda Link to the Past 2", "z2"), true, "fuzzy: shorter gap");
+    CHECK_EQ(fuzzy_score("Sonic3", "s3") > fuzzy_score("Soni13", "s3"), true, "fuzzy: start of a number");
+
+    // the match is tightened to the shortest window ending where the first
+    // one does
+    struct ListFilterQuery query;
+    ListFilter_Prepare(&query, "ab");
+    size_t positions[2];
+    CHECK_EQ(ListFilter_FuzzyMatch(NULL, "a-a-ab", 6, &query, NULL, positions), true, "fuzzy: tight match");
+    CHECK_EQ(positions[0], 4, "fuzzy: tight match start");
+    CHECK_EQ(positions[1], 5, "fuzzy: tight match end");
+}
+
+static void test_fuzzy_highlight(void)
+{
+    size_t positions[8];
+    CHECK_EQ(ListFilter_FuzzyHighlight("Super Mario World", "smw", positions), 3, "highlight: one per character");
+    CHECK_EQ(positions[0], 0, "highlight: S");
+    CHECK_EQ(positions[1], 6, "highlight: M");
+    CHECK_EQ(positions[2], 12, "highlight: W");
+    CHECK_EQ(ListFilter_FuzzyHighlight("Pokémon", "éo", positions), 2, "highlight: multibyte counts once");
+    CHECK_EQ(positions[0], 3, "highlight: é");
+    CHECK_EQ(positions[1], 6, "highlight: o after é");
+    CHECK_EQ(ListFilter_FuzzyHighlight("Pokémon", "x", positions), 0, "highlight: no match");
+    CHECK_EQ(ListFilter_FuzzyHighlight("Pokémon", "", positions), 0, "highlight: empty filter");
+    CHECK_EQ(ListFilter_FuzzyHighlight(NULL, "p", positions), 0, "highlight: NULL name");
+}
+
 int main(void)
 {
     test_match_basic();
@@ -106,6 +382,16 @@ int main(void)
     test_match_empty_and_null();
     test_match_edge();
     test_item_visible();
+    test_fold();
+    test_match_unicode();
+    test_match_key();
+    test_match_key_offsets();
+    test_key_visible();
+    test_narrows();
+    test_history();
+    test_parse_mode();
+    test_fuzzy_match();
+    test_fuzzy_highlight();
 
     if (failures == 0)
     {
@@ -0,0 +1,203 @@
+// Unit tests for inflating gzip-compressed lists. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_gzip.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// gzip compresses size bytes of data into a new buffer, setting *out_size.
+static unsigned char *gzip(const char *data, size_t size, size_t *out_size)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    size_t capacity = deflateBound(&stream, size);
+    unsigned char *out = malloc(capacity);
+    stream.next_in = (Bytef *)data;
+    stream.avail_in = size;
+    stream.next_out = out;
+    stream.avail_out = capacity;
+    deflate(&stream, Z_FINISH);
+    *out_size = capacity - stream.avail_out;
+    deflateEnd(&stream);
+    return out;
+}
+
+// Collected is what a sink has been given.
+struct Collected
+{
+    char *data;
+    size_t size;
+    size_t calls;
+    // the sink stops once this many bytes have been collected (0 = never)
+    size_t stop_after;
+};
+
+static bool collect(void *ctx, const char *data, size_t size)
+{
+    struct Collected *collected = ctx;
+    collected->data = realloc(collected->data, collected->size + size);
+    memcpy(collected->data + collected->size, data, size);
+    collected->size += size;
+    collected->calls++;
+    return collected->stop_after == 0 || collected->size < collected->stop_after;
+}
+
+// make_text returns size bytes of list-like text.
+static char *make_text(size_t size)
+{
+    char *text = malloc(size);
+    for (size_t i = 0; i < size; i++)
+        text[i] = i % 17 == 16 ? '\n' : 'a' + (char)((i * 7) % 26);
+    return text;
+}
+
+static void test_detect(void)
+{
+    size_t size;
+    unsigned char *compressed = gzip("hello\n", 6, &size);
+    CHECK_EQ(ListGzip_Detect(compressed, size), true, "detect: gzip");
+    CHECK_EQ(ListGzip_Detect("{\"items\": []}", 13), false, "detect: json");
+    CHECK_EQ(ListGzip_Detect(compressed, 1), false, "detect: too short");
+    CHECK_EQ(ListGzip_SizeHint(compressed, size), 6, "hint: trailer size");
+    CHECK_EQ(ListGzip_SizeHint(compressed, 10), 0, "hint: too short");
+    free(compressed);
+}
+
+static void test_round_trip(void)
+{
+    size_t text_size = 1000 * 1000;
+    char *text = make_text(text_size);
+    size_t size;
+    unsigned char *compressed = gzip(text, text_size, &size);
+
+    // all at once: more than one block of output
+    struct ListGzip inflater;
+    struct Collected collected = {0};
+    CHECK_EQ(ListGzip_Init(&inflater), true, "round trip: init");
+    CHECK_EQ(ListGzip_Write(&inflater, compressed, size, collect, &collected), true, "round trip: inflated");
+    CHECK_EQ(ListGzip_Complete(&inflater), true, "round trip: complete");
+    CHECK_EQ(collected.size, text_size, "round trip: size");
+    CHECK_EQ(memcmp(collected.data, text, text_size), 0, "round trip: contents");
+    CHECK_EQ(collected.calls > 1, true, "round trip: handed over in blocks");
+    ListGzip_Free(&inflater);
+    free(collected.data);
+
+    // one byte at a time
+    collected = (struct Collected){0};
+    ListGzip_Init(&inflater);
+    bool ok = true;
+    for (size_t i = 0; i < size && ok; i++)
+    {
+        ok = ListGzip_Write(&inflater, compressed + i, 1, collect, &collected);
+        if (i + 1 < size && ListGzip_Complete(&inflater))
+            ok = false;
+    }
+    CHECK_EQ(ok, true, "byte at a time: inflated");
+    CHECK_EQ(ListGzip_Complete(&inflater), true, "byte at a time: complete");
+    CHECK_EQ(collected.size == text_size && memcmp(collected.data, text, text_size) == 0, true, "byte at a time: contents");
+    ListGzip_Free(&inflater);
+    ListGzip_Free(&inflater);
+    free(collected.data);
+
+    free(compressed);
+    free(text);
+}
+
+static void test_members(void)
+{
+    size_t first_size, second_size;
+    unsigned char *first = gzip("one\n", 4, &first_size);
+    unsigned char *second = gzip("two\n", 4, &second_size);
+    unsigned char *both = malloc(first_size + second_size);
+    memcpy(both, first, first_size);
+    memcpy(both + first_size, second, second_size);
+
+    struct ListGzip inflater;
+    struct Collected collected = {0};
+    ListGzip_Init(&inflater);
+    CHECK_EQ(ListGzip_Write(&inflater, both, first_size + second_size, collect, &collected), true, "members: inflated");
+    CHECK_EQ(ListGzip_Complete(&inflater), true, "members: complete");
+    CHECK_EQ(collected.size == 8 && memcmp(collected.data, "one\ntwo\n", 8) == 0, true, "members: joined");
+    ListGzip_Free(&inflater);
+    free(collected.data);
+    free(both);
+    free(second);
+    free(first);
+}
+
+static void test_bad_input(void)
+{
+    size_t size;
+    char *text = make_text(200 * 1000);
+    unsigned char *compressed = gzip(text, 200 * 1000, &size);
+
+    // cut short
+    struct ListGzip inflater;
+    struct Collected collected = {0};
+    ListGzip_Init(&inflater);
+    CHECK_EQ(ListGzip_Write(&inflater, compressed, size - 10, collect, &collected), true, "truncated: no error yet");
+    CHECK_EQ(ListGzip_Complete(&inflater), false, "truncated: incomplete");
+    ListGzip_Free(&inflater);
+    free(collected.data);
+
+    // corrupted after the header
+    collected = (struct Collected){0};
+    compressed[12] ^= 0xff;
+    compressed[13] ^= 0xff;
+    ListGzip_Init(&inflater);
+    CHECK_EQ(ListGzip_Write(&inflater, compressed, size, collect, &collected), false, "corrupt: rejected");
+    ListGzip_Free(&inflater);
+    free(collected.data);
+    compressed[12] ^= 0xff;
+    compressed[13] ^= 0xff;
+
+    // the sink stops it
+    collected = (struct Collected){.stop_after = 1};
+    ListGzip_Init(&inflater);
+    CHECK_EQ(ListGzip_Write(&inflater, compressed, size, collect, &collected), false, "sink: stopped");
+    CHECK_EQ(collected.calls, 1, "sink: not called again");
+    ListGzip_Free(&inflater);
+    free(collected.data);
+
+    struct ListGzip zeroed = {0};
+    ListGzip_Free(&zeroed);
+    free(compressed);
+    free(text);
+}
+
+int main(void)
+{
+    test_detect();
+    test_round_trip();
+    test_members();
+    test_bad_input();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
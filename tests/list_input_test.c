@@ -0,0 +1,264 @@
+// Unit tests for the mmap-backed input layer. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+// Fixture files are written under tmp/, which `make test` creates.
+
+#include "list_input.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// write_fixture writes size bytes of data to path, replacing any old file.
+static void write_fixture(const char *path, const char *data, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+    fwrite(data, 1, size, file);
+    fclose(file);
+}
+
+static void test_file_mapped(void)
+{
+    const char *path = "tmp/list_input_small.txt";
+    write_fixture(path, "one\ntwo\n", 8);
+
+    struct ListInput input;
+    CHECK_EQ(ListInput_OpenFile(&input, path), true, "file: opened");
+    CHECK_EQ(input.size, 8, "file: size");
+    CHECK_EQ(input.mapped > 0, true, "file: regular file is mapped");
+    CHECK_EQ(strcmp(input.data, "one\ntwo\n"), 0, "file: contents");
+    CHECK_EQ(input.data[input.size], '\0', "file: terminated");
+
+    // the buffer is writable, but writes stay private to the process
+    input.data[0] = 'X';
+    ListInput_Close(&input);
+    CHECK_EQ(input.data == NULL, true, "file: close resets data");
+
+    CHECK_EQ(ListInput_OpenFile(&input, path), true, "file: reopened");
+    CHECK_EQ(input.data[0], 'o', "file: private writes not written back");
+    ListInput_Close(&input);
+    ListInput_Close(&input);
+}
+
+static void test_file_page_sized(void)
+{
+    // a file that ends exactly on a page boundary still gets its terminator
+    size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    char *data = malloc(size);
+    memset(data, 'a', size);
+    const char *path = "tmp/list_input_page.txt";
+    write_fixture(path, data, size);
+    free(data);
+
+    struct ListInput input;
+    CHECK_EQ(ListInput_OpenFile(&input, path), true, "page: opened");
+    CHECK_EQ(input.size, size, "page: size");
+    CHECK_EQ(input.data[size - 1], 'a', "page: last byte");
+    CHECK_EQ(input.data[size], '\0', "page: terminated past the boundary");
+    CHECK_EQ(strlen(input.data), size, "page: strlen stops at terminator");
+    ListInput_Close(&input);
+}
+
+static void test_file_empty_and_missing(void)
+{
+    const char *path = "tmp/list_input_empty.txt";
+    write_fixture(path, "", 0);
+
+    struct ListInput input;
+    CHECK_EQ(ListInput_OpenFile(&input, path), true, "empty: opened");
+    CHECK_EQ(input.size, 0, "empty: size");
+    CHECK_EQ(input.data != NULL && input.data[0] == '\0', true, "empty: empty string");
+    ListInput_Close(&input);
+
+    CHECK_EQ(ListInput_OpenFile(&input, "tmp/list_input_missing.txt"), false, "missing: not opened");
+    CHECK_EQ(input.data == NULL, true, "missing: no buffer");
+}
+
+static void test_fd_pipe(void)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        perror("pipe");
+        exit(1);
+    }
+    write(fds[1], "a\nb", 3);
+    close(fds[1]);
+
+    struct ListInput input;
+    CHECK_EQ(ListInput_OpenFd(&input, fds[0], false), true, "pipe: opened");
+    CHECK_EQ(input.mapped, 0, "pipe: read into heap");
+    CHECK_EQ(input.size, 3, "pipe: size");
+    CHECK_EQ(strcmp(input.data, "a\nb"), 0, "pipe: contents");
+    ListInput_Close(&input);
+    close(fds[0]);
+
+    if (pipe(fds) != 0)
+    {
+        perror("pipe");
+        exit(1);
+    }
+    close(fds[1]);
+    CHECK_EQ(ListInput_OpenFd(&input, fds[0], false), false, "pipe: empty rejected");
+    CHECK_EQ(input.data == NULL, true, "pipe: empty leaves no buffer");
+    close(fds[0]);
+}
+
+// gzip compresses size bytes of data into a new buffer, setting *out_size.
+static unsigned char *gzip(const char *data, size_t size, size_t *out_size)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    size_t capacity = deflateBound(&stream, size);
+    unsigned char *out = malloc(capacity);
+    stream.next_in = (Bytef *)data;
+    stream.avail_in = size;
+    stream.next_out = out;
+    stream.avail_out = capacity;
+    deflate(&stream, Z_FINISH);
+    *out_size = capacity - stream.avail_out;
+    deflateEnd(&stream);
+    return out;
+}
+
+static void test_gzip(void)
+{
+    size_t text_size = 300 * 1000;
+    char *text = malloc(text_size);
+    for (size_t i = 0; i < text_size; i++)
+        text[i] = i % 10 == 9 ? '\n' : 'a' + (char)(i % 7);
+    size_t size;
+    unsigned char *compressed = gzip(text, text_size, &size);
+
+    // a compressed file is inflated out of its mapping
+    const char *path = "tmp/list_input_list.txt.gz";
+    write_fixture(path, (const char *)compressed, size);
+    struct ListInput input;
+    CHECK_EQ(ListInput_OpenFile(&input, path), true, "gzip: file opened");
+    CHECK_EQ(input.mapped, 0, "gzip: inflated into the heap");
+    CHECK_EQ(input.size, text_size, "gzip: inflated size");
+    CHECK_EQ(memcmp(input.data, text, text_size), 0, "gzip: inflated contents");
+    CHECK_EQ(input.data[input.size], '\0', "gzip: terminated");
+    ListInput_Close(&input);
+
+    // and inflated as it is read from a pipe
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        perror("pipe");
+        exit(1);
+    }
+    size_t small_size;
+    unsigned char *small = gzip("one\ntwo\n", 8, &small_size);
+    write(fds[1], small, 1);
+    write(fds[1], small + 1, small_size - 1);
+    close(fds[1]);
+    CHECK_EQ(ListInput_OpenFd(&input, fds[0], false), true, "gzip: pipe opened");
+    CHECK_EQ(strcmp(input.data, "one\ntwo\n"), 0, "gzip: pipe contents");
+    ListInput_Close(&input);
+    close(fds[0]);
+
+    // a truncated file fails rather than loading part of the list
+    write_fixture(path, (const char *)compressed, size / 2);
+    CHECK_EQ(ListInput_OpenFile(&input, path), false, "gzip: truncated rejected");
+    CHECK_EQ(input.data == NULL, true, "gzip: truncated leaves no buffer");
+
+    free(small);
+    free(compressed);
+    free(text);
+}
+
+static void test_fd_offset(void)
+{
+    // a redirected file that was already partly consumed is read from where
+    // it stands rather than mapped from the start
+    const char *path = "tmp/list_input_offset.txt";
+    write_fixture(path, "skip\nkeep\n", 10);
+
+    int fd = open(path, O_RDONLY);
+    char skipped[5];
+    read(fd, skipped, sizeof(skipped));
+
+    struct ListInput input;
+    CHECK_EQ(ListInput_OpenFd(&input, fd, false), true, "offset: opened");
+    CHECK_EQ(input.mapped, 0, "offset: not mapped");
+    CHECK_EQ(strcmp(input.data, "keep\n"), 0, "offset: remaining contents");
+    ListInput_Close(&input);
+    close(fd);
+
+    fd = open(path, O_RDONLY);
+    CHECK_EQ(ListInput_OpenFd(&input, fd, false), true, "offset: fresh fd opened");
+    CHECK_EQ(input.mapped > 0, true, "offset: fresh fd mapped");
+    ListInput_Close(&input);
+    close(fd);
+}
+
+static void test_next_line(void)
+{
+    char text[] = "first\n\nthird\r\nlast";
+    char *cursor = text;
+    char *end = text + strlen(text);
+
+    char *line = ListInput_NextLine(&cursor, end);
+    CHECK_EQ(line == text, true, "lines: first points into the buffer");
+    CHECK_EQ(strcmp(line, "first"), 0, "lines: first terminated in place");
+    CHECK_EQ(strcmp(ListInput_NextLine(&cursor, end), ""), 0, "lines: blank line kept");
+    CHECK_EQ(strcmp(ListInput_NextLine(&cursor, end), "third\r"), 0, "lines: carriage return kept");
+    CHECK_EQ(strcmp(ListInput_NextLine(&cursor, end), "last"), 0, "lines: unterminated final line");
+    CHECK_EQ(ListInput_NextLine(&cursor, end) == NULL, true, "lines: exhausted");
+    CHECK_EQ(ListInput_NextLine(&cursor, end) == NULL, true, "lines: stays exhausted");
+
+    char trailing[] = "only\n";
+    cursor = trailing;
+    end = trailing + strlen(trailing);
+    CHECK_EQ(strcmp(ListInput_NextLine(&cursor, end), "only"), 0, "lines: trailing newline");
+    CHECK_EQ(ListInput_NextLine(&cursor, end) == NULL, true, "lines: no empty line after trailing newline");
+
+    char empty[] = "";
+    cursor = empty;
+    CHECK_EQ(ListInput_NextLine(&cursor, empty) == NULL, true, "lines: empty input");
+}
+
+int main(void)
+{
+    test_file_mapped();
+    test_file_page_sized();
+    test_file_empty_and_missing();
+    test_fd_pipe();
+    test_gzip();
+    test_fd_offset();
+    test_next_line();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
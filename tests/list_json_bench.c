@@ -0,0 +1,199 @@
+// Host benchmark for the structural JSON scanner. It generates item catalogs
+// shaped like real minui-list input and times three ways of getting at their
+// items: parsing the whole document with parson, walking the items array with
+// the scanner alone, and the loader's path of scanning each item and parsing
+// only its span with parson. Run it with `make bench`, which builds it twice:
+// once with the vectorized scans and once with -DLIST_JSON_NO_SIMD.
+
+#include "list_json.h"
+
+#include <parson/parson.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// the catalog size each corpus is grown to, matching a large ROM library
+#define BENCH_CORPUS_BYTES (5 * 1024 * 1024)
+// how many times each pass runs; the fastest run is reported
+#define BENCH_RUNS 5
+
+struct Corpus
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+    size_t items;
+};
+
+static void corpus_append(struct Corpus *corpus, const char *text, size_t length)
+{
+    if (corpus->size + length + 1 > corpus->capacity)
+    {
+        size_t capacity = corpus->capacity > 0 ? corpus->capacity * 2 : 1024 * 1024;
+        while (capacity < corpus->size + length + 1)
+            capacity *= 2;
+        corpus->data = realloc(corpus->data, capacity);
+        if (corpus->data == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+        corpus->capacity = capacity;
+    }
+    memcpy(corpus->data + corpus->size, text, length);
+    corpus->size += length;
+    corpus->data[corpus->size] = '\0';
+}
+
+// corpus_generate builds {"items": [...]} with items until the document
+// reaches BENCH_CORPUS_BYTES. A rich corpus gives every item options, a
+// selection and features; a plain one only names them.
+static void corpus_generate(struct Corpus *corpus, bool rich)
+{
+    const char *regions[] = {"USA", "Europe", "Japan", "World"};
+    char item[1024];
+
+    memset(corpus, 0, sizeof(*corpus));
+    corpus_append(corpus, "{\"items\": [\n", 12);
+    while (corpus->size < BENCH_CORPUS_BYTES)
+    {
+        size_t i = corpus->items;
+        int length;
+        if (rich)
+        {
+            length = snprintf(item, sizeof(item),
+                              "%s  {\"name\": \"Adventure Title %zu - Part %zu (%s) [Rev %zu]\", "
+                              "\"options\": [\"Off\", \"On\", \"Auto\", \"Fast \\\"x2\\\"\"], \"selected\": %zu, "
+                              "\"features\": {\"is_header\": false, \"disabled\": %s, \"draw_arrows\": true, "
+                              "\"hint\": \"Press A to launch, X for options\", "
+                              "\"image\": \"/mnt/SDCARD/Roms/.media/Adventure Title %zu.png\"}}",
+                              i > 0 ? ",\n" : "", i, i % 7, regions[i % 4], i % 3, i % 4, i % 11 == 0 ? "true" : "false", i);
+        }
+        else
+        {
+            length = snprintf(item, sizeof(item), "%s  {\"name\": \"Adventure Title %zu (%s)\"}",
+                              i > 0 ? ",\n" : "", i, regions[i % 4]);
+        }
+        corpus_append(corpus, item, length);
+        corpus->items++;
+    }
+    corpus_append(corpus, "\n]}\n", 4);
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// find_items enters the root object and returns a cursor over its items array.
+static bool find_items(struct Corpus *corpus, struct ListJSONCursor *items)
+{
+    char *end = corpus->data + corpus->size;
+    struct ListJSONCursor root;
+    if (!ListJSON_Enter(&root, ListJSON_SkipSpace(corpus->data, end), end))
+        return false;
+
+    struct ListJSONSpan key;
+    struct ListJSONSpan value;
+    while (ListJSON_NextMember(&root, &key, &value) == LIST_JSON_VALUE)
+    {
+        if (key.length == 7 && memcmp(key.start, "\"items\"", 7) == 0)
+            return ListJSON_Enter(items, value.start, value.start + value.length);
+    }
+    return false;
+}
+
+// pass_parson parses the whole document into a parson tree.
+static size_t pass_parson(struct Corpus *corpus)
+{
+    JSON_Value *root = json_parse_string_with_comments(corpus->data);
+    JSON_Array *items = json_object_get_array(json_value_get_object(root), "items");
+    size_t count = json_array_get_count(items);
+    json_value_free(root);
+    return count;
+}
+
+// pass_scan only walks the item skeleton.
+static size_t pass_scan(struct Corpus *corpus)
+{
+    struct ListJSONCursor items;
+    if (!find_items(corpus, &items))
+        return 0;
+
+    size_t count = 0;
+    struct ListJSONSpan span;
+    while (ListJSON_NextElement(&items, &span) == LIST_JSON_VALUE)
+        count++;
+    return count;
+}
+
+// pass_scan_parse scans each item and parses just its span, as the loader
+// does before building the item.
+static size_t pass_scan_parse(struct Corpus *corpus)
+{
+    struct ListJSONCursor items;
+    if (!find_items(corpus, &items))
+        return 0;
+
+    size_t count = 0;
+    struct ListJSONSpan span;
+    while (ListJSON_NextElement(&items, &span) == LIST_JSON_VALUE)
+    {
+        char *after = span.start + span.length;
+        char saved = *after;
+        *after = '\0';
+        JSON_Value *value = json_parse_string_with_comments(span.start);
+        *after = saved;
+        if (value != NULL && json_object_get_string(json_value_get_object(value), "name") != NULL)
+            count++;
+        json_value_free(value);
+    }
+    return count;
+}
+
+static void run(const char *name, struct Corpus *corpus, size_t (*pass)(struct Corpus *))
+{
+    double best = 0;
+    size_t count = 0;
+    for (int i = 0; i < BENCH_RUNS; i++)
+    {
+        double start = now_seconds();
+        count = pass(corpus);
+        double elapsed = now_seconds() - start;
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    printf("  %-18s %8.2f ms %9.1f MB/s  (%zu items)\n", name, best * 1000,
+           corpus->size / best / (1024 * 1024), count);
+    if (count != corpus->items)
+    {
+        fprintf(stderr, "%s found %zu of %zu items\n", name, count, corpus->items);
+        exit(1);
+    }
+}
+
+int main(void)
+{
+#if defined(LIST_JSON_NO_SIMD)
+    const char *scanner = "scalar";
+#else
+    const char *scanner = "vectorized where supported";
+#endif
+    printf("list_json benchmark (%s scanner)\n", scanner);
+
+    for (int rich = 0; rich <= 1; rich++)
+    {
+        struct Corpus corpus;
+        corpus_generate(&corpus, rich);
+        printf("%s corpus: %.1f MB, %zu items\n", rich ? "rich" : "plain", corpus.size / (1024.0 * 1024.0), corpus.items);
+        run("parson", &corpus, pass_parson);
+        run("scan", &corpus, pass_scan);
+        run("scan + item parse", &corpus, pass_scan_parse);
+        free(corpus.data);
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+// Unit tests for the structural JSON scanner behind the streaming item loader.
+// These have no SDL/display or parson dependencies, so they run headless with
+// the host compiler via `make test`.
+
+#include "list_json.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// CHECK_SPAN asserts that a span holds exactly the expected bytes.
+#define CHECK_SPAN(span, expected, msg)                                                        \
+    do                                                                                         \
+    {                                                                                          \
+        checks++;                                                                              \
+        if ((span).length != strlen(expected) || memcmp((span).start, (expected), (span).length) != 0) \
+        {                                                                                      \
+            failures++;                                                                        \
+            fprintf(stderr, "FAIL: %s (expected '%s', got '%.*s')\n", (msg), (expected),       \
+                    (int)(span).length, (span).start);                                         \
+        }                                                                                      \
+    } while (0)
+
+// count_elements walks an array held in text and returns how many elements it
+// has, or -1 when the scanner reports an error.
+static int count_elements(const char *text)
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    char *end = buffer + strlen(buffer);
+
+    struct ListJSONCursor cursor;
+    if (!ListJSON_Enter(&cursor, ListJSON_SkipSpace(buffer, end), end))
+        return -1;
+
+    int count = 0;
+    struct ListJSONSpan span;
+    enum ListJSONStatus status;
+    while ((status = ListJSON_NextElement(&cursor, &span)) == LIST_JSON_VALUE)
+        count++;
+    return status == LIST_JSON_END ? count : -1;
+}
+
+static void test_skip_space(void)
+{
+    char text[] = "  \n\t/* block */ // line\n  x";
+    char *end = text + strlen(text);
+    CHECK_EQ(*ListJSON_SkipSpace(text, end), 'x', "space: whitespace and comments skipped");
+
+    char unterminated[] = "  /* never closed";
+    char *u_end = unterminated + strlen(unterminated);
+    CHECK_EQ(ListJSON_SkipSpace(unterminated, u_end) == u_end, 1, "space: unterminated block runs to end");
+
+    char slash[] = "/x";
+    CHECK_EQ(ListJSON_SkipSpace(slash, slash + 2) == slash, 1, "space: lone slash is not a comment");
+}
+
+static void test_skip_value(void)
+{
+    char text[] = "\"a\\\"]b\" [1, [2], {\"k\": \"]\"}] {\"a\": /* } */ 1} true -1.5e3, nul tru 12abc";
+    char *end = text + strlen(text);
+
+    char *p = text;
+    char *q = ListJSON_SkipValue(p, end);
+    CHECK_EQ(q - p, 7, "value: string with escaped quote");
+
+    p = ListJSON_SkipSpace(q, end);
+    q = ListJSON_SkipValue(p, end);
+    CHECK_EQ(q - p, 20, "value: nested array with bracket in string");
+
+    p = ListJSON_SkipSpace(q, end);
+    q = ListJSON_SkipValue(p, end);
+    CHECK_EQ(q - p, 16, "value: object with bracket in comment");
+
+    p = ListJSON_SkipSpace(q, end);
+    q = ListJSON_SkipValue(p, end);
+    CHECK_EQ(q - p, 4, "value: literal");
+
+    p = ListJSON_SkipSpace(q, end);
+    q = ListJSON_SkipValue(p, end);
+    CHECK_EQ(q - p, 6, "value: number stops at comma");
+
+    p = ListJSON_SkipSpace(q + 1, end);
+    CHECK_EQ(ListJSON_SkipValue(p, end) == NULL, 1, "value: misspelled literal");
+
+    char truncated[] = "[1, [2]";
+    CHECK_EQ(ListJSON_SkipValue(truncated, truncated + strlen(truncated)) == NULL, 1, "value: unbalanced array");
+
+    char open_string[] = "\"abc";
+    CHECK_EQ(ListJSON_SkipValue(open_string, open_string + strlen(open_string)) == NULL, 1, "value: unterminated string");
+
+    char junk[] = "12abc";
+    CHECK_EQ(ListJSON_SkipValue(junk, junk + strlen(junk)) == NULL, 1, "value: number with trailing junk");
+
+    char empty[] = ",";
+    CHECK_EQ(ListJSON_SkipValue(empty, empty + 1) == NULL, 1, "value: no value before separator");
+}
+
+// test_wide_values moves the interesting byte across every position of the
+// 16-byte blocks the vectorized scans read, so a bad mask or tail shows up as a
+// wrong span length.
+static void test_wide_values(void)
+{
+    char buffer[128];
+    int wrong_escape = 0;
+    int wrong_bracket = 0;
+    int wrong_truncated = 0;
+    for (int offset = 0; offset < 48; offset++)
+    {
+        // "xxx\"yyy" followed by junk that must not be reached
+        int n = snprintf(buffer, sizeof(buffer), "\"%.*s\\\"%s\" \"", offset, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx", "yyyyyyyyyyyyyyyyyyyy");
+        char *q = ListJSON_SkipValue(buffer, buffer + n);
+        if (q == NULL || q - buffer != n - 2)
+            wrong_escape++;
+
+        // {"k": "xxx]}"} with the brackets inside the string at offset
+        n = snprintf(buffer, sizeof(buffer), "{\"k\": \"%.*s]}\", \"n\": [%.*s1]} ]", offset, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx", offset % 17, "                 ");
+        q = ListJSON_SkipValue(buffer, buffer + n);
+        if (q == NULL || q - buffer != n - 2)
+            wrong_bracket++;
+
+        // the closing quote sits one past the end of the scanned range
+        n = snprintf(buffer, sizeof(buffer), "\"%.*s\"", offset, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+        if (ListJSON_SkipValue(buffer, buffer + n - 1) != NULL)
+            wrong_truncated++;
+    }
+    CHECK_EQ(wrong_escape, 0, "wide: escaped quote at every offset");
+    CHECK_EQ(wrong_bracket, 0, "wide: brackets in strings at every offset");
+    CHECK_EQ(wrong_truncated, 0, "wide: unterminated string at every length");
+
+    // a trailing backslash escapes past the end rather than reading beyond it
+    char dangling[] = "\"0123456789abcdef\\";
+    CHECK_EQ(ListJSON_SkipValue(dangling, dangling + strlen(dangling)) == NULL, 1, "wide: dangling escape");
+
+    // high bytes must not fold onto brackets
+    char high[] = "[\"\xDB\xDD\xFB\xFD\", \xDB\xFB 1, 2, 3, 4, 5, 6, 7, 8, 9]";
+    char *high_end = high + strlen(high);
+    CHECK_EQ(ListJSON_SkipValue(high, high_end) == high_end, 1, "wide: high bytes are not brackets");
+}
+
+static void test_elements(void)
+{
+    CHECK_EQ(count_elements("[]"), 0, "elements: empty array");
+    CHECK_EQ(count_elements("[ /* nothing */ ]"), 0, "elements: commented empty array");
+    CHECK_EQ(count_elements("[\"a\", {\"b\": [1, 2]}, 3, null]"), 4, "elements: mixed values");
+    CHECK_EQ(count_elements("[\"a\", // one\n \"b\"]"), 2, "elements: line comment between values");
+    CHECK_EQ(count_elements("[\"a\",]"), -1, "elements: trailing comma");
+    CHECK_EQ(count_elements("[,\"a\"]"), -1, "elements: leading comma");
+    CHECK_EQ(count_elements("[\"a\" \"b\"]"), -1, "elements: missing comma");
+    CHECK_EQ(count_elements("[\"a\", \"b\""), -1, "elements: missing closing bracket");
+    CHECK_EQ(count_elements("\"a\""), -1, "elements: not a container");
+
+    char text[] = "[ \"first\" , {\"name\": \"second\"} ]";
+    char *end = text + strlen(text);
+    struct ListJSONCursor cursor;
+    struct ListJSONSpan span;
+    ListJSON_Enter(&cursor, text, end);
+    CHECK_EQ(ListJSON_NextElement(&cursor, &span), LIST_JSON_VALUE, "elements: first read");
+    CHECK_SPAN(span, "\"first\"", "elements: first span");
+    CHECK_EQ(ListJSON_NextElement(&cursor, &span), LIST_JSON_VALUE, "elements: second read");
+    CHECK_SPAN(span, "{\"name\": \"second\"}", "elements: second span");
+    CHECK_EQ(ListJSON_NextElement(&cursor, &span), LIST_JSON_END, "elements: end");
+}
+
+static void test_members(void)
+{
+    char text[] = "{\"items\": [\"a\", \"b\"], \"sel\\\"ected\" : 2 /* c */, \"x\":{}}";
+    char *end = text + strlen(text);
+    struct ListJSONCursor cursor;
+    struct ListJSONSpan key, value;
+
+    CHECK_EQ(ListJSON_Enter(&cursor, text, end), true, "members: enter object");
+    CHECK_EQ(ListJSON_NextMember(&cursor, &key, &value), LIST_JSON_VALUE, "members: first read");
+    CHECK_SPAN(key, "\"items\"", "members: first key");
+    CHECK_SPAN(value, "[\"a\", \"b\"]", "members: first value");
+    CHECK_EQ(ListJSON_NextMember(&cursor, &key, &value), LIST_JSON_VALUE, "members: second read");
+    CHECK_SPAN(key, "\"sel\\\"ected\"", "members: escaped key kept raw");
+    CHECK_SPAN(value, "2", "members: number value");
+    CHECK_EQ(ListJSON_NextMember(&cursor, &key, &value), LIST_JSON_VALUE, "members: third read");
+    CHECK_SPAN(value, "{}", "members: empty object value");
+    CHECK_EQ(ListJSON_NextMember(&cursor, &key, &value), LIST_JSON_END, "members: end");
+
+    char no_colon[] = "{\"a\" 1}";
+    ListJSON_Enter(&cursor, no_colon, no_colon + strlen(no_colon));
+    CHECK_EQ(ListJSON_NextMember(&cursor, &key, &value), LIST_JSON_ERROR, "members: missing colon");
+
+    char bare_key[] = "{a: 1}";
+    ListJSON_Enter(&cursor, bare_key, bare_key + strlen(bare_key));
+    CHECK_EQ(ListJSON_NextMember(&cursor, &key, &value), LIST_JSON_ERROR, "members: unquoted key");
+
+    char no_value[] = "{\"a\": }";
+    ListJSON_Enter(&cursor, no_value, no_value + strlen(no_value));
+    CHECK_EQ(ListJSON_NextMember(&cursor, &key, &value), LIST_JSON_ERROR, "members: missing value");
+}
+
+static void test_bom(void)
+{
+    char text[] = "\xEF\xBB\xBF[]";
+    char *end = text + strlen(text);
+    CHECK_EQ(ListJSON_SkipBOM(text, end) - text, 3, "bom: skipped");
+    CHECK_EQ(ListJSON_SkipBOM(text + 3, end) - text, 3, "bom: absent");
+}
+
+int main(void)
+{
+    test_skip_space();
+    test_skip_value();
+    test_wide_values();
+    test_elements();
+    test_members();
+    test_bom();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
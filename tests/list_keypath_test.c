@@ -0,0 +1,97 @@
+// Unit tests for --item-key path parsing. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_keypath.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// key_is reports whether segment i of path is the key expected.
+static bool key_is(const struct ListKeyPath *path, int i, const char *expected)
+{
+    return path->segments[i].key != NULL && strcmp(path->segments[i].key, expected) == 0;
+}
+
+static void test_plain(void)
+{
+    struct ListKeyPath path;
+    CHECK_EQ(ListKeyPath_Parse(&path, "items"), true, "plain: parsed");
+    CHECK_EQ(path.count, 1, "plain: one segment");
+    CHECK_EQ(key_is(&path, 0, "items"), true, "plain: key");
+
+    CHECK_EQ(ListKeyPath_Parse(&path, "my items"), true, "plain: spaces allowed");
+    CHECK_EQ(key_is(&path, 0, "my items"), true, "plain: key with spaces");
+}
+
+static void test_nested(void)
+{
+    struct ListKeyPath path;
+    CHECK_EQ(ListKeyPath_Parse(&path, "data.menus[2].items"), true, "nested: parsed");
+    CHECK_EQ(path.count, 4, "nested: segments");
+    CHECK_EQ(key_is(&path, 0, "data"), true, "nested: first key");
+    CHECK_EQ(key_is(&path, 1, "menus"), true, "nested: second key");
+    CHECK_EQ(path.segments[2].key == NULL, true, "nested: index segment");
+    CHECK_EQ(path.segments[2].index, 2, "nested: index");
+    CHECK_EQ(key_is(&path, 3, "items"), true, "nested: last key");
+
+    CHECK_EQ(ListKeyPath_Parse(&path, "pages[0][12]"), true, "nested: consecutive indexes");
+    CHECK_EQ(path.count, 3, "nested: consecutive index segments");
+    CHECK_EQ(path.segments[2].index, 12, "nested: multi-digit index");
+}
+
+static void test_invalid(void)
+{
+    struct ListKeyPath path;
+    CHECK_EQ(ListKeyPath_Parse(&path, ""), false, "invalid: empty");
+    CHECK_EQ(ListKeyPath_Parse(&path, "[0]"), false, "invalid: leading index");
+    CHECK_EQ(ListKeyPath_Parse(&path, ".items"), false, "invalid: leading dot");
+    CHECK_EQ(ListKeyPath_Parse(&path, "data."), false, "invalid: trailing dot");
+    CHECK_EQ(ListKeyPath_Parse(&path, "data..items"), false, "invalid: empty key");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus[]"), false, "invalid: empty index");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus[x]"), false, "invalid: non-numeric index");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus[-1]"), false, "invalid: negative index");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus[1"), false, "invalid: unclosed index");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus[1]items"), false, "invalid: key without a dot");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus]"), false, "invalid: stray bracket");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus[65536]"), false, "invalid: index too large");
+    CHECK_EQ(ListKeyPath_Parse(&path, "menus[65535]"), true, "invalid: largest index allowed");
+    CHECK_EQ(ListKeyPath_Parse(&path, "a.b.c.d.e.f.g.h.i.j.k.l.m.n.o.p.q"), false, "invalid: too many segments");
+
+    char long_path[LIST_KEYPATH_MAX_LENGTH + 1];
+    memset(long_path, 'k', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+    CHECK_EQ(ListKeyPath_Parse(&path, long_path), false, "invalid: too long");
+}
+
+int main(void)
+{
+    test_plain();
+    test_nested();
+    test_invalid();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
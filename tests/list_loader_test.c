@@ -0,0 +1,309 @@
+// Unit tests for the background list loader. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+// Input is fed through pipes so the tests control when each line arrives.
+
+#include "list_loader.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+static void open_pipe(int fds[2])
+{
+    if (pipe(fds) != 0)
+    {
+        perror("pipe");
+        exit(1);
+    }
+}
+
+static void feed(int fd, const char *text)
+{
+    if (write(fd, text, strlen(text)) != (ssize_t)strlen(text))
+    {
+        perror("write");
+        exit(1);
+    }
+}
+
+static void test_incremental(void)
+{
+    int fds[2];
+    open_pipe(fds);
+
+    struct ListLoader loader;
+    CHECK_EQ(ListLoader_Start(&loader, fds[0], true, false), true, "incremental: started");
+
+    const char **names;
+    bool done;
+    CHECK_EQ(ListLoader_Wait(&loader, 1, 20), false, "incremental: nothing yet times out");
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 0, "incremental: nothing yet");
+    CHECK_EQ(done, false, "incremental: not done");
+
+    // the first lines show up while the producer is still writing
+    feed(fds[1], "Mario\nZelda\nMetr");
+    CHECK_EQ(ListLoader_Wait(&loader, 2, 5000), true, "incremental: first lines published");
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 2, "incremental: two complete lines");
+    CHECK_EQ(strcmp(names[0], "Mario"), 0, "incremental: first name");
+    CHECK_EQ(strcmp(names[1], "Zelda"), 0, "incremental: second name");
+    CHECK_EQ(done, false, "incremental: still loading");
+    const char *first = names[0];
+
+    // a line split across writes is joined, and a final line without a
+    // newline still counts
+    feed(fds[1], "oid\n  \n\nKirby");
+    close(fds[1]);
+    CHECK_EQ(ListLoader_Wait(&loader, 4, 5000), true, "incremental: rest published");
+    CHECK_EQ(ListLoader_Wait(&loader, 100, 5000), true, "incremental: finished");
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 2, "incremental: blank lines skipped");
+    CHECK_EQ(strcmp(names[0], "Metroid"), 0, "incremental: joined line");
+    CHECK_EQ(strcmp(names[1], "Kirby"), 0, "incremental: unterminated last line");
+    CHECK_EQ(done, true, "incremental: done");
+    CHECK_EQ(strcmp(first, "Mario"), 0, "incremental: earlier names stay valid");
+
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 0, "incremental: nothing left");
+    CHECK_EQ(done, true, "incremental: stays done");
+    CHECK_EQ(loader.failed, false, "incremental: no failure");
+    ListLoader_Free(&loader);
+}
+
+static void test_keep_blank_lines(void)
+{
+    int fds[2];
+    open_pipe(fds);
+
+    struct ListLoader loader;
+    ListLoader_Start(&loader, fds[0], true, true);
+    feed(fds[1], "{\"name\": \"a\"}\n\n  \n{\"name\": \"b\"}");
+    close(fds[1]);
+
+    const char **names;
+    bool done;
+    ListLoader_Wait(&loader, 100, 5000);
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 4, "keep blank: every line published");
+    CHECK_EQ(strcmp(names[1], ""), 0, "keep blank: empty line");
+    CHECK_EQ(strcmp(names[2], ""), 0, "keep blank: whitespace line published empty");
+    CHECK_EQ(strcmp(names[3], "{\"name\": \"b\"}"), 0, "keep blank: later line keeps its number");
+    CHECK_EQ(done, true, "keep blank: done");
+    ListLoader_Free(&loader);
+}
+
+// deflate_feed compresses text into the pipe, flushing so everything written
+// so far can be inflated on the other end.
+static void deflate_feed(z_stream *stream, int fd, const char *text, int flush)
+{
+    unsigned char out[4096];
+    stream->next_in = (Bytef *)text;
+    stream->avail_in = strlen(text);
+    do
+    {
+        stream->next_out = out;
+        stream->avail_out = sizeof(out);
+        deflate(stream, flush);
+        size_t produced = sizeof(out) - stream->avail_out;
+        if (write(fd, out, produced) != (ssize_t)produced)
+        {
+            perror("write");
+            exit(1);
+        }
+    } while (stream->avail_out == 0);
+}
+
+static void test_gzip(void)
+{
+    int fds[2];
+    open_pipe(fds);
+
+    struct ListLoader loader;
+    ListLoader_Start(&loader, fds[0], true, false);
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+    // lines show up as soon as the compressed bytes for them arrive
+    const char **names;
+    bool done;
+    deflate_feed(&stream, fds[1], "Mario\nZel", Z_SYNC_FLUSH);
+    CHECK_EQ(ListLoader_Wait(&loader, 1, 5000), true, "gzip: first line published");
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 1, "gzip: one complete line");
+    CHECK_EQ(strcmp(names[0], "Mario"), 0, "gzip: first name inflated");
+    CHECK_EQ(done, false, "gzip: still loading");
+
+    deflate_feed(&stream, fds[1], "da\n\nKirby", Z_FINISH);
+    deflateEnd(&stream);
+    close(fds[1]);
+    ListLoader_Wait(&loader, 100, 5000);
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 2, "gzip: rest published");
+    CHECK_EQ(strcmp(names[0], "Zelda"), 0, "gzip: line split across chunks");
+    CHECK_EQ(strcmp(names[1], "Kirby"), 0, "gzip: unterminated last line");
+    CHECK_EQ(done, true, "gzip: done");
+    CHECK_EQ(loader.failed, false, "gzip: no failure");
+    ListLoader_Free(&loader);
+
+    // compressed input that is cut short fails the load
+    open_pipe(fds);
+    ListLoader_Start(&loader, fds[0], true, false);
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    deflate_feed(&stream, fds[1], "Mario\n", Z_SYNC_FLUSH);
+    deflateEnd(&stream);
+    close(fds[1]);
+    ListLoader_Wait(&loader, 100, 5000);
+    ListLoader_Poll(&loader, &names, &done);
+    CHECK_EQ(done && loader.failed, true, "gzip: truncated input fails");
+    ListLoader_Free(&loader);
+}
+
+static void test_long_lines(void)
+{
+    int fds[2];
+    open_pipe(fds);
+
+    struct ListLoader loader;
+    ListLoader_Start(&loader, fds[0], true, false);
+
+    // a line longer than a read chunk, written in pieces
+    size_t length = 200 * 1024;
+    char *line = malloc(length + 1);
+    memset(line, 'x', length);
+    line[length] = '\0';
+    for (size_t k = 0; k < length; k += 4096)
+    {
+        if (write(fds[1], line + k, 4096) != 4096)
+        {
+            perror("write");
+            exit(1);
+        }
+    }
+    feed(fds[1], "\r\nwith carriage return\r\n");
+    close(fds[1]);
+
+    const char **names;
+    bool done;
+    ListLoader_Wait(&loader, 100, 5000);
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 2, "long: both lines");
+    CHECK_EQ(strlen(names[0]), length + 1, "long: full length with carriage return");
+    CHECK_EQ(names[0][length], '\r', "long: carriage return kept");
+    CHECK_EQ(strcmp(names[1], "with carriage return\r"), 0, "long: carriage return kept as in text format");
+    CHECK_EQ(done, true, "long: done");
+    free(line);
+    ListLoader_Free(&loader);
+}
+
+static void test_many_lines(void)
+{
+    int fds[2];
+    open_pipe(fds);
+
+    struct ListLoader loader;
+    ListLoader_Start(&loader, fds[0], true, false);
+
+    // more lines than the pipe holds, so polls interleave with publishing
+    int total = 20000;
+    int seen = 0;
+    int in_order = 0;
+    bool done = false;
+    char expected[32];
+    for (int i = 0; i < total || !done; i++)
+    {
+        if (i < total)
+        {
+            char line[32];
+            snprintf(line, sizeof(line), "item %d\n", i);
+            feed(fds[1], line);
+            if (i == total - 1)
+                close(fds[1]);
+        }
+
+        const char **names;
+        size_t count = ListLoader_Poll(&loader, &names, &done);
+        for (size_t k = 0; k < count; k++)
+        {
+            snprintf(expected, sizeof(expected), "item %d", seen);
+            if (strcmp(names[k], expected) == 0)
+                in_order++;
+            seen++;
+        }
+        if (i >= total && !done)
+            ListLoader_Wait(&loader, (size_t)total, 100);
+    }
+    CHECK_EQ(seen, total, "many: every line seen");
+    CHECK_EQ(in_order, total, "many: in order");
+    ListLoader_Free(&loader);
+}
+
+static void test_stop_while_reading(void)
+{
+    int fds[2];
+    open_pipe(fds);
+
+    struct ListLoader loader;
+    ListLoader_Start(&loader, fds[0], false, false);
+    feed(fds[1], "one\n");
+    ListLoader_Wait(&loader, 1, 5000);
+
+    // the producer never finishes; freeing the loader must not hang
+    ListLoader_Free(&loader);
+    CHECK_EQ(loader.running, false, "stop: thread joined");
+
+    // the loader was told not to close the descriptor
+    CHECK_EQ(write(fds[1], "x", 1), 1, "stop: descriptor left open");
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void test_empty(void)
+{
+    int fds[2];
+    open_pipe(fds);
+    close(fds[1]);
+
+    struct ListLoader loader;
+    ListLoader_Start(&loader, fds[0], true, false);
+    CHECK_EQ(ListLoader_Wait(&loader, 1, 5000), true, "empty: wait ends at end of input");
+
+    const char **names;
+    bool done;
+    CHECK_EQ(ListLoader_Poll(&loader, &names, &done), 0, "empty: no lines");
+    CHECK_EQ(done, true, "empty: done");
+    ListLoader_Free(&loader);
+}
+
+int main(void)
+{
+    test_incremental();
+    test_keep_blank_lines();
+    test_gzip();
+    test_long_lines();
+    test_many_lines();
+    test_stop_while_reading();
+    test_empty();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
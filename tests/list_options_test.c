@@ -0,0 +1,124 @@
+// Unit tests for option array interning. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_options.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// get_string reads options from a plain array of strings.
+static const char *get_string(const void *source, size_t index)
+{
+    return ((const char *const *)source)[index];
+}
+
+static void test_intern(void)
+{
+    struct ListArena arena;
+    ListArena_Init(&arena);
+    struct ListOptionTables tables;
+    ListOptionTables_Init(&tables, &arena);
+
+    char on[] = "on";
+    const char *first[] = {on, "off"};
+    const char *second[] = {"on", "off"};
+    const char **a = ListOptionTables_Intern(&tables, first, 2, get_string);
+    const char **b = ListOptionTables_Intern(&tables, second, 2, get_string);
+    CHECK_EQ(a != NULL, true, "intern: interned");
+    CHECK_EQ(a == b, true, "intern: equal arrays shared");
+    CHECK_EQ(tables.count, 1, "intern: one distinct array");
+    CHECK_EQ(strcmp(a[0], "on") == 0 && strcmp(a[1], "off") == 0, true, "intern: contents kept");
+
+    // the interned copy does not depend on the caller's strings
+    on[0] = 'O';
+    CHECK_EQ(strcmp(a[0], "on"), 0, "intern: strings copied");
+
+    const char *reversed[] = {"off", "on"};
+    const char *shorter[] = {"on"};
+    const char *split[] = {"o", "noff"};
+    CHECK_EQ(ListOptionTables_Intern(&tables, reversed, 2, get_string) != a, true, "intern: order matters");
+    CHECK_EQ(ListOptionTables_Intern(&tables, shorter, 1, get_string) != a, true, "intern: length matters");
+    CHECK_EQ(ListOptionTables_Intern(&tables, split, 2, get_string) != a, true, "intern: boundaries matter");
+    CHECK_EQ(tables.count, 4, "intern: distinct arrays counted");
+
+    CHECK_EQ(ListOptionTables_Intern(&tables, first, 0, get_string) == NULL, true, "intern: empty array");
+
+    // non-string options read as empty strings
+    const char *with_null[] = {"a", NULL};
+    const char *with_empty[] = {"a", ""};
+    const char **n = ListOptionTables_Intern(&tables, with_null, 2, get_string);
+    CHECK_EQ(strcmp(n[1], ""), 0, "intern: NULL stored as empty");
+    CHECK_EQ(ListOptionTables_Intern(&tables, with_empty, 2, get_string) == n, true, "intern: NULL matches empty");
+
+    ListOptionTables_Free(&tables);
+    CHECK_EQ(tables.buckets == NULL, true, "free: index released");
+    CHECK_EQ(strcmp(a[1], "off"), 0, "free: arrays outlive the index");
+    ListArena_Free(&arena);
+}
+
+static void test_many(void)
+{
+    struct ListArena arena;
+    ListArena_Init(&arena);
+    struct ListOptionTables tables;
+    ListOptionTables_Init(&tables, &arena);
+
+    // enough distinct arrays to grow the index several times, each interned
+    // twice
+    const char **first_seen[3000];
+    int shared = 0;
+    for (int round = 0; round < 2; round++)
+    {
+        for (int i = 0; i < 3000; i++)
+        {
+            char low[16];
+            char high[16];
+            snprintf(low, sizeof(low), "%d", i);
+            snprintf(high, sizeof(high), "%d", i + 100);
+            const char *options[] = {low, high};
+            const char **interned = ListOptionTables_Intern(&tables, options, 2, get_string);
+            if (round == 0)
+                first_seen[i] = interned;
+            else if (interned == first_seen[i] && strcmp(interned[0], low) == 0)
+                shared++;
+        }
+    }
+    CHECK_EQ(tables.count, 3000, "many: distinct arrays");
+    CHECK_EQ(shared, 3000, "many: found again after growing");
+    CHECK_EQ(tables.bucket_count >= tables.count, true, "many: index grew");
+
+    ListOptionTables_Free(&tables);
+    ListArena_Free(&arena);
+}
+
+int main(void)
+{
+    test_intern();
+    test_many();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
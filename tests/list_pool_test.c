@@ -0,0 +1,138 @@
+// Unit tests for the list worker pool. These have no SDL/display dependencies,
+// so they run headless with the host compiler via `make test`.
+
+#include "list_pool.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// Squares records, per task, which worker handled it and its result.
+struct Squares
+{
+    int *worker;
+    long *result;
+    // each worker's slice, as seen by the slice function
+    size_t begin[LIST_POOL_MAX_WORKERS];
+    size_t end[LIST_POOL_MAX_WORKERS];
+};
+
+static void square_slice(void *context, size_t worker, size_t begin, size_t end)
+{
+    struct Squares *squares = context;
+    squares->begin[worker] = begin;
+    squares->end[worker] = end;
+    for (size_t i = begin; i < end; i++)
+    {
+        squares->worker[i] = (int)worker;
+        squares->result[i] = (long)i * (long)i;
+    }
+}
+
+static void test_worker_count(void)
+{
+    CHECK_EQ(ListPool_WorkerCount(0, 100), 1, "count: empty range gets one worker");
+    CHECK_EQ(ListPool_WorkerCount(99, 100), 1, "count: below the minimum gets one worker");
+    CHECK_EQ(ListPool_WorkerCount(250, 100) <= 2, true, "count: every worker gets the minimum");
+    CHECK_EQ(ListPool_WorkerCount(1000000, 100) <= LIST_POOL_MAX_WORKERS, true, "count: capped");
+    CHECK_EQ(ListPool_WorkerCount(1000000, 100) >= 1, true, "count: at least one worker");
+}
+
+static void test_slices(void)
+{
+    // slices are contiguous, in order, cover the range and differ in size by
+    // at most one
+    bool contiguous = true;
+    bool balanced = true;
+    for (size_t count = 0; count < 40; count++)
+    {
+        for (size_t workers = 1; workers <= LIST_POOL_MAX_WORKERS; workers++)
+        {
+            contiguous = contiguous && ListPool_SliceBegin(count, workers, 0) == 0;
+            contiguous = contiguous && ListPool_SliceBegin(count, workers, workers) == count;
+            for (size_t w = 0; w < workers; w++)
+            {
+                size_t size = ListPool_SliceBegin(count, workers, w + 1) - ListPool_SliceBegin(count, workers, w);
+                balanced = balanced && (size == count / workers || size == count / workers + 1);
+            }
+        }
+    }
+    CHECK_EQ(contiguous, true, "slices: cover the range");
+    CHECK_EQ(balanced, true, "slices: balanced");
+
+    size_t huge = (size_t)-1 - 3;
+    CHECK_EQ(ListPool_SliceBegin(huge, 4, 2) == huge / 2, true, "slices: no overflow on large counts");
+}
+
+static void test_run(void)
+{
+    size_t count = 100003;
+    struct Squares squares;
+    memset(&squares, 0, sizeof(squares));
+    squares.worker = calloc(count, sizeof(int));
+    squares.result = calloc(count, sizeof(long));
+
+    ListPool_Run(count, 4, square_slice, &squares);
+
+    int correct = 0;
+    int in_slice = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (squares.result[i] == (long)i * (long)i)
+            correct++;
+        int w = squares.worker[i];
+        if (i >= squares.begin[w] && i < squares.end[w])
+            in_slice++;
+    }
+    CHECK_EQ(correct, count, "run: every task handled");
+    CHECK_EQ(in_slice, count, "run: tasks handled by their slice's worker");
+    CHECK_EQ(squares.begin[0], 0, "run: first slice starts the range");
+    CHECK_EQ(squares.end[3], count, "run: last slice ends the range");
+    CHECK_EQ(squares.worker[count - 1], 3, "run: last task on the last worker");
+
+    // a single worker runs everything on the calling thread
+    memset(squares.worker, 0xff, count * sizeof(int));
+    ListPool_Run(count, 1, square_slice, &squares);
+    CHECK_EQ(squares.worker[0] == 0 && squares.worker[count - 1] == 0, true, "run: single worker");
+
+    // an empty range still calls each slice with nothing to do
+    memset(&squares.begin, 0xff, sizeof(squares.begin));
+    ListPool_Run(0, 2, square_slice, &squares);
+    CHECK_EQ(squares.begin[0] == 0 && squares.begin[1] == 0, true, "run: empty range");
+
+    free(squares.worker);
+    free(squares.result);
+}
+
+int main(void)
+{
+    test_worker_count();
+    test_slices();
+    test_run();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
@@ -0,0 +1,122 @@
+// Unit tests for numeric range options. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_range.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+static void test_format_valid(void)
+{
+    CHECK_EQ(ListRange_FormatValid("%d"), true, "format: plain");
+    CHECK_EQ(ListRange_FormatValid("%d%%"), true, "format: percent sign");
+    CHECK_EQ(ListRange_FormatValid("Volume %3i dB"), true, "format: width and text");
+    CHECK_EQ(ListRange_FormatValid("%+05.2d"), true, "format: flags and precision");
+    CHECK_EQ(ListRange_FormatValid("none"), false, "format: no conversion");
+    CHECK_EQ(ListRange_FormatValid("%d/%d"), false, "format: two conversions");
+    CHECK_EQ(ListRange_FormatValid("%s"), false, "format: string conversion");
+    CHECK_EQ(ListRange_FormatValid("%n%d"), false, "format: write conversion");
+    CHECK_EQ(ListRange_FormatValid("%ld"), false, "format: length modifier");
+    CHECK_EQ(ListRange_FormatValid("%d%"), false, "format: trailing percent");
+    CHECK_EQ(ListRange_FormatValid("%*d"), false, "format: width argument");
+}
+
+static void test_init(void)
+{
+    struct ListRange range;
+    char err[128];
+    CHECK_EQ(ListRange_Init(&range, 0, 1000, 5, "%d%%", err, sizeof(err)), true, "init: valid");
+    CHECK_EQ(range.count, 201, "init: count");
+    CHECK_EQ(ListRange_Value(&range, 0), 0, "init: first value");
+    CHECK_EQ(ListRange_Value(&range, 200), 1000, "init: last value");
+
+    CHECK_EQ(ListRange_Init(&range, -10, 10, 3, NULL, err, sizeof(err)), true, "init: uneven step");
+    CHECK_EQ(range.count, 7, "init: last value stays below max");
+    CHECK_EQ(ListRange_Value(&range, 6), 8, "init: uneven last value");
+
+    CHECK_EQ(ListRange_Init(&range, 5, 5, 1, NULL, err, sizeof(err)), true, "init: single value");
+    CHECK_EQ(range.count, 1, "init: single value count");
+
+    CHECK_EQ(ListRange_Init(&range, 0, 10, 0, NULL, err, sizeof(err)), false, "init: zero step");
+    CHECK_EQ(strstr(err, "step") != NULL, true, "init: zero step explained");
+    CHECK_EQ(ListRange_Init(&range, 0, 10, -1, NULL, err, sizeof(err)), false, "init: negative step");
+    CHECK_EQ(ListRange_Init(&range, 10, 0, 1, NULL, err, sizeof(err)), false, "init: max below min");
+    CHECK_EQ(ListRange_Init(&range, 0, 1.5, 1, NULL, err, sizeof(err)), false, "init: fractional");
+    CHECK_EQ(ListRange_Init(&range, 0, 10, 1, "%s", err, sizeof(err)), false, "init: unsafe format");
+    CHECK_EQ(ListRange_Init(&range, -2147483648.0, 2147483647.0, 1, NULL, err, sizeof(err)), false, "init: too many values");
+    CHECK_EQ(ListRange_Init(&range, 0, 1e12, 1, NULL, err, sizeof(err)), false, "init: out of int range");
+}
+
+static void test_format(void)
+{
+    struct ListRange range;
+    char err[128];
+    char buf[32];
+    ListRange_Init(&range, 0, 1000, 5, "%d%%", err, sizeof(err));
+    CHECK_EQ(strcmp(ListRange_Format(&range, 3, buf, sizeof(buf)), "15%"), 0, "format: formatted value");
+
+    ListRange_Init(&range, -10, 10, 1, NULL, err, sizeof(err));
+    CHECK_EQ(strcmp(ListRange_Format(&range, 0, buf, sizeof(buf)), "-10"), 0, "format: plain number");
+
+    ListRange_Init(&range, 0, 10, 1, "a long label for the value %d", err, sizeof(err));
+    ListRange_Format(&range, 7, buf, 8);
+    CHECK_EQ(strcmp(buf, "a long "), 0, "format: truncated to the buffer");
+}
+
+static void test_stride(void)
+{
+    CHECK_EQ(ListRange_Stride(0, 1000), 1, "stride: first press");
+    CHECK_EQ(ListRange_Stride(LIST_RANGE_ACCEL_REPEATS - 1, 1000), 1, "stride: slow at first");
+    CHECK_EQ(ListRange_Stride(LIST_RANGE_ACCEL_REPEATS, 1000), 2, "stride: speeds up");
+    CHECK_EQ(ListRange_Stride(LIST_RANGE_ACCEL_REPEATS * 2, 1000), 4, "stride: doubles");
+    CHECK_EQ(ListRange_Stride(LIST_RANGE_ACCEL_REPEATS * 100, 1000), 62, "stride: capped at a sixteenth");
+    CHECK_EQ(ListRange_Stride(LIST_RANGE_ACCEL_REPEATS * 100, 10), 1, "stride: small ranges stay single");
+    CHECK_EQ(ListRange_Stride(1000000, 2000000000) > 0, true, "stride: no overflow");
+}
+
+static void test_step(void)
+{
+    CHECK_EQ(ListRange_Step(3, 10, 1), 4, "step: forward");
+    CHECK_EQ(ListRange_Step(3, 10, -1), 2, "step: back");
+    CHECK_EQ(ListRange_Step(7, 10, 5), 9, "step: stops at the last value");
+    CHECK_EQ(ListRange_Step(9, 10, 5), 0, "step: wraps from the last value");
+    CHECK_EQ(ListRange_Step(2, 10, -5), 0, "step: stops at the first value");
+    CHECK_EQ(ListRange_Step(0, 10, -1), 9, "step: wraps from the first value");
+    CHECK_EQ(ListRange_Step(0, 1, 1), 0, "step: single value");
+    CHECK_EQ(ListRange_Step(0, 0, 1), 0, "step: empty range");
+}
+
+int main(void)
+{
+    test_format_valid();
+    test_init();
+    test_format();
+    test_stride();
+    test_step();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
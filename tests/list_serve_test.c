@@ -0,0 +1,169 @@
+// Unit tests for the --serve request protocol. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_serve.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+static void test_round_trip(void)
+{
+    int pair[2];
+    int pipe_fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    if (pipe(pipe_fds) != 0)
+        return;
+
+    char *argv[] = {"--file", "-", "--title", "", "--format", "text"};
+    int fds[3] = {pipe_fds[0], pipe_fds[1], STDERR_FILENO};
+    CHECK_EQ(ListServe_SendRequest(pair[0], 6, argv, "/tmp/lists", fds), true, "round trip: sent");
+
+    struct ListServeRequest request;
+    CHECK_EQ(ListServe_ReceiveRequest(pair[1], &request), true, "round trip: received");
+    CHECK_EQ(request.argc, 7, "round trip: argc counts the program name");
+    CHECK_EQ(strcmp(request.argv[0], "minui-list"), 0, "round trip: program name");
+    CHECK_EQ(strcmp(request.argv[1], "--file"), 0, "round trip: first argument");
+    CHECK_EQ(strcmp(request.argv[4], ""), 0, "round trip: empty argument");
+    CHECK_EQ(strcmp(request.argv[6], "text"), 0, "round trip: last argument");
+    CHECK_EQ(request.argv[7] == NULL, true, "round trip: argv is NULL-terminated");
+    CHECK_EQ(strcmp(request.cwd, "/tmp/lists"), 0, "round trip: working directory");
+
+    // the received descriptors are the client's: writing to the received
+    // stdout comes out of the client's pipe
+    CHECK_EQ(request.fds[0] >= 0 && request.fds[0] != pipe_fds[0], true, "round trip: descriptors are duplicated");
+    CHECK_EQ(write(request.fds[1], "hi", 2), 2, "round trip: write to received stdout");
+    char buffer[4] = {0};
+    CHECK_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), 2, "round trip: read from client pipe");
+    CHECK_EQ(strcmp(buffer, "hi"), 0, "round trip: bytes arrive");
+    ListServe_FreeRequest(&request);
+    CHECK_EQ(request.argv == NULL && request.fds[0] == -1, true, "round trip: freed");
+
+    int code = -1;
+    CHECK_EQ(ListServe_SendExitCode(pair[1], 143), true, "exit code: sent");
+    CHECK_EQ(ListServe_ReceiveExitCode(pair[0], &code), true, "exit code: received");
+    CHECK_EQ(code, 143, "exit code: value");
+
+    close(pair[1]);
+    CHECK_EQ(ListServe_ReceiveExitCode(pair[0], &code), false, "exit code: closed connection");
+    close(pair[0]);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+static void test_malformed(void)
+{
+    int pair[2];
+    struct ListServeRequest request;
+
+    // a request without descriptors is refused
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    uint32_t header[3] = {0x4d4c5331u, 0, 2};
+    CHECK_EQ(write(pair[0], header, sizeof(header)), (long)sizeof(header), "malformed: header written");
+    CHECK_EQ(write(pair[0], "/", 2), 2, "malformed: body written");
+    CHECK_EQ(ListServe_ReceiveRequest(pair[1], &request), false, "malformed: no descriptors");
+    close(pair[0]);
+    close(pair[1]);
+
+    // a closed connection is not a request
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    close(pair[0]);
+    CHECK_EQ(ListServe_ReceiveRequest(pair[1], &request), false, "malformed: closed connection");
+    close(pair[1]);
+
+    // a request that is cut short is refused
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    char *argv[] = {"--file", "list.json"};
+    int fds[3] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    ListServe_SendRequest(pair[0], 2, argv, "/", fds);
+    shutdown(pair[0], SHUT_WR);
+    struct ListServeRequest first;
+    CHECK_EQ(ListServe_ReceiveRequest(pair[1], &first), true, "malformed: whole request first");
+    ListServe_FreeRequest(&first);
+    CHECK_EQ(ListServe_ReceiveRequest(pair[1], &request), false, "malformed: nothing after it");
+    close(pair[0]);
+    close(pair[1]);
+}
+
+static void test_listen(void)
+{
+    char dir[] = "/tmp/list_serve_test.XXXXXX";
+    if (mkdtemp(dir) == NULL)
+        return;
+    char path[128];
+    snprintf(path, sizeof(path), "%s/sock", dir);
+
+    CHECK_EQ(ListServe_Connect(path), -1, "listen: nothing to connect to");
+
+    int server = ListServe_Listen(path);
+    CHECK_EQ(server >= 0, true, "listen: listening");
+    struct stat info;
+    stat(path, &info);
+    CHECK_EQ(info.st_mode & 0077, 0, "listen: only the owner can connect");
+    CHECK_EQ(ListServe_Listen(path), -1, "listen: a running server is not replaced");
+
+    int client = ListServe_Connect(path);
+    CHECK_EQ(client >= 0, true, "listen: connected");
+    int accepted = accept(server, NULL, NULL);
+    CHECK_EQ(accepted >= 0, true, "listen: accepted");
+    close(accepted);
+    close(client);
+
+    // a stale socket from a server that is gone is replaced
+    close(server);
+    server = ListServe_Listen(path);
+    CHECK_EQ(server >= 0, true, "listen: stale socket replaced");
+    close(server);
+    unlink(path);
+
+    // anything else at the path is left alone
+    FILE *file = fopen(path, "w");
+    if (file != NULL)
+        fclose(file);
+    CHECK_EQ(ListServe_Listen(path), -1, "listen: regular file refused");
+    CHECK_EQ(access(path, F_OK), 0, "listen: regular file kept");
+    unlink(path);
+
+    char long_path[256];
+    memset(long_path, 'x', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+    CHECK_EQ(ListServe_Listen(long_path), -1, "listen: path too long");
+    rmdir(dir);
+}
+
+int main(void)
+{
+    test_round_trip();
+    test_malformed();
+    test_listen();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
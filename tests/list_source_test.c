@@ -0,0 +1,162 @@
+// Unit tests for reading a list from a directory. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_source.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+static void test_extension_matches(void)
+{
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.gb", "gb"), true, "extension: single");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.GB", "gb"), true, "extension: case-insensitive");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.zip", "gb,zip"), true, "extension: later in the list");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.zip", ".7z,.zip"), true, "extension: leading dot");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.gbc", "gb"), false, "extension: longer extension");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetrisgb", "gb"), false, "extension: no dot");
+    CHECK_EQ(ListSource_ExtensionMatches(".gb", "gb"), false, "extension: nothing before the dot");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.gb", "zip,,"), false, "extension: empty entries");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.gb", ""), true, "extension: empty list matches");
+    CHECK_EQ(ListSource_ExtensionMatches("Tetris.gb", NULL), true, "extension: no list matches");
+}
+
+static void test_stem(void)
+{
+    CHECK_EQ(ListSource_StemLength("Tetris.gb"), 6, "stem: extension dropped");
+    CHECK_EQ(ListSource_StemLength("Super Mario (v1.1).zip"), 18, "stem: last dot only");
+    CHECK_EQ(ListSource_StemLength("README"), 6, "stem: no extension");
+    CHECK_EQ(ListSource_StemLength(".hidden"), 7, "stem: leading dot kept");
+}
+
+static void test_is_resolution(void)
+{
+    CHECK_EQ(ListSource_IsResolution("1280x720"), true, "resolution: valid");
+    CHECK_EQ(ListSource_IsResolution("640x480"), true, "resolution: short");
+    CHECK_EQ(ListSource_IsResolution("default"), false, "resolution: word");
+    CHECK_EQ(ListSource_IsResolution("1280x"), false, "resolution: no height");
+    CHECK_EQ(ListSource_IsResolution("x720"), false, "resolution: no width");
+    CHECK_EQ(ListSource_IsResolution("1280x720.png"), false, "resolution: file name");
+}
+
+static void touch(const char *dir, const char *name)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+    fclose(f);
+}
+
+// contains reports whether name is one of the names read.
+static bool contains(const struct ListSource *source, const char *name)
+{
+    for (size_t i = 0; i < source->count; i++)
+    {
+        if (strcmp(source->names[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static void test_read(void)
+{
+    char dir[] = "/tmp/list_source_test.XXXXXX";
+    if (mkdtemp(dir) == NULL)
+    {
+        perror("mkdtemp");
+        exit(1);
+    }
+    touch(dir, "Tetris.gb");
+    touch(dir, "Zelda.ZIP");
+    touch(dir, "notes.txt");
+    touch(dir, ".hidden.gb");
+    char subdir[512];
+    snprintf(subdir, sizeof(subdir), "%s/640x480", dir);
+    mkdir(subdir, 0755);
+
+    struct ListArena arena;
+    ListArena_Init(&arena);
+
+    struct ListSource source;
+    CHECK_EQ(ListSource_Read(&source, &arena, dir, NULL, false), true, "read: all entries");
+    CHECK_EQ(source.count, 4, "read: hidden entries skipped");
+    CHECK_EQ(contains(&source, "notes.txt") && contains(&source, "640x480"), true, "read: files and directories");
+    ListSource_Free(&source);
+
+    CHECK_EQ(ListSource_Read(&source, &arena, dir, "gb,zip", false), true, "read: filtered");
+    CHECK_EQ(source.count, 2, "read: filtered count");
+    CHECK_EQ(contains(&source, "Tetris.gb") && contains(&source, "Zelda.ZIP"), true, "read: filtered names");
+    ListSource_Free(&source);
+
+    CHECK_EQ(ListSource_Read(&source, &arena, dir, NULL, true), true, "read: directories");
+    CHECK_EQ(source.count, 1, "read: directories only");
+    CHECK_EQ(contains(&source, "640x480"), true, "read: directory name");
+    ListSource_Free(&source);
+
+    // enough entries to take several getdents64 batches
+    char many[] = "/tmp/list_source_many.XXXXXX";
+    if (mkdtemp(many) == NULL)
+    {
+        perror("mkdtemp");
+        exit(1);
+    }
+    for (int i = 0; i < 3000; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "Game with a fairly long file name %04d.gb", i);
+        touch(many, name);
+    }
+    CHECK_EQ(ListSource_Read(&source, &arena, many, "gb", false), true, "read: many entries");
+    CHECK_EQ(source.count, 3000, "read: every batch read");
+    ListSource_Free(&source);
+
+    CHECK_EQ(ListSource_Read(&source, &arena, "/nonexistent/list_source", NULL, false), false, "read: missing directory");
+    ListSource_Free(&source);
+    ListArena_Free(&arena);
+
+    char command[1100];
+    snprintf(command, sizeof(command), "rm -rf '%s' '%s'", dir, many);
+    if (system(command) != 0)
+        fprintf(stderr, "warning: could not remove %s\n", dir);
+}
+
+int main(void)
+{
+    test_extension_matches();
+    test_stem();
+    test_is_resolution();
+    test_read();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
@@ -0,0 +1,120 @@
+// Unit tests for the --timings startup report. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_timing.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+static void test_phases(void)
+{
+    struct ListTiming timing;
+    ListTiming_Init(&timing);
+    CHECK_EQ(timing.recorded[LIST_TIMING_LOAD], false, "phases: nothing recorded at first");
+    CHECK_EQ(timing.first_paint < 0, true, "phases: not painted at first");
+
+    ListTiming_Begin(&timing, LIST_TIMING_LOAD);
+    usleep(2000);
+    ListTiming_End(&timing, LIST_TIMING_LOAD);
+    CHECK_EQ(timing.recorded[LIST_TIMING_LOAD], true, "phases: recorded");
+    CHECK_EQ(timing.durations[LIST_TIMING_LOAD] >= 1.0, true, "phases: duration in milliseconds");
+
+    double first = timing.durations[LIST_TIMING_LOAD];
+    ListTiming_Begin(&timing, LIST_TIMING_LOAD);
+    usleep(2000);
+    ListTiming_End(&timing, LIST_TIMING_LOAD);
+    CHECK_EQ(timing.durations[LIST_TIMING_LOAD] > first, true, "phases: repeated phase adds up");
+
+    ListTiming_Paint(&timing);
+    double paint = timing.first_paint;
+    CHECK_EQ(paint >= timing.durations[LIST_TIMING_LOAD], true, "phases: paint measured from the start");
+    usleep(1000);
+    ListTiming_Paint(&timing);
+    CHECK_EQ(timing.first_paint == paint, true, "phases: only the first paint counts");
+}
+
+static void test_format(void)
+{
+    struct ListTiming timing;
+    ListTiming_Init(&timing);
+    timing.durations[LIST_TIMING_ARGUMENTS] = 0.0421;
+    timing.recorded[LIST_TIMING_ARGUMENTS] = true;
+    timing.durations[LIST_TIMING_INIT] = 120.5;
+    timing.recorded[LIST_TIMING_INIT] = true;
+    timing.first_paint = 131.87;
+
+    char buf[512];
+    CHECK_EQ(ListTiming_Format(&timing, buf, sizeof(buf)), true, "format: fits");
+    CHECK_EQ(strcmp(buf, "{\"arguments_ms\":0.042,\"load_ms\":null,\"sort_ms\":null,\"init_ms\":120.500,"
+                         "\"images_ms\":null,\"fonts_ms\":null,\"first_frame_ms\":null,\"first_paint_ms\":131.870}"),
+             0, "format: report");
+
+    size_t length = strlen(buf);
+    CHECK_EQ(ListTiming_Format(&timing, buf, length + 1), true, "format: exact fit");
+    CHECK_EQ(ListTiming_Format(&timing, buf, length), false, "format: one byte short");
+    CHECK_EQ(ListTiming_Format(&timing, buf, 1), false, "format: no room");
+}
+
+static void test_write(void)
+{
+    char path[] = "/tmp/list_timing_test.XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return;
+    close(fd);
+
+    struct ListTiming timing;
+    ListTiming_Init(&timing);
+    CHECK_EQ(ListTiming_Write(&timing, path), true, "write: first launch");
+    CHECK_EQ(ListTiming_Write(&timing, path), true, "write: second launch");
+    CHECK_EQ(ListTiming_WriteLine("{\"filter_index_ms\":1.000}", path), true, "write: extra line");
+
+    char contents[2048] = {0};
+    FILE *file = fopen(path, "r");
+    size_t size = file != NULL ? fread(contents, 1, sizeof(contents) - 1, file) : 0;
+    if (file != NULL)
+        fclose(file);
+    int lines = 0;
+    for (size_t i = 0; i < size; i++)
+        lines += contents[i] == '\n';
+    CHECK_EQ(lines, 3, "write: one line per report");
+    CHECK_EQ(contents[0], '{', "write: json line");
+    unlink(path);
+
+    CHECK_EQ(ListTiming_Write(&timing, "/nonexistent-dir/timings"), false, "write: unwritable path");
+}
+
+int main(void)
+{
+    test_phases();
+    test_format();
+    test_write();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
@@ -0,0 +1,190 @@
+// Unit tests for the trigram filter index. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_trigram.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+struct Items
+{
+    const char **keys;
+    size_t count;
+    // the index of the item that is always a candidate, or -1
+    long always;
+};
+
+static const char *item_key(void *context, size_t i, size_t *length, bool *always)
+{
+    struct Items *items = context;
+    *length = items->keys[i] != NULL ? strlen(items->keys[i]) : 0;
+    *always = (long)i == items->always;
+    return items->keys[i];
+}
+
+// candidates runs a query and returns how many candidates it found.
+static size_t candidates(const struct ListTrigramIndex *index, const char *query, uint32_t *out)
+{
+    size_t estimate = ListTrigramIndex_Estimate(index, query, strlen(query));
+    if (estimate == SIZE_MAX)
+        return SIZE_MAX;
+    size_t count = ListTrigramIndex_Candidates(index, query, strlen(query), out);
+    return count <= estimate ? count : SIZE_MAX;
+}
+
+static void test_candidates(void)
+{
+    const char *keys[] = {"super mario", "mario kart", "zelda", NULL, "ma", "kart racer", "aaaaaa"};
+    struct Items items = {keys, sizeof(keys) / sizeof(keys[0]), -1};
+    struct ListTrigramIndex index;
+    CHECK_EQ(ListTrigramIndex_Build(&index, items.count, item_key, &items), true, "build: succeeds");
+    CHECK_EQ(index.item_count, items.count, "build: item count");
+
+    uint32_t out[8];
+    CHECK_EQ(candidates(&index, "mario", out), 2, "mario: two candidates");
+    CHECK_EQ(out[0], 0, "mario: first in order");
+    CHECK_EQ(out[1], 1, "mario: second in order");
+
+    CHECK_EQ(candidates(&index, "kart", out), 2, "kart: two candidates");
+    CHECK_EQ(out[0], 1, "kart: mario kart");
+    CHECK_EQ(out[1], 5, "kart: kart racer");
+
+    CHECK_EQ(candidates(&index, "zelda", out), 1, "zelda: one candidate");
+    CHECK_EQ(out[0], 2, "zelda: the item");
+
+    CHECK_EQ(candidates(&index, "aaa", out), 1, "repeated trigram: item listed once");
+    CHECK_EQ(out[0], 6, "repeated trigram: the item");
+    CHECK_EQ(candidates(&index, "aaaaa", out), 1, "repeated query trigram: item found");
+
+    CHECK_EQ(candidates(&index, "luigi", out), 0, "no match: no candidates");
+
+    CHECK_EQ(ListTrigramIndex_Estimate(&index, "ma", 2), SIZE_MAX, "short query: not narrowed");
+    CHECK_EQ(ListTrigramIndex_Estimate(&index, "", 0), SIZE_MAX, "empty query: not narrowed");
+    CHECK_EQ(ListTrigramIndex_Estimate(NULL, "mario", 5), SIZE_MAX, "no index: not narrowed");
+
+    CHECK_EQ(ListTrigramIndex_Bytes(&index) > sizeof(uint32_t) * LIST_TRIGRAM_BUCKETS, true, "bytes: counts the buckets");
+    ListTrigramIndex_Free(&index);
+    CHECK_EQ(index.offsets == NULL && index.postings == NULL, true, "free: cleared");
+}
+
+static void test_always(void)
+{
+    const char *keys[] = {"back", "alpha", "pinned", "alphabet", "omega"};
+    struct Items items = {keys, sizeof(keys) / sizeof(keys[0]), 2};
+    struct ListTrigramIndex index;
+    CHECK_EQ(ListTrigramIndex_Build(&index, items.count, item_key, &items), true, "always: build");
+    CHECK_EQ(index.always_count, 1, "always: one pinned item");
+
+    uint32_t out[8];
+    CHECK_EQ(candidates(&index, "alpha", out), 3, "always: merged with matches");
+    CHECK_EQ(out[0], 1, "always: alpha first");
+    CHECK_EQ(out[1], 2, "always: pinned in order");
+    CHECK_EQ(out[2], 3, "always: alphabet last");
+
+    CHECK_EQ(candidates(&index, "zzz", out), 1, "always: listed without matches");
+    CHECK_EQ(out[0], 2, "always: the pinned item");
+    CHECK_EQ(candidates(&index, "pinned", out), 1, "always: not also in postings");
+    ListTrigramIndex_Free(&index);
+}
+
+static void test_empty(void)
+{
+    struct Items items = {NULL, 0, -1};
+    struct ListTrigramIndex index;
+    CHECK_EQ(ListTrigramIndex_Build(&index, 0, item_key, &items), true, "empty: build");
+    uint32_t out[1];
+    CHECK_EQ(candidates(&index, "abc", out), 0, "empty: no candidates");
+    ListTrigramIndex_Free(&index);
+}
+
+// test_superset checks, over many generated keys, that every key containing
+// a query is a candidate and that candidates come in ascending order.
+static void test_superset(void)
+{
+    enum
+    {
+        COUNT = 5000
+    };
+    static char storage[COUNT][16];
+    static const char *keys[COUNT];
+    static uint32_t out[COUNT];
+    unsigned seed = 12345;
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        for (size_t j = 0; j < 15; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            storage[i][j] = "abcd"[(seed >> 16) % 4];
+        }
+        storage[i][15] = '\0';
+        keys[i] = storage[i];
+    }
+    struct Items items = {keys, COUNT, -1};
+    struct ListTrigramIndex index;
+    CHECK_EQ(ListTrigramIndex_Build(&index, COUNT, item_key, &items), true, "superset: build");
+
+    const char *queries[] = {"abc", "dcba", "aaaab", "abcdab", "ddddd"};
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++)
+    {
+        size_t count = candidates(&index, queries[q], out);
+        size_t expected = 0;
+        size_t found = 0;
+        bool ascending = true;
+        for (size_t c = 1; c < count && count != SIZE_MAX; c++)
+            ascending = ascending && out[c - 1] < out[c];
+        for (size_t i = 0; i < COUNT && count != SIZE_MAX; i++)
+        {
+            if (strstr(keys[i], queries[q]) == NULL)
+                continue;
+            expected++;
+            for (size_t c = 0; c < count; c++)
+            {
+                if (out[c] == i)
+                {
+                    found++;
+                    break;
+                }
+            }
+        }
+        CHECK_EQ(count != SIZE_MAX && expected > 0, true, "superset: query has matches");
+        CHECK_EQ(found, expected, "superset: every match is a candidate");
+        CHECK_EQ(ascending, true, "superset: candidates ascend");
+    }
+    ListTrigramIndex_Free(&index);
+}
+
+int main(void)
+{
+    test_candidates();
+    test_always();
+    test_empty();
+    test_superset();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
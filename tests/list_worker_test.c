@@ -0,0 +1,195 @@
+// Unit tests for the background job worker. These have no SDL/display
+// dependencies, so they run headless with the host compiler via `make test`.
+
+#include "list_worker.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected, msg)                                         \
+    do                                                                          \
+    {                                                                           \
+        checks++;                                                               \
+        long _a = (long)(actual);                                               \
+        long _e = (long)(expected);                                             \
+        if (_a != _e)                                                           \
+        {                                                                       \
+            failures++;                                                         \
+            fprintf(stderr, "FAIL: %s (expected %ld, got %ld)\n", (msg), _e, _a); \
+        }                                                                       \
+    } while (0)
+
+// Jobs record themselves here. A slow job runs until it is cancelled (or a
+// few seconds pass, so a broken worker fails instead of hanging).
+struct Jobs
+{
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    bool slow;
+    int started;
+    int completed;
+    int cancelled;
+};
+
+static bool run_job(void *context, struct ListWorker *worker, unsigned long job)
+{
+    struct Jobs *jobs = context;
+    pthread_mutex_lock(&jobs->lock);
+    bool slow = jobs->slow;
+    jobs->started++;
+    pthread_cond_broadcast(&jobs->changed);
+    pthread_mutex_unlock(&jobs->lock);
+
+    for (int i = 0; slow && i < 5000; i++)
+    {
+        if (ListWorker_Cancelled(worker, job))
+        {
+            pthread_mutex_lock(&jobs->lock);
+            jobs->cancelled++;
+            pthread_mutex_unlock(&jobs->lock);
+            return false;
+        }
+        nanosleep(&(struct timespec){0, 1000000}, NULL);
+    }
+
+    pthread_mutex_lock(&jobs->lock);
+    jobs->completed++;
+    pthread_mutex_unlock(&jobs->lock);
+    return true;
+}
+
+static void jobs_init(struct Jobs *jobs, bool slow)
+{
+    memset(jobs, 0, sizeof(*jobs));
+    pthread_mutex_init(&jobs->lock, NULL);
+    pthread_cond_init(&jobs->changed, NULL);
+    jobs->slow = slow;
+}
+
+static void jobs_set_slow(struct Jobs *jobs, bool slow)
+{
+    pthread_mutex_lock(&jobs->lock);
+    jobs->slow = slow;
+    pthread_mutex_unlock(&jobs->lock);
+}
+
+// jobs_wait_started blocks until count jobs have started.
+static void jobs_wait_started(struct Jobs *jobs, int count)
+{
+    pthread_mutex_lock(&jobs->lock);
+    while (jobs->started < count)
+        pthread_cond_wait(&jobs->changed, &jobs->lock);
+    pthread_mutex_unlock(&jobs->lock);
+}
+
+static void test_run(void)
+{
+    struct Jobs jobs;
+    jobs_init(&jobs, false);
+    struct ListWorker worker;
+    CHECK_EQ(ListWorker_Start(&worker, run_job, &jobs), true, "run: started");
+
+    unsigned long job = ListWorker_Submit(&worker);
+    ListWorker_Wait(&worker);
+    CHECK_EQ(ListWorker_Finished(&worker, job), true, "run: finished");
+    CHECK_EQ(jobs.completed, 1, "run: ran once");
+
+    unsigned long next = ListWorker_Submit(&worker);
+    CHECK_EQ(next > job, true, "run: job numbers increase");
+    ListWorker_Wait(&worker);
+    CHECK_EQ(ListWorker_Finished(&worker, next), true, "run: second finished");
+    CHECK_EQ(ListWorker_Finished(&worker, job), false, "run: only the last job counts");
+    CHECK_EQ(jobs.completed, 2, "run: ran twice");
+
+    ListWorker_Stop(&worker);
+}
+
+static void test_supersede(void)
+{
+    struct Jobs jobs;
+    jobs_init(&jobs, true);
+    struct ListWorker worker;
+    ListWorker_Start(&worker, run_job, &jobs);
+
+    unsigned long first = ListWorker_Submit(&worker);
+    jobs_wait_started(&jobs, 1);
+    CHECK_EQ(ListWorker_Cancelled(&worker, first), false, "supersede: running job not cancelled");
+
+    jobs_set_slow(&jobs, false);
+    unsigned long second = ListWorker_Submit(&worker);
+    CHECK_EQ(ListWorker_Cancelled(&worker, first), true, "supersede: earlier job cancelled");
+    ListWorker_Wait(&worker);
+    CHECK_EQ(jobs.cancelled, 1, "supersede: earlier job gave up");
+    CHECK_EQ(ListWorker_Finished(&worker, first), false, "supersede: earlier job not finished");
+    CHECK_EQ(ListWorker_Finished(&worker, second), true, "supersede: latest job finished");
+
+    ListWorker_Stop(&worker);
+}
+
+static void test_cancel(void)
+{
+    struct Jobs jobs;
+    jobs_init(&jobs, true);
+    struct ListWorker worker;
+    ListWorker_Start(&worker, run_job, &jobs);
+
+    unsigned long job = ListWorker_Submit(&worker);
+    jobs_wait_started(&jobs, 1);
+    ListWorker_Cancel(&worker);
+    ListWorker_Wait(&worker);
+    CHECK_EQ(jobs.cancelled, 1, "cancel: job gave up");
+    CHECK_EQ(ListWorker_Finished(&worker, job), false, "cancel: job not finished");
+
+    // a job cancelled before it starts never runs
+    jobs_set_slow(&jobs, false);
+    ListWorker_Stop(&worker);
+    jobs_init(&jobs, false);
+    ListWorker_Start(&worker, run_job, &jobs);
+    ListWorker_Cancel(&worker);
+    ListWorker_Wait(&worker);
+    CHECK_EQ(jobs.started, 0, "cancel: nothing submitted, nothing run");
+    ListWorker_Stop(&worker);
+}
+
+static void test_stop(void)
+{
+    struct Jobs jobs;
+    jobs_init(&jobs, true);
+    struct ListWorker worker;
+    ListWorker_Start(&worker, run_job, &jobs);
+
+    ListWorker_Submit(&worker);
+    jobs_wait_started(&jobs, 1);
+    ListWorker_Stop(&worker);
+    CHECK_EQ(jobs.cancelled, 1, "stop: running job cancelled");
+    CHECK_EQ(worker.running, false, "stop: joined");
+
+    // stopping twice, or a worker that never started, is harmless
+    ListWorker_Stop(&worker);
+    struct ListWorker unstarted = {0};
+    ListWorker_Stop(&unstarted);
+    CHECK_EQ(unstarted.running, false, "stop: unstarted worker");
+}
+
+int main(void)
+{
+    test_run();
+    test_supersede();
+    test_cancel();
+    test_stop();
+
+    if (failures == 0)
+    {
+        printf("ok - all %d checks passed\n", checks);
+        return 0;
+    }
+
+    fprintf(stderr, "not ok - %d/%d checks failed\n", failures, checks);
+    return 1;
+}
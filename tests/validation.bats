@@ -211,6 +211,97 @@ setup() {
     [[ "$output" == *"features.images entry 'default' must be a string"* ]]
 }
 
+# numeric range options
+#
+# "options" may be a {"min","max","step","format"} spec instead of an array.
+# an invalid spec (or an unsafe format string) must fail validation rather than
+# reach the formatter.
+
+@test "range options without max are rejected" {
+    JSONFILE="$(mktemp "${BATS_TEST_TMPDIR:-/tmp}/minui-list-json.XXXXXX")"
+    printf '{"items":[{"name":"Volume","options":{"min":0}}]}' > "$JSONFILE"
+    run "$BIN" --file "$JSONFILE" --format json
+    [ "$status" -eq 1 ]
+    [ "$status" -ne 139 ]
+    [[ "$output" == *"invalid options range: min and max are required numbers"* ]]
+}
+
+@test "range options with a non-integer format are rejected" {
+    JSONFILE="$(mktemp "${BATS_TEST_TMPDIR:-/tmp}/minui-list-json.XXXXXX")"
+    printf '{"items":[{"name":"Volume","options":{"min":0,"max":100,"format":"%%s"}}]}' > "$JSONFILE"
+    run "$BIN" --file "$JSONFILE" --format json
+    [ "$status" -eq 1 ]
+    [ "$status" -ne 139 ]
+    [[ "$output" == *"invalid options range: format must contain exactly one %d"* ]]
+}
+
+# item key paths
+
+@test "malformed --item-key path is rejected" {
+    run "$BIN" --file "$TESTFILE" --item-key 'data..items'
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid item key provided"* ]]
+}
+
+@test "items under a nested --item-key path are validated" {
+    JSONFILE="$(mktemp "${BATS_TEST_TMPDIR:-/tmp}/minui-list-json.XXXXXX")"
+    printf '{"data":{"menus":[{"items":[{"nme":"Apple"}]}]}}' > "$JSONFILE"
+    run "$BIN" --file "$JSONFILE" --item-key 'data.menus[0].items'
+    [ "$status" -eq 1 ]
+    [ "$status" -ne 139 ]
+    [[ "$output" == *"Item 0 under key 'data.menus[0].items' is missing a name"* ]]
+}
+
+# compressed input
+
+@test "corrupt gzip input is rejected" {
+    GZFILE="$(mktemp "${BATS_TEST_TMPDIR:-/tmp}/minui-list-gz.XXXXXX")"
+    printf '\037\213\010\000not really deflate data' > "$GZFILE"
+    run "$BIN" --file "$GZFILE" --format json
+    [ "$status" -eq 1 ]
+    [ "$status" -ne 139 ]
+    [[ "$output" == *"Failed to parse JSON file"* ]]
+}
+
+# json lines
+
+@test "--format jsonl is accepted" {
+    run "$BIN" --file "${BATS_TEST_TMPDIR:-/tmp}/minui-list-missing.jsonl" --format jsonl
+    [ "$status" -eq 1 ]
+    [[ "$output" != *"Invalid format provided"* ]]
+    [[ "$output" == *"Failed to read file or stdin"* ]]
+}
+
+# directory source
+
+@test "--source-dir and --file together are rejected" {
+    run "$BIN" --file "$TESTFILE" --source-dir "${BATS_TEST_TMPDIR:-/tmp}"
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Only one of --file and --source-dir can be provided"* ]]
+}
+
+@test "unreadable --source-dir is rejected" {
+    run "$BIN" --source-dir "${BATS_TEST_TMPDIR:-/tmp}/minui-list-missing-dir" --source-extensions gb,zip
+    [ "$status" -eq 1 ]
+    [[ "$output" != *"No input provided"* ]]
+    [[ "$output" == *"Failed to read source directory"* ]]
+}
+
+# server mode
+
+@test "--serve and --client together are rejected" {
+    run "$BIN" --serve "${BATS_TEST_TMPDIR:-/tmp}/minui-list.sock" --client "${BATS_TEST_TMPDIR:-/tmp}/minui-list.sock"
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Only one of --serve and --client can be provided"* ]]
+}
+
+@test "--serve does not replace a file that is not a socket" {
+    run "$BIN" --serve "$TESTFILE"
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Failed to listen on server socket"* ]]
+    [ -f "$TESTFILE" ]
+}
+
 @test "--screen-resolution is accepted" {
     run "$BIN" --file "$TESTFILE" --format xml --screen-resolution 1280x720
     [ "$status" -eq 1 ]
@@ -219,6 +310,13 @@ setup() {
     [[ "$output" != *"unrecognized option"* ]]
 }
 
+@test "--timings is accepted" {
+    run "$BIN" --file "$TESTFILE" --format xml --timings -
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid format provided"* ]]
+    [[ "$output" != *"unrecognized option"* ]]
+}
+
 @test "invalid --screen-resolution is rejected" {
     run "$BIN" --file "$TESTFILE" --screen-resolution 1280x
     [ "$status" -eq 1 ]
@@ -307,3 +405,54 @@ setup() {
     [[ "$output" == *"Invalid format provided"* ]]
     [[ "$output" != *"unrecognized option"* ]]
 }
+
+@test "--filter-index true is accepted" {
+    run "$BIN" --file "$TESTFILE" --format xml --filter-index true
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid format provided"* ]]
+    [[ "$output" != *"Invalid filter-index"* ]]
+}
+
+@test "invalid --filter-index value is rejected" {
+    run "$BIN" --file "$TESTFILE" --filter-index maybe
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid filter-index value provided"* ]]
+}
+
+@test "--filter-mode fuzzy is accepted" {
+    run "$BIN" --file "$TESTFILE" --format xml --filter-mode fuzzy
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid format provided"* ]]
+    [[ "$output" != *"Invalid filter mode"* ]]
+}
+
+@test "invalid --filter-mode value is rejected" {
+    run "$BIN" --file "$TESTFILE" --filter-mode regex
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid filter mode provided"* ]]
+}
+
+# binary list cache
+
+@test "--cache-dir is accepted" {
+    run "$BIN" --file "$TESTFILE" --format xml --cache-dir "${BATS_TEST_TMPDIR:-/tmp}"
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid format provided"* ]]
+    [[ "$output" != *"unrecognized option"* ]]
+}
+
+# progressive loading
+
+@test "--progressive-load true is accepted" {
+    run "$BIN" --file "$TESTFILE" --format xml --progressive-load true
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid format provided"* ]]
+    [[ "$output" != *"Invalid progressive-load"* ]]
+    [[ "$output" != *"unrecognized option"* ]]
+}
+
+@test "invalid --progressive-load value is rejected" {
+    run "$BIN" --file "$TESTFILE" --progressive-load maybe
+    [ "$status" -eq 1 ]
+    [[ "$output" == *"Invalid progressive-load value provided"* ]]
+}